@@ -0,0 +1,164 @@
+#include "AssetLoader.h"
+
+#ifdef _WIN32
+#include <wincodec.h>
+#include <wrl/client.h>
+#else
+#include "MappedFile.h"
+#include "PngDecoder.h"
+#endif
+
+AssetLoader::AssetLoader(unsigned int threadCount)
+{
+	stopping = false;
+
+	// leave a core for the main thread, which is busy uploading
+	if(threadCount == 0) {
+		threadCount = std::thread::hardware_concurrency();
+		threadCount = threadCount > 1 ? threadCount - 1 : 1;
+	}
+	for(unsigned int i = 0; i < threadCount; i++) {
+		workers.emplace_back(&AssetLoader::WorkerLoop, this);
+	}
+}
+
+// finishes whatever is still queued before returning
+AssetLoader::~AssetLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		stopping = true;
+	}
+	jobAvailable.notify_all();
+	for(std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+std::future<std::shared_ptr<MeshData>> AssetLoader::LoadMesh(const std::string& fileName, bool optimizeVertexCache)
+{
+	// packaged_task can't be copied into a std::function, so it rides in a shared_ptr
+	std::shared_ptr<std::packaged_task<std::shared_ptr<MeshData>()>> task = std::make_shared<std::packaged_task<std::shared_ptr<MeshData>()>>(
+		[fileName, optimizeVertexCache]() { return MeshData::Load(fileName.c_str(), optimizeVertexCache, 1); });
+	std::future<std::shared_ptr<MeshData>> result = task->get_future();
+	Enqueue([task]() { (*task)(); });
+	return result;
+}
+
+std::future<std::shared_ptr<ImageData>> AssetLoader::DecodeImage(const std::wstring& fileName)
+{
+	std::shared_ptr<std::packaged_task<std::shared_ptr<ImageData>()>> task = std::make_shared<std::packaged_task<std::shared_ptr<ImageData>()>>(
+		[fileName]() { return Decode(fileName); });
+	std::future<std::shared_ptr<ImageData>> result = task->get_future();
+	Enqueue([task]() { (*task)(); });
+	return result;
+}
+
+void AssetLoader::Enqueue(std::function<void()> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		jobs.push(job);
+	}
+	jobAvailable.notify_one();
+}
+
+void AssetLoader::WorkerLoop()
+{
+#ifdef _WIN32
+	// WIC is COM, and every thread that uses it needs its own apartment
+	CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+#endif
+
+	while(true) {
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(jobMutex);
+			jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+			if(jobs.empty()) {
+				break;
+			}
+			job = jobs.front();
+			jobs.pop();
+		}
+		job();
+	}
+
+#ifdef _WIN32
+	CoUninitialize();
+#endif
+}
+
+#ifndef _WIN32
+// wchar_t is UTF-32 here, and the file APIs want UTF-8
+static std::string ToUtf8(const std::wstring& text)
+{
+	std::string result;
+	for(wchar_t character : text) {
+		unsigned int c = (unsigned int)character;
+		if(c < 0x80) {
+			result += (char)c;
+		} else if(c < 0x800) {
+			result += (char)(0xC0 | (c >> 6));
+			result += (char)(0x80 | (c & 0x3F));
+		} else if(c < 0x10000) {
+			result += (char)(0xE0 | (c >> 12));
+			result += (char)(0x80 | ((c >> 6) & 0x3F));
+			result += (char)(0x80 | (c & 0x3F));
+		} else {
+			result += (char)(0xF0 | (c >> 18));
+			result += (char)(0x80 | ((c >> 12) & 0x3F));
+			result += (char)(0x80 | ((c >> 6) & 0x3F));
+			result += (char)(0x80 | (c & 0x3F));
+		}
+	}
+	return result;
+}
+#endif
+
+// --------------------------------------------------------
+// Decodes any WIC supported file into 32bpp RGBA, the same
+// format CreateWICTextureFromFile ends up with for the PNGs
+// in this project. Without WIC only PNG is supported, which
+// is all the project ships. A failed decode leaves the image
+// empty.
+// --------------------------------------------------------
+std::shared_ptr<ImageData> AssetLoader::Decode(const std::wstring& fileName)
+{
+	std::shared_ptr<ImageData> image = std::make_shared<ImageData>();
+	image->fileName = fileName;
+	image->width = 0;
+	image->height = 0;
+
+#ifdef _WIN32
+	Microsoft::WRL::ComPtr<IWICImagingFactory> factory;
+	Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
+	Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
+	Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
+	if(FAILED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(factory.GetAddressOf())))
+		|| FAILED(factory->CreateDecoderFromFilename(fileName.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf()))
+		|| FAILED(decoder->GetFrame(0, frame.GetAddressOf()))
+		|| FAILED(factory->CreateFormatConverter(converter.GetAddressOf()))
+		|| FAILED(converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom))) {
+		return image;
+	}
+
+	UINT width;
+	UINT height;
+	converter->GetSize(&width, &height);
+	std::vector<unsigned char> pixels((size_t)width * height * 4);
+	if(FAILED(converter->CopyPixels(nullptr, width * 4, (UINT)pixels.size(), pixels.data()))) {
+		return image;
+	}
+	image->width = width;
+	image->height = height;
+	image->pixels.swap(pixels);
+#else
+	MappedFile file(ToUtf8(fileName).c_str());
+	if(file.IsOpen()) {
+		PngDecoder::Decode((const unsigned char*)file.GetData(), file.GetSize(), image->width, image->height, image->pixels);
+	}
+#endif
+
+	return image;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <functional>
+#include <future>
+#include <vector>
+#include <memory>
+#include <string>
+#include "MeshData.h"
+
+// decoded 8 bit RGBA pixels, rows tightly packed
+struct ImageData
+{
+	std::wstring fileName;
+	unsigned int width;
+	unsigned int height;
+	std::vector<unsigned char> pixels;
+};
+
+// --------------------------------------------------------
+// Worker pool for the CPU half of asset loading. Meshes are
+// parsed and processed, and images decoded, on the workers,
+// one asset per worker (each mesh stays single threaded so
+// the pool doesn't oversubscribe the cores).
+// The futures are then turned into GPU resources on the main
+// thread by Mesh's constructor and TextureUploader, so nothing
+// here touches the device.
+// --------------------------------------------------------
+class AssetLoader
+{
+public:
+	AssetLoader(unsigned int threadCount = 0);
+	~AssetLoader();
+
+	std::future<std::shared_ptr<MeshData>> LoadMesh(const std::string& fileName, bool optimizeVertexCache = true);
+	std::future<std::shared_ptr<ImageData>> DecodeImage(const std::wstring& fileName);
+
+	// synchronous decode, what the workers run. WIC on Windows, PngDecoder elsewhere
+	static std::shared_ptr<ImageData> Decode(const std::wstring& fileName);
+
+private:
+	void Enqueue(std::function<void()> job);
+	void WorkerLoop();
+
+	std::vector<std::thread> workers;
+	std::queue<std::function<void()>> jobs;
+	std::mutex jobMutex;
+	std::condition_variable jobAvailable;
+	bool stopping;
+};
@@ -0,0 +1,96 @@
+#include "BoundingVolumes.h"
+#include <math.h>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// AABB plus Ritter's bounding sphere. The first pass finds
+// the box and the extreme point along each axis, the most
+// distant pair of those seeds the sphere, and the second
+// pass grows it to take in any point left outside. The
+// sphere around the box center is used instead whenever it
+// happens to be tighter (long thin meshes, for example).
+// --------------------------------------------------------
+MeshBounds BoundingVolumes::Compute(const Vertex* vertices, int numVertices)
+{
+	MeshBounds bounds = {};
+	if(numVertices == 0) {
+		return bounds;
+	}
+
+	// min and max point along x, y and z
+	XMFLOAT3 extremes[6];
+	for(int axis = 0; axis < 6; axis++) {
+		extremes[axis] = vertices[0].Position;
+	}
+	bounds.boxMin = vertices[0].Position;
+	bounds.boxMax = vertices[0].Position;
+	for(int i = 1; i < numVertices; i++) {
+		const XMFLOAT3& p = vertices[i].Position;
+		if(p.x < bounds.boxMin.x) { bounds.boxMin.x = p.x; extremes[0] = p; }
+		if(p.x > bounds.boxMax.x) { bounds.boxMax.x = p.x; extremes[1] = p; }
+		if(p.y < bounds.boxMin.y) { bounds.boxMin.y = p.y; extremes[2] = p; }
+		if(p.y > bounds.boxMax.y) { bounds.boxMax.y = p.y; extremes[3] = p; }
+		if(p.z < bounds.boxMin.z) { bounds.boxMin.z = p.z; extremes[4] = p; }
+		if(p.z > bounds.boxMax.z) { bounds.boxMax.z = p.z; extremes[5] = p; }
+	}
+
+	int widest = 0;
+	float widestSquared = -1.0f;
+	for(int axis = 0; axis < 3; axis++) {
+		float spanSquared = DistanceSquared(extremes[axis * 2], extremes[axis * 2 + 1]);
+		if(spanSquared > widestSquared) {
+			widestSquared = spanSquared;
+			widest = axis;
+		}
+	}
+	const XMFLOAT3& a = extremes[widest * 2];
+	const XMFLOAT3& b = extremes[widest * 2 + 1];
+	XMFLOAT3 center((a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f, (a.z + b.z) * 0.5f);
+	float radius = sqrtf(widestSquared) * 0.5f;
+
+	XMFLOAT3 boxCenter(
+		(bounds.boxMin.x + bounds.boxMax.x) * 0.5f,
+		(bounds.boxMin.y + bounds.boxMax.y) * 0.5f,
+		(bounds.boxMin.z + bounds.boxMax.z) * 0.5f);
+	float boxRadiusSquared = 0.0f;
+
+	for(int i = 0; i < numVertices; i++) {
+		const XMFLOAT3& p = vertices[i].Position;
+		float distanceSquared = DistanceSquared(p, center);
+		if(distanceSquared > radius * radius) {
+			// move the center toward the point just far enough to reach it
+			float distance = sqrtf(distanceSquared);
+			float newRadius = (radius + distance) * 0.5f;
+			float shift = (newRadius - radius) / distance;
+			center.x += (p.x - center.x) * shift;
+			center.y += (p.y - center.y) * shift;
+			center.z += (p.z - center.z) * shift;
+			radius = newRadius;
+		}
+
+		float boxDistanceSquared = DistanceSquared(p, boxCenter);
+		if(boxDistanceSquared > boxRadiusSquared) {
+			boxRadiusSquared = boxDistanceSquared;
+		}
+	}
+
+	float boxRadius = sqrtf(boxRadiusSquared);
+	if(boxRadius < radius) {
+		center = boxCenter;
+		radius = boxRadius;
+	}
+
+	// float error in the growth step can leave a point a hair outside
+	bounds.sphereCenter = center;
+	bounds.sphereRadius = radius * 1.0001f;
+	return bounds;
+}
+
+float BoundingVolumes::DistanceSquared(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	float x = a.x - b.x;
+	float y = a.y - b.y;
+	float z = a.z - b.z;
+	return x * x + y * y + z * z;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <DirectXMath.h>
+#include "Vertex.h"
+
+// local space bounds of a mesh, also stored as-is in the mesh cache
+struct MeshBounds
+{
+	DirectX::XMFLOAT3 boxMin;
+	DirectX::XMFLOAT3 boxMax;
+	DirectX::XMFLOAT3 sphereCenter;
+	float sphereRadius;
+};
+
+class BoundingVolumes
+{
+public:
+	static MeshBounds Compute(const Vertex* vertices, int numVertices);
+
+private:
+	static float DistanceSquared(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b);
+};
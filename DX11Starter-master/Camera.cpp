@@ -9,6 +9,9 @@ Camera::Camera(float aspectRatio, DirectX::XMFLOAT3 position)
 
 	transform.SetPitchYawRoll(0.6f, 0.0f, 0.0f);
 
+	nearClip = 0.1f;
+	farClip = 1000.0f;
+	XMStoreFloat4x4(&projection, XMMatrixIdentity());
 	UpdateViewMatrix();
 	UpdateProjectionMatrix(aspectRatio);
 }
@@ -18,6 +21,7 @@ void Camera::UpdateViewMatrix()
 	XMFLOAT3 position = transform.GetPosition();
 	XMFLOAT3 forward = transform.GetForward();
 	XMStoreFloat4x4(&view, XMMatrixLookToLH(XMLoadFloat3(&position), XMLoadFloat3(&forward), XMVectorSet(0, 1, 0, 0)));
+	UpdateViewProjection();
 }
 
 void Camera::Update(DirectX::XMFLOAT3 playerPosition) {
@@ -27,7 +31,13 @@ void Camera::Update(DirectX::XMFLOAT3 playerPosition) {
 
 void Camera::UpdateProjectionMatrix(float aspectRatio)
 {
-	XMStoreFloat4x4(&projection, XMMatrixPerspectiveFovLH(XM_PIDIV2, aspectRatio, 0.1f, 1000.0f));
+	XMStoreFloat4x4(&projection, XMMatrixPerspectiveFovLH(XM_PIDIV2, aspectRatio, nearClip, farClip));
+	UpdateViewProjection();
+}
+
+void Camera::UpdateViewProjection()
+{
+	XMStoreFloat4x4(&viewProjection, XMMatrixMultiply(XMLoadFloat4x4(&view), XMLoadFloat4x4(&projection)));
 }
 
 DirectX::XMFLOAT4X4 Camera::GetView()
@@ -35,11 +45,21 @@ DirectX::XMFLOAT4X4 Camera::GetView()
 	return view;
 }
 
+float Camera::GetFarClip()
+{
+	return farClip;
+}
+
 DirectX::XMFLOAT4X4 Camera::GetProjection()
 {
 	return projection;
 }
 
+DirectX::XMFLOAT4X4 Camera::GetViewProjection()
+{
+	return viewProjection;
+}
+
 DirectX::XMFLOAT3 Camera::GetPosition()
 {
 	return transform.GetPosition();
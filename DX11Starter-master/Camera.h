@@ -12,11 +12,18 @@ public:
 
 	DirectX::XMFLOAT4X4 GetView();
 	DirectX::XMFLOAT4X4 GetProjection();
+	DirectX::XMFLOAT4X4 GetViewProjection(); // view * projection, redone whenever either changes
 	DirectX::XMFLOAT3 GetPosition();
 	Transform* GetTransform();
+	float GetFarClip();
 
 private:
 	Transform transform;
+	float nearClip;
+	float farClip;
 	DirectX::XMFLOAT4X4 view;
 	DirectX::XMFLOAT4X4 projection;
+	DirectX::XMFLOAT4X4 viewProjection;
+
+	void UpdateViewProjection();
 };
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+#include <memory>
+#include <DirectXCollision.h>
+#include "Vector3.h"
+
+// only held by pointer here, so the World builds without the device headers
+class Mesh;
+class Material;
+
+// a mesh's local bounds, defined with Mesh for the same reason
+DirectX::BoundingBox GetMeshBoundingBox(Mesh& mesh);
+DirectX::BoundingSphere GetMeshBoundingSphere(Mesh& mesh);
+
+// names an entity in a World. The generation tells a reused index apart
+// from the entity that had it before
+struct EntityId
+{
+	unsigned int index;
+	unsigned int generation;
+};
+
+// never handed out, so it's never alive
+const EntityId NoEntity = { 0xFFFFFFFF, 0 };
+
+// which components an entity has, one bit each. Entities with the
+// same mask share an archetype
+typedef unsigned int ComponentMask;
+
+enum ComponentBit
+{
+	HasTransform = 1 << 0,
+	HasRender = 1 << 1,
+	HasBall = 1 << 2,
+	HasPlayer = 1 << 3,
+	HasEnemy = 1 << 4
+};
+
+struct RenderComponent
+{
+	std::shared_ptr<Mesh> mesh;
+	std::shared_ptr<Material> material;
+	bool visible = true;
+};
+
+struct BallComponent
+{
+	Vector3 velocity;
+	bool playerHit = false; // who hit it last? player or opponent
+	bool hasBounced = false; // if the ball has bounced once yet, meaning the next bounce ends the point
+	bool active = false; // if the ball is in play
+};
+
+struct PlayerComponent
+{
+	Vector3 velocity;
+	bool facingRight = true; // which side the racket is on
+	float swingCooldown = 0.0f;
+	EntityId racketHead = NoEntity;
+	EntityId racketHandle = NoEntity;
+};
+
+// the opponent just chases the ball
+struct EnemyComponent
+{
+	float speed = 8.0f;
+};
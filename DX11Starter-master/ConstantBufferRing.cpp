@@ -0,0 +1,88 @@
+#include "ConstantBufferRing.h"
+#include <string.h>
+
+ConstantBufferRing::ConstantBufferRing(std::shared_ptr<IConstantBufferDevice> device, unsigned int size)
+	: allocator(size)
+{
+	this->device = device;
+	supported = device && device->CreateBuffer((unsigned int)allocator.GetCapacity());
+	frame = 1;
+	completedFrame = 0;
+	boundCount = 0;
+	fallbackCount = 0;
+	wrapCount = 0;
+}
+
+bool ConstantBufferRing::IsSupported() {
+	return supported;
+}
+
+void ConstantBufferRing::BeginFrame() {
+	if(!supported) {
+		return;
+	}
+
+	// this frame's fence slot is still in use if the GPU is MaxFramesInFlight behind
+	RetireFrames(frame > MaxFramesInFlight ? frame - MaxFramesInFlight : 0);
+}
+
+void ConstantBufferRing::EndFrame() {
+	if(!supported) {
+		return;
+	}
+
+	device->SignalFence(frame);
+	allocator.EndFrame(frame);
+	frame++;
+}
+
+// polls the fences of frames still in flight, blocking only until mustComplete is done
+void ConstantBufferRing::RetireFrames(uint64_t mustComplete) {
+	while(completedFrame + 1 < frame) {
+		if(!device->IsFenceComplete(completedFrame + 1, completedFrame + 1 <= mustComplete)) {
+			break;
+		}
+		completedFrame++;
+	}
+	allocator.Retire(completedFrame);
+}
+
+bool ConstantBufferRing::BindVS(unsigned int slot, const void* data, unsigned int size) {
+	size_t offset;
+	bool wrapped;
+	if(!supported || !allocator.Allocate(size, offset, wrapped)) {
+		fallbackCount++;
+		return false;
+	}
+
+	// starting over at the front renames the buffer, everything else appends behind
+	// ranges the GPU may still be reading
+	unsigned char* mapped = device->Map(wrapped);
+	if(!mapped) {
+		fallbackCount++;
+		return false;
+	}
+	memcpy(mapped + offset, data, size);
+	device->Unmap();
+
+	// offsets and sizes are in 16 byte constants, both multiples of 16 constants
+	device->BindVS(slot, (unsigned int)(offset / 16), (size + 255) / 256 * 16);
+
+	if(wrapped) {
+		wrapCount++;
+	}
+	boundCount++;
+	return true;
+}
+
+unsigned long long ConstantBufferRing::GetBoundCount() {
+	return boundCount;
+}
+
+unsigned long long ConstantBufferRing::GetFallbackCount() {
+	return fallbackCount;
+}
+
+unsigned long long ConstantBufferRing::GetWrapCount() {
+	return wrapCount;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <stdint.h>
+#include <memory>
+#include "RingAllocator.h"
+
+// --------------------------------------------------------
+// The device side of a ConstantBufferRing: one buffer, the
+// binds and a fence per frame. D3D11ConstantBufferDevice is
+// the real one, tests use a stub.
+// --------------------------------------------------------
+class IConstantBufferDevice
+{
+public:
+	virtual ~IConstantBufferDevice() {}
+
+	// false when the device can't bind constant buffers by offset
+	virtual bool CreateBuffer(unsigned int size) = 0;
+
+	// the whole buffer. discard starts it over, otherwise ranges the
+	// GPU may still be reading are left as they are
+	virtual unsigned char* Map(bool discard) = 0;
+	virtual void Unmap() = 0;
+
+	// offset and size are in 16 byte constants
+	virtual void BindVS(unsigned int slot, unsigned int firstConstant, unsigned int numConstants) = 0;
+
+	// fences are frame numbers. wait blocks until the GPU is past it,
+	// so it only comes back false when the query itself fails
+	virtual void SignalFence(uint64_t frame) = 0;
+	virtual bool IsFenceComplete(uint64_t frame, bool wait) = 0;
+};
+
+// --------------------------------------------------------
+// One large dynamic constant buffer that per-draw constants
+// are written into back to back, then bound by offset. Needs
+// D3D 11.1 offsetting and NO_OVERWRITE maps on constant
+// buffers; when those are missing, or the ring is full,
+// BindVS returns false and the caller uploads the usual way.
+// --------------------------------------------------------
+class ConstantBufferRing
+{
+public:
+	static const unsigned int DefaultSize = 1024 * 1024;
+
+	// frames the GPU can be behind before BeginFrame waits
+	static const unsigned int MaxFramesInFlight = 4;
+
+	// a null device is never supported
+	ConstantBufferRing(std::shared_ptr<IConstantBufferDevice> device, unsigned int size = DefaultSize);
+
+	bool IsSupported();
+
+	// bracket every frame's Bind calls
+	void BeginFrame();
+	void EndFrame();
+
+	// copies size bytes into the ring and binds them to a vertex shader slot
+	bool BindVS(unsigned int slot, const void* data, unsigned int size);
+
+	unsigned long long GetBoundCount();
+	unsigned long long GetFallbackCount();
+	unsigned long long GetWrapCount();
+
+private:
+	std::shared_ptr<IConstantBufferDevice> device;
+	RingAllocator allocator;
+	bool supported;
+
+	uint64_t frame;
+	uint64_t completedFrame;
+
+	unsigned long long boundCount;
+	unsigned long long fallbackCount;
+	unsigned long long wrapCount;
+
+	void RetireFrames(uint64_t mustComplete);
+};
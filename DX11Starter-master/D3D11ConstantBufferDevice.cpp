@@ -0,0 +1,74 @@
+#include "D3D11ConstantBufferDevice.h"
+
+D3D11ConstantBufferDevice::D3D11ConstantBufferDevice(Microsoft::WRL::ComPtr<ID3D11Device> device, Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, StateCache* stateCache) {
+	this->device = device;
+	this->context = context;
+	this->stateCache = stateCache;
+}
+
+bool D3D11ConstantBufferDevice::CreateBuffer(unsigned int size) {
+	D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+	if(FAILED(device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))) ||
+		!options.ConstantBufferOffsetting || !options.MapNoOverwriteOnDynamicConstantBuffer ||
+		FAILED(context.As(&context1))) {
+		return false;
+	}
+
+	// 11.1 allows constant buffers past 4096 constants as long as each bound range isn't
+	D3D11_BUFFER_DESC desc = {};
+	desc.ByteWidth = size;
+	desc.Usage = D3D11_USAGE_DYNAMIC;
+	desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	if(FAILED(device->CreateBuffer(&desc, 0, buffer.GetAddressOf()))) {
+		return false;
+	}
+
+	D3D11_QUERY_DESC queryDesc = {};
+	queryDesc.Query = D3D11_QUERY_EVENT;
+	for(unsigned int i = 0; i < ConstantBufferRing::MaxFramesInFlight; i++) {
+		if(FAILED(device->CreateQuery(&queryDesc, fences[i].GetAddressOf()))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+unsigned char* D3D11ConstantBufferDevice::Map(bool discard) {
+	D3D11_MAPPED_SUBRESOURCE mapped = {};
+	if(FAILED(context->Map(buffer.Get(), 0, discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mapped))) {
+		return nullptr;
+	}
+	return (unsigned char*)mapped.pData;
+}
+
+void D3D11ConstantBufferDevice::Unmap() {
+	context->Unmap(buffer.Get(), 0);
+}
+
+void D3D11ConstantBufferDevice::BindVS(unsigned int slot, unsigned int firstConstant, unsigned int numConstants) {
+	if(stateCache) {
+		stateCache->SetVSConstantBuffer(slot, buffer.Get(), firstConstant, numConstants);
+	}
+	else {
+		context1->VSSetConstantBuffers1(slot, 1, buffer.GetAddressOf(), &firstConstant, &numConstants);
+	}
+}
+
+// the ring never has more than MaxFramesInFlight frames unretired, so the slots don't collide
+void D3D11ConstantBufferDevice::SignalFence(uint64_t frame) {
+	context->End(fences[frame % ConstantBufferRing::MaxFramesInFlight].Get());
+}
+
+bool D3D11ConstantBufferDevice::IsFenceComplete(uint64_t frame, bool wait) {
+	ID3D11Query* fence = fences[frame % ConstantBufferRing::MaxFramesInFlight].Get();
+	while(true) {
+		HRESULT hr = context->GetData(fence, 0, 0, wait ? 0 : D3D11_ASYNC_GETDATA_DONOTFLUSH);
+		if(hr == S_OK) {
+			return true;
+		}
+		if(!wait || FAILED(hr)) {
+			return false;
+		}
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <d3d11.h>
+#include <d3d11_1.h>
+#include <wrl/client.h>
+#include "ConstantBufferRing.h"
+#include "StateCache.h"
+
+// --------------------------------------------------------
+// ConstantBufferRing's buffer, binds and fences on a D3D 11.1
+// device. Fences are event queries, one per frame in flight.
+// --------------------------------------------------------
+class D3D11ConstantBufferDevice : public IConstantBufferDevice
+{
+public:
+	// binds go through stateCache when there is one
+	D3D11ConstantBufferDevice(Microsoft::WRL::ComPtr<ID3D11Device> device, Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, StateCache* stateCache = nullptr);
+
+	bool CreateBuffer(unsigned int size);
+	unsigned char* Map(bool discard);
+	void Unmap();
+	void BindVS(unsigned int slot, unsigned int firstConstant, unsigned int numConstants);
+	void SignalFence(uint64_t frame);
+	bool IsFenceComplete(uint64_t frame, bool wait);
+
+private:
+	Microsoft::WRL::ComPtr<ID3D11Device> device;
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext> context;
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext1> context1;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> buffer;
+	Microsoft::WRL::ComPtr<ID3D11Query> fences[ConstantBufferRing::MaxFramesInFlight];
+	StateCache* stateCache;
+};
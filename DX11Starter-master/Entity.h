@@ -1,24 +0,0 @@
-#pragma once
-#include "Transform.h"
-#include "Mesh.h"
-#include <memory>
-#include "Camera.h"
-#include "Material.h"
-
-class Entity
-{
-public:
-	Entity(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material);
-
-	void Draw(Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, std::shared_ptr<Camera> camera);
-
-	Transform* GetTransform();
-	std::shared_ptr<Mesh> GetMesh();
-	std::shared_ptr<Material> GetMaterial();
-
-protected:
-	Transform transform;
-	std::shared_ptr<Mesh> mesh;
-	std::shared_ptr<Material> material;
-};
-
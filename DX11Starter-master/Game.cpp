@@ -1,8 +1,13 @@
 #include "Game.h"
 #include "Vertex.h"
+#include "VertexQuantizer.h"
+#include "AssetLoader.h"
+#include "TextureUploader.h"
+#include "D3D11ConstantBufferDevice.h"
 #include "Input.h"
 #include <memory>
-#include <WICTextureLoader.h>
+#include <chrono>
+#include <stdio.h>
 #include <DDSTextureLoader.h>
 
 // Needed for a helper function to read compiled shader files from the hard drive
@@ -29,6 +34,9 @@ Game::Game(HINSTANCE hInstance)
 		true),			   // Show extra stats (fps) in title bar?
 	vsync(false)
 {
+	launchTime = std::chrono::high_resolution_clock::now();
+	firstFrameReported = false;
+
 #if defined(DEBUG) || defined(_DEBUG)
 	// Do we want a console window?  Probably only in debug mode
 	//CreateConsoleWindow(500, 120, 32, 120);
@@ -40,15 +48,49 @@ Game::Game(HINSTANCE hInstance)
 
 Game::~Game()
 {
-	for(Entity* entity : court) {
-		delete entity;
+	// the run's stats are only printed when the project defines REPORT_STATS,
+	// which also turns on the load time reports here and in Mesh
+#ifdef REPORT_STATS
+	// how many constant buffer copies dirty tracking saved over the whole run
+	SimpleShaderUploadStats uploads;
+	std::shared_ptr<ISimpleShader> shaders[] = { vertexShader, pixelShader, customPixelShader, skyVertexShader, skyPixelShader, quantizedVertexShader, instancedVertexShader };
+	for(std::shared_ptr<ISimpleShader>& shader : shaders) {
+		if(!shader) {
+			continue;
+		}
+		const SimpleShaderUploadStats& stats = shader->GetUploadStats();
+		uploads.UploadsIssued += stats.UploadsIssued;
+		uploads.UploadsSkipped += stats.UploadsSkipped;
+		uploads.BytesUploaded += stats.BytesUploaded;
+		uploads.BytesDirty += stats.BytesDirty;
 	}
-	delete player->racketHead;
-	delete player->racketHandle;
-	delete player;
-	delete ball;
+	char report[256];
+	sprintf_s(report, "Constant buffer uploads: %llu issued, %llu skipped, %llu bytes sent for %llu bytes changed\n",
+		uploads.UploadsIssued, uploads.UploadsSkipped, uploads.BytesUploaded, uploads.BytesDirty);
+	OutputDebugStringA(report);
+
+	if(constantRing) {
+		sprintf_s(report, "Constant ring: %llu draws bound by offset, %llu fell back, %llu wraps%s\n",
+			constantRing->GetBoundCount(), constantRing->GetFallbackCount(), constantRing->GetWrapCount(),
+			constantRing->IsSupported() ? "" : " (offsets not supported)");
+		OutputDebugStringA(report);
+	}
+
+	sprintf_s(report, "Last frame: %zu entities in %u draw calls\n", renderQueue.GetItems().size(), renderQueue.GetDrawCallCount());
+	OutputDebugStringA(report);
+
+	if(stateCache && stateCache->GetFrameCount() > 0) {
+		StateCacheStats total = stateCache->GetTotalStats();
+		StateCacheStats frame = stateCache->GetFrameStats();
+		sprintf_s(report, "State binds: %llu issued, %llu filtered last frame (%.1f / %.1f per frame over %llu frames)\n",
+			frame.bindsIssued, frame.bindsFiltered,
+			(double)total.bindsIssued / stateCache->GetFrameCount(), (double)total.bindsFiltered / stateCache->GetFrameCount(),
+			stateCache->GetFrameCount());
+		OutputDebugStringA(report);
+	}
+#endif
+
 	delete sky;
-	delete enemy;
 }
 
 // --------------------------------------------------------
@@ -62,13 +104,16 @@ void Game::Init()
 	// Helper methods for loading shaders, creating some basic
 	// geometry to draw and some simple camera matrices.
 	//  - You'll be expanding and/or replacing these later
+	stateCache = std::make_shared<StateCache>(context);
 	LoadShaders();
 	CreateBasicGeometry();
+	constantRing = std::make_shared<ConstantBufferRing>(std::make_shared<D3D11ConstantBufferDevice>(device, context, stateCache.get()));
+	instanceBuffer = std::make_shared<InstanceBuffer>(device, context);
 	
 	// Tell the input assembler stage of the pipeline what kind of
 	// geometric primitives (points, lines or triangles) we want to draw.  
 	// Essentially: "What kind of shape should the GPU draw with our data?"
-	context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	stateCache->SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 	worldCam = std::make_shared<Camera>((float)this->width / this->height, XMFLOAT3(0, 15, -18));
 	worldCam->GetTransform()->SetPitchYawRoll(0.6f, 0.0f, 0.0f); //0.6f
@@ -102,7 +147,25 @@ void Game::LoadShaders()
 	pixelShader = std::make_shared<SimplePixelShader>(device, context, GetFullPathTo_Wide(L"PixelShader.cso").c_str());
 	skyVertexShader = std::make_shared<SimpleVertexShader>(device, context, GetFullPathTo_Wide(L"SkyVertexShader.cso").c_str());
 	skyPixelShader = std::make_shared<SimplePixelShader>(device, context, GetFullPathTo_Wide(L"SkyPixelShader.cso").c_str());
+	instancedVertexShader = std::make_shared<SimpleVertexShader>(device, context, GetFullPathTo_Wide(L"InstancedVertexShader.cso").c_str());
 	customPixelShader = std::make_shared<SimplePixelShader>(device, context, GetFullPathTo_Wide(L"CustomPS.cso").c_str());
+
+	// reflection would read the packed inputs as 32 bit floats, so this one gets an explicit layout
+	Microsoft::WRL::ComPtr<ID3DBlob> quantizedBlob;
+	Microsoft::WRL::ComPtr<ID3D11InputLayout> quantizedLayout;
+	D3DReadFileToBlob(GetFullPathTo_Wide(L"QuantizedVertexShader.cso").c_str(), quantizedBlob.GetAddressOf());
+	device->CreateInputLayout(
+		VertexQuantizer::InputElements,
+		ARRAYSIZE(VertexQuantizer::InputElements),
+		quantizedBlob->GetBufferPointer(),
+		quantizedBlob->GetBufferSize(),
+		quantizedLayout.GetAddressOf());
+	quantizedVertexShader = std::make_shared<SimpleVertexShader>(device, context, GetFullPathTo_Wide(L"QuantizedVertexShader.cso").c_str(), quantizedLayout, false);
+
+	std::shared_ptr<ISimpleShader> shaders[] = { vertexShader, pixelShader, skyVertexShader, skyPixelShader, customPixelShader, quantizedVertexShader, instancedVertexShader };
+	for(std::shared_ptr<ISimpleShader>& shader : shaders) {
+		shader->SetStateCache(stateCache.get());
+	}
 }
 
 
@@ -110,98 +173,106 @@ void Game::CreateBasicGeometry()
 {
 	XMFLOAT4 white = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
 
+	// Kick off every CPU side load first: meshes are parsed and processed
+	// and images decoded on the loader's workers, while the main thread
+	// only waits on each future in turn and does the GPU upload
+#ifdef REPORT_STATS
+	std::chrono::high_resolution_clock::time_point loadStart = std::chrono::high_resolution_clock::now();
+#endif
+	AssetLoader loader;
+
+	std::future<std::shared_ptr<MeshData>> sphereData = loader.LoadMesh(GetFullPathTo("../../Assets/Models/sphere.obj"));
+	std::future<std::shared_ptr<MeshData>> cubeData = loader.LoadMesh(GetFullPathTo("../../Assets/Models/cube.obj"));
+	std::future<std::shared_ptr<MeshData>> cylinderData = loader.LoadMesh(GetFullPathTo("../../Assets/Models/cylinder.obj"));
+
+	std::future<std::shared_ptr<ImageData>> bronzeImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/bronze_albedo.png"));
+	std::future<std::shared_ptr<ImageData>> bronzeNormalImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/bronze_normals.png"));
+	std::future<std::shared_ptr<ImageData>> bronzeRoughnessImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/bronze_roughness.png"));
+	std::future<std::shared_ptr<ImageData>> bronzeMetalImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/bronze_metal.png"));
+
+	std::future<std::shared_ptr<ImageData>> cobblestoneImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/cobblestone_albedo.png"));
+	std::future<std::shared_ptr<ImageData>> cobblestoneNormalImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/cobblestone_normals.png"));
+	std::future<std::shared_ptr<ImageData>> cobblestoneRoughnessImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/cobblestone_roughness.png"));
+	std::future<std::shared_ptr<ImageData>> cobblestoneMetalImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/cobblestone_metal.png"));
+
+	std::future<std::shared_ptr<ImageData>> woodImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/wood_albedo.png"));
+	std::future<std::shared_ptr<ImageData>> woodNormalImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/wood_normals.png"));
+	std::future<std::shared_ptr<ImageData>> woodRoughnessImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/wood_roughness.png"));
+	std::future<std::shared_ptr<ImageData>> woodMetalImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/wood_metal.png"));
+
+	std::future<std::shared_ptr<ImageData>> paintImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/paint_albedo.png"));
+	std::future<std::shared_ptr<ImageData>> paintNormalImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/paint_normals.png"));
+	std::future<std::shared_ptr<ImageData>> paintRoughnessImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/paint_roughness.png"));
+	std::future<std::shared_ptr<ImageData>> paintMetalImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/paint_metal.png"));
+
+	std::future<std::shared_ptr<ImageData>> asteroidImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/asteroid.png"));
+	std::future<std::shared_ptr<ImageData>> asteroidNormalImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/PBR/asteroid_normals.png"));
+
+	std::future<std::shared_ptr<ImageData>> whiteTextureImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/pixel.png"));
+	std::future<std::shared_ptr<ImageData>> standardNormalImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/normal.png"));
+	std::future<std::shared_ptr<ImageData>> blackTextureImage = loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/blackTexture.png"));
+
+	std::future<std::shared_ptr<ImageData>> skyFaces[6] = {
+		loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/Skies/Left_Tex.png")),
+		loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/Skies/Right_Tex.png")),
+		loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/Skies/Up_Tex.png")),
+		loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/Skies/Down_Tex.png")),
+		loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/Skies/Front_Tex.png")),
+		loader.DecodeImage(GetFullPathTo_Wide(L"../../Assets/Textures/Skies/Back_Tex.png"))
+	};
+
 	// Load Models
-	sphere = std::make_shared<Mesh>(GetFullPathTo("../../Assets/Models/sphere.obj").c_str(), device, context);
-	cube = std::make_shared<Mesh>(GetFullPathTo("../../Assets/Models/cube.obj").c_str(), device, context);
-	cylinder = std::make_shared<Mesh>(GetFullPathTo("../../Assets/Models/cylinder.obj").c_str(), device, context);
+	sphere = std::make_shared<Mesh>(sphereData.get(), device, context);
+	cube = std::make_shared<Mesh>(cubeData.get(), device, context);
+	cylinder = std::make_shared<Mesh>(cylinderData.get(), device, context, VertexFormatQuantized);
 
 	// load textures
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> bronze;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> bronzeNormal;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> bronzeRoughness;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> bronzeMetal;
-
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> cobblestone;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> cobblestoneNormal;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> cobblestoneRoughness;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> cobblestoneMetal;
-
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> wood;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> woodNormal;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> woodRoughness;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> woodMetal;
-
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> paint;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> paintNormal;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> paintRoughness;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> paintMetal;
-
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> asteroid;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> asteroidNormal;
-
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> whiteTexture;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> blackTexture;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> standardNormal;
-
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> skyBox;
-
-	CreateWICTextureFromFile(device.Get(), context.Get(), 
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/bronze_albedo.png").c_str(), nullptr, bronze.GetAddressOf());
-	CreateWICTextureFromFile(device.Get(), context.Get(), 
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/bronze_normals.png").c_str(), nullptr, bronzeNormal.GetAddressOf());
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/bronze_roughness.png").c_str(), nullptr, bronzeRoughness.GetAddressOf());
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/bronze_metal.png").c_str(), nullptr, bronzeMetal.GetAddressOf());
-
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/cobblestone_albedo.png").c_str(), nullptr, cobblestone.GetAddressOf());
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/cobblestone_normals.png").c_str(), nullptr, cobblestoneNormal.GetAddressOf());
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/cobblestone_roughness.png").c_str(), nullptr, cobblestoneRoughness.GetAddressOf());
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/cobblestone_metal.png").c_str(), nullptr, cobblestoneMetal.GetAddressOf());
-
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/wood_albedo.png").c_str(), nullptr, wood.GetAddressOf());
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/wood_normals.png").c_str(), nullptr, woodNormal.GetAddressOf());
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/wood_roughness.png").c_str(), nullptr, woodRoughness.GetAddressOf());
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/wood_metal.png").c_str(), nullptr, woodMetal.GetAddressOf());
-
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/paint_albedo.png").c_str(), nullptr, paint.GetAddressOf());
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/paint_normals.png").c_str(), nullptr, paintNormal.GetAddressOf());
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/paint_roughness.png").c_str(), nullptr, paintRoughness.GetAddressOf());
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/paint_metal.png").c_str(), nullptr, paintMetal.GetAddressOf());
-
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/asteroid.png").c_str(), nullptr, asteroid.GetAddressOf());
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/PBR/asteroid_normals.png").c_str(), nullptr, asteroidNormal.GetAddressOf());
-
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/pixel.png").c_str(), nullptr, whiteTexture.GetAddressOf());
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/normal.png").c_str(), nullptr, standardNormal.GetAddressOf());
-	CreateWICTextureFromFile(device.Get(), context.Get(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/blackTexture.png").c_str(), nullptr, blackTexture.GetAddressOf());
-
-	skyBox = CreateCubemap(
-		GetFullPathTo_Wide(L"../../Assets/Textures/Skies/Left_Tex.png").c_str(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/Skies/Right_Tex.png").c_str(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/Skies/Up_Tex.png").c_str(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/Skies/Down_Tex.png").c_str(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/Skies/Front_Tex.png").c_str(),
-		GetFullPathTo_Wide(L"../../Assets/Textures/Skies/Back_Tex.png").c_str()
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> bronze = TextureUploader::CreateTexture(device, context, *bronzeImage.get());
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> bronzeNormal = TextureUploader::CreateTexture(device, context, *bronzeNormalImage.get());
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> bronzeRoughness = TextureUploader::CreateTexture(device, context, *bronzeRoughnessImage.get());
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> bronzeMetal = TextureUploader::CreateTexture(device, context, *bronzeMetalImage.get());
+
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> cobblestone = TextureUploader::CreateTexture(device, context, *cobblestoneImage.get());
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> cobblestoneNormal = TextureUploader::CreateTexture(device, context, *cobblestoneNormalImage.get());
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> cobblestoneRoughness = TextureUploader::CreateTexture(device, context, *cobblestoneRoughnessImage.get());
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> cobblestoneMetal = TextureUploader::CreateTexture(device, context, *cobblestoneMetalImage.get());
+
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> wood = TextureUploader::CreateTexture(device, context, *woodImage.get());
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> woodNormal = TextureUploader::CreateTexture(device, context, *woodNormalImage.get());
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> woodRoughness = TextureUploader::CreateTexture(device, context, *woodRoughnessImage.get());
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> woodMetal = TextureUploader::CreateTexture(device, context, *woodMetalImage.get());
+
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> paint = TextureUploader::CreateTexture(device, context, *paintImage.get());
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> paintNormal = TextureUploader::CreateTexture(device, context, *paintNormalImage.get());
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> paintRoughness = TextureUploader::CreateTexture(device, context, *paintRoughnessImage.get());
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> paintMetal = TextureUploader::CreateTexture(device, context, *paintMetalImage.get());
+
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> asteroid = TextureUploader::CreateTexture(device, context, *asteroidImage.get());
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> asteroidNormal = TextureUploader::CreateTexture(device, context, *asteroidNormalImage.get());
+
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> whiteTexture = TextureUploader::CreateTexture(device, context, *whiteTextureImage.get());
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> standardNormal = TextureUploader::CreateTexture(device, context, *standardNormalImage.get());
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> blackTexture = TextureUploader::CreateTexture(device, context, *blackTextureImage.get());
+
+	std::shared_ptr<ImageData> skyImages[6];
+	for(int i = 0; i < 6; i++) {
+		skyImages[i] = skyFaces[i].get();
+	}
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> skyBox = CreateCubemap(
+		*skyImages[0],
+		*skyImages[1],
+		*skyImages[2],
+		*skyImages[3],
+		*skyImages[4],
+		*skyImages[5]
 	);
 
+#ifdef REPORT_STATS
+	char report[128];
+	sprintf_s(report, "Assets loaded in %.3f ms\n", std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - loadStart).count());
+	OutputDebugStringA(report);
+#endif
+
 	// create sampler
 	D3D11_SAMPLER_DESC samplerDescription = {};
 	samplerDescription.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
@@ -217,12 +288,19 @@ void Game::CreateBasicGeometry()
 	this->lightGreen = std::make_shared<Material>(XMFLOAT4(0.55f, 1.0f, 0.0f, 1.0f), vertexShader, pixelShader, 0.5f);
 	this->asteroid = std::make_shared<Material>(white, vertexShader, pixelShader, 0.5f);
 	this->wood = std::make_shared<Material>(white, vertexShader, pixelShader, 0.5f);
+	this->quantizedWood = std::make_shared<Material>(white, quantizedVertexShader, pixelShader, 0.5f);
 	this->paint = std::make_shared<Material>(white, vertexShader, pixelShader, 0.5f);
 
+	// repeated meshes with these get drawn in one instanced call
+	for(std::shared_ptr<Material> material : { pureWhite, lightGreen, asteroid, wood, paint }) {
+		material->SetInstancedVertexShader(instancedVertexShader);
+	}
+
 	this->pureWhite.get()->AddSampler("DefaultSampler", samplerState.Get());
 	this->lightGreen.get()->AddSampler("DefaultSampler", samplerState.Get());
 	this->asteroid.get()->AddSampler("DefaultSampler", samplerState.Get());
 	this->wood.get()->AddSampler("DefaultSampler", samplerState.Get());
+	this->quantizedWood.get()->AddSampler("DefaultSampler", samplerState.Get());
 	this->paint.get()->AddSampler("DefaultSampler", samplerState.Get());
 
 	this->pureWhite.get()->AddTextureSRV("Albedo", whiteTexture.Get());
@@ -245,6 +323,11 @@ void Game::CreateBasicGeometry()
 	this->wood.get()->AddTextureSRV("RoughnessMap", woodRoughness.Get());
 	this->wood.get()->AddTextureSRV("MetalMap", woodMetal.Get());
 
+	this->quantizedWood.get()->AddTextureSRV("Albedo", wood.Get());
+	this->quantizedWood.get()->AddTextureSRV("NormalMap", woodNormal.Get());
+	this->quantizedWood.get()->AddTextureSRV("RoughnessMap", woodRoughness.Get());
+	this->quantizedWood.get()->AddTextureSRV("MetalMap", woodMetal.Get());
+
 	this->paint.get()->AddTextureSRV("Albedo", paint.Get());
 	this->paint.get()->AddTextureSRV("NormalMap", paintNormal.Get());
 	this->paint.get()->AddTextureSRV("RoughnessMap", paintRoughness.Get());
@@ -257,127 +340,109 @@ void Game::CreateBasicGeometry()
 	float alleyWidth = 3.0f;
 	float lineHeight = -0.49; // lines are slightly above ground;
 
-	court = std::vector<Entity*>();
-	Entity* courtBase = new Entity(cube, this->asteroid);
-	courtBase->GetTransform()->Scale(cubeScaler, cubeScaler, cubeScaler);
-	courtBase->GetTransform()->Scale(AREA_HALF_WIDTH * 4, 1, 2 * AREA_HALF_HEIGHT);
-	courtBase->GetTransform()->SetPosition(0, -0.5f, 0);
+	std::vector<EntityId> court;
+	EntityId courtBase = CreateRenderable(cube, this->asteroid);
+	world.GetTransform(courtBase)->Scale(cubeScaler, cubeScaler, cubeScaler);
+	world.GetTransform(courtBase)->Scale(AREA_HALF_WIDTH * 4, 1, 2 * AREA_HALF_HEIGHT);
+	world.GetTransform(courtBase)->SetPosition(0, -0.5f, 0);
 	court.push_back(courtBase);
 
-	Entity* leftSingles = new Entity(cube, this->pureWhite);
-	leftSingles->GetTransform()->Scale(cubeScaler, cubeScaler, cubeScaler);
-	leftSingles->GetTransform()->Scale(lineWidth, 1, COURT_HALF_HEIGHT * 2);
-	leftSingles->GetTransform()->SetPosition(-COURT_HALF_WIDTH, lineHeight, 0);
-	court.push_back(leftSingles);
-
-	Entity* rightSingles = new Entity(cube, this->pureWhite);
-	rightSingles->GetTransform()->Scale(cubeScaler, cubeScaler, cubeScaler);
-	rightSingles->GetTransform()->Scale(lineWidth, 1, COURT_HALF_HEIGHT * 2);
-	rightSingles->GetTransform()->SetPosition(COURT_HALF_WIDTH, lineHeight, 0);
-	court.push_back(rightSingles);
-
-	Entity* leftDoubles = new Entity(cube, this->pureWhite);
-	leftDoubles->GetTransform()->Scale(cubeScaler, cubeScaler, cubeScaler);
-	leftDoubles->GetTransform()->Scale(lineWidth, 1, COURT_HALF_HEIGHT * 2);
-	leftDoubles->GetTransform()->SetPosition(-COURT_HALF_WIDTH - alleyWidth, lineHeight, 0);
-	court.push_back(leftDoubles);
-
-	Entity* rightDoubles = new Entity(cube, this->pureWhite);
-	rightDoubles->GetTransform()->Scale(cubeScaler, cubeScaler, cubeScaler);
-	rightDoubles->GetTransform()->Scale(lineWidth, 1, COURT_HALF_HEIGHT * 2);
-	rightDoubles->GetTransform()->SetPosition(COURT_HALF_WIDTH + alleyWidth, lineHeight, 0);
-	court.push_back(rightDoubles);
-
-	Entity* tLine = new Entity(cube, this->pureWhite);
-	tLine->GetTransform()->Scale(cubeScaler, cubeScaler, cubeScaler);
-	tLine->GetTransform()->Scale(lineWidth, 1, COURT_HALF_HEIGHT);
-	tLine->GetTransform()->SetPosition(0, lineHeight, 0);
-	court.push_back(tLine);
-
-	Entity* backBase = new Entity(cube, this->pureWhite);
-	backBase->GetTransform()->Scale(cubeScaler, cubeScaler, cubeScaler);
-	backBase->GetTransform()->Scale(COURT_HALF_WIDTH * 2 + 2 * alleyWidth, 1, lineWidth);
-	backBase->GetTransform()->SetPosition(0, lineHeight, -COURT_HALF_HEIGHT);
-	court.push_back(backBase);
-
-	Entity* farBase = new Entity(cube, this->pureWhite);
-	farBase->GetTransform()->Scale(cubeScaler, cubeScaler, cubeScaler);
-	farBase->GetTransform()->Scale(COURT_HALF_WIDTH * 2 + 2 * alleyWidth, 1, lineWidth);
-	farBase->GetTransform()->SetPosition(0, lineHeight, COURT_HALF_HEIGHT);
-	court.push_back(farBase);
-
-	Entity* backServe = new Entity(cube, this->pureWhite);
-	backServe->GetTransform()->Scale(cubeScaler, cubeScaler, cubeScaler);
-	backServe->GetTransform()->Scale(COURT_HALF_WIDTH * 2, 1, lineWidth);
-	backServe->GetTransform()->SetPosition(0, lineHeight, -COURT_HALF_HEIGHT / 2);
-	court.push_back(backServe);
-
-	Entity* farServe = new Entity(cube, this->pureWhite);
-	farServe->GetTransform()->Scale(cubeScaler, cubeScaler, cubeScaler);
-	farServe->GetTransform()->Scale(COURT_HALF_WIDTH * 2, 1, lineWidth);
-	farServe->GetTransform()->SetPosition(0, lineHeight, COURT_HALF_HEIGHT / 2);
-	court.push_back(farServe);
-
-	Entity* net = new Entity(cube, this->pureWhite);
-	net->GetTransform()->Scale(cubeScaler, cubeScaler, cubeScaler);
-	net->GetTransform()->Scale(28, 3.0f, 0.2f);
-	net->GetTransform()->SetPosition(0, 1.5f, 0);
-	court.push_back(net);
-
-	player = new Player(cube, this->paint);
-	player->GetTransform()->Scale(cubeScaler, 2 * cubeScaler, cubeScaler);
-
-	player->racketHandle = new Entity(cube, this->wood);
-	player->racketHandle->GetTransform()->Scale(cubeScaler, cubeScaler, cubeScaler);
-	player->racketHandle->GetTransform()->Scale(1.0f, 0.2f, 0.2f);
-
-	leftHandle = new Entity(cube, this->wood);
-	leftHandle->GetTransform()->Scale(cubeScaler, cubeScaler, cubeScaler);
-	leftHandle->GetTransform()->Scale(1.0f, 0.2f, 0.2f);
-	court.push_back(leftHandle); // I guess this counts as the court too now? idk man
-
-	rightHandle = new Entity(cube, this->wood);
-	rightHandle->GetTransform()->Scale(cubeScaler, cubeScaler, cubeScaler);
-	rightHandle->GetTransform()->Scale(1.0f, 0.2f, 0.2f);
-	court.push_back(rightHandle);
-
-	player->racketHead = new Entity(cylinder, this->wood);
-	player->racketHead->GetTransform()->Rotate(DirectX::XM_PIDIV2, 0.0f, 0.0f);
-	player->racketHead->GetTransform()->Scale(0.8f, 0.1f, 0.5f);
-
-	leftHead = new Entity(cylinder, this->wood);
-	leftHead->GetTransform()->Rotate(DirectX::XM_PIDIV2, 0.0f, 0.0f);
-	leftHead->GetTransform()->Scale(0.8f, 0.1f, 0.5f);
-	court.push_back(leftHead);
+	// the lines: x, z, width, length
+	float lines[9][4] = {
+		{ -COURT_HALF_WIDTH, 0, lineWidth, COURT_HALF_HEIGHT * 2 }, // left singles
+		{ COURT_HALF_WIDTH, 0, lineWidth, COURT_HALF_HEIGHT * 2 }, // right singles
+		{ -COURT_HALF_WIDTH - alleyWidth, 0, lineWidth, COURT_HALF_HEIGHT * 2 }, // left doubles
+		{ COURT_HALF_WIDTH + alleyWidth, 0, lineWidth, COURT_HALF_HEIGHT * 2 }, // right doubles
+		{ 0, 0, lineWidth, COURT_HALF_HEIGHT }, // t line
+		{ 0, -COURT_HALF_HEIGHT, COURT_HALF_WIDTH * 2 + 2 * alleyWidth, lineWidth }, // back base
+		{ 0, COURT_HALF_HEIGHT, COURT_HALF_WIDTH * 2 + 2 * alleyWidth, lineWidth }, // far base
+		{ 0, -COURT_HALF_HEIGHT / 2, COURT_HALF_WIDTH * 2, lineWidth }, // back serve
+		{ 0, COURT_HALF_HEIGHT / 2, COURT_HALF_WIDTH * 2, lineWidth } // far serve
+	};
+	for(float* line : lines) {
+		EntityId entity = CreateRenderable(cube, this->pureWhite);
+		Transform* transform = world.GetTransform(entity);
+		transform->Scale(cubeScaler, cubeScaler, cubeScaler);
+		transform->Scale(line[2], 1, line[3]);
+		transform->SetPosition(line[0], lineHeight, line[1]);
+		court.push_back(entity);
+	}
 
-	rightHead = new Entity(cylinder, this->wood);
-	rightHead->GetTransform()->Rotate(DirectX::XM_PIDIV2, 0.0f, 0.0f);
-	rightHead->GetTransform()->Scale(0.8f, 0.1f, 0.5f);
-	court.push_back(rightHead);
+	EntityId net = CreateRenderable(cube, this->pureWhite);
+	world.GetTransform(net)->Scale(cubeScaler, cubeScaler, cubeScaler);
+	world.GetTransform(net)->Scale(28, 3.0f, 0.2f);
+	world.GetTransform(net)->SetPosition(0, 1.5f, 0);
+	court.push_back(net);
 
-	ball = new Ball(sphere, this->lightGreen);
-	ball->GetTransform()->Scale(0.8f, 0.8f, 0.8f);
+	// none of the court ever moves, so it's merged into one draw per material
+	StaticBatch staticBatch(device, context);
+	for(EntityId entity : court) {
+		staticBatch.Add(world, entity);
+	}
+	staticBatch.Build(world);
+
+	player = CreateRenderable(cube, this->paint, HasPlayer);
+	world.GetTransform(player)->SetPosition(0.0f, 1.5f, 0.0f);
+	world.GetTransform(player)->Scale(cubeScaler, 2 * cubeScaler, cubeScaler);
+
+	enemy = CreateRenderable(cube, this->paint, HasEnemy);
+	world.GetTransform(enemy)->SetPosition(0, 1.5, COURT_HALF_HEIGHT);
+	world.GetTransform(enemy)->Scale(cubeScaler, 2 * cubeScaler, cubeScaler);
+
+	// rackets are children of whoever holds them, starting off to the side
+	EntityId owners[] = { player, player, enemy, enemy, enemy, enemy };
+	float offsets[] = { 0.9f, 1.5f, 0.9f, 1.5f, -0.9f, -1.5f };
+	EntityId parts[6];
+	for(int i = 0; i < 6; i++) {
+		if(i % 2 == 0) {
+			parts[i] = CreateRenderable(cube, this->wood); // handle
+			world.GetTransform(parts[i])->Scale(cubeScaler, cubeScaler, cubeScaler);
+			world.GetTransform(parts[i])->Scale(1.0f, 0.2f, 0.2f);
+		}
+		else {
+			parts[i] = CreateRenderable(cylinder, this->quantizedWood); // head
+			world.GetTransform(parts[i])->Rotate(DirectX::XM_PIDIV2, 0.0f, 0.0f);
+			world.GetTransform(parts[i])->Scale(0.8f, 0.1f, 0.5f);
+		}
+	}
+	for(int i = 0; i < 6; i++) {
+		XMFLOAT3 ownerPosition = world.GetTransform(owners[i])->GetPosition();
+		Transform* part = world.GetTransform(parts[i]);
+		part->SetPosition(ownerPosition.x + offsets[i], ownerPosition.y, ownerPosition.z);
+		part->SetParent(world.GetTransform(owners[i]));
+	}
+	world.GetPlayer(player)->racketHandle = parts[0];
+	world.GetPlayer(player)->racketHead = parts[1];
 
-	enemy = new Entity(cube, this->paint);
-	enemy->GetTransform()->SetPosition(0, 1.5, COURT_HALF_HEIGHT);
-	enemy->GetTransform()->Scale(cubeScaler, 2 * cubeScaler, cubeScaler);
+	ball = CreateRenderable(sphere, this->lightGreen, HasBall);
+	world.GetTransform(ball)->SetScale(0.5f, 0.5f, 0.5f);
+	world.GetTransform(ball)->Scale(0.8f, 0.8f, 0.8f);
+	world.GetRender(ball)->visible = false; // until it's served
 
 	sky = new Sky(cube, samplerState, device, skyVertexShader, skyPixelShader, skyBox);
 
 	// throw some rocks in there just cause
 	for(int i = 0; i < 20; i++) {
-		Entity* left = new Entity(sphere, this->asteroid);
-		left->GetTransform()->SetPosition(rand() % 1000 / 1000.0f * -20 - COURT_HALF_WIDTH - 5, 0, rand() % 1000 / 1000.0f * 2 * AREA_HALF_HEIGHT - AREA_HALF_HEIGHT);
-		left->GetTransform()->Scale(rand() % 1000 / 1000.0f * 3, rand() % 1000 / 1000.0f * 3, rand() % 1000 / 1000.0f * 3);
-		court.push_back(left);
-
-		Entity* right = new Entity(sphere, this->asteroid);
-		right->GetTransform()->SetPosition(rand() % 1000 / 1000.0f * 20 + COURT_HALF_WIDTH + 5, 0, rand() % 1000 / 1000.0f * 2 * AREA_HALF_HEIGHT - AREA_HALF_HEIGHT);
-		right->GetTransform()->Scale(rand() % 1000 / 1000.0f * 3, rand() % 1000 / 1000.0f * 3, rand() % 1000 / 1000.0f * 3);
-		court.push_back(right);
+		EntityId left = CreateRenderable(sphere, this->asteroid);
+		world.GetTransform(left)->SetPosition(rand() % 1000 / 1000.0f * -20 - COURT_HALF_WIDTH - 5, 0, rand() % 1000 / 1000.0f * 2 * AREA_HALF_HEIGHT - AREA_HALF_HEIGHT);
+		world.GetTransform(left)->Scale(rand() % 1000 / 1000.0f * 3, rand() % 1000 / 1000.0f * 3, rand() % 1000 / 1000.0f * 3);
+
+		EntityId right = CreateRenderable(sphere, this->asteroid);
+		world.GetTransform(right)->SetPosition(rand() % 1000 / 1000.0f * 20 + COURT_HALF_WIDTH + 5, 0, rand() % 1000 / 1000.0f * 2 * AREA_HALF_HEIGHT - AREA_HALF_HEIGHT);
+		world.GetTransform(right)->Scale(rand() % 1000 / 1000.0f * 3, rand() % 1000 / 1000.0f * 3, rand() % 1000 / 1000.0f * 3);
 	}
 }
 
+// an entity with a transform and render component, plus whatever else is asked for
+EntityId Game::CreateRenderable(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material, ComponentMask components)
+{
+	EntityId entity = world.Create(HasTransform | HasRender | components);
+	RenderComponent* render = world.GetRender(entity);
+	render->mesh = mesh;
+	render->material = material;
+	return entity;
+}
+
 
 // --------------------------------------------------------
 // Handle resizing DirectX "stuff" to match the new window size.
@@ -401,10 +466,10 @@ void Game::Update(float deltaTime, float totalTime)
 	if (Input::GetInstance().KeyDown(VK_ESCAPE))
 		Quit();
 
-	player->Update(deltaTime, ball);
+	Systems::UpdatePlayers(world, deltaTime, ball);
 
-	if(ball->IsActive()) {
-		int scorer = ball->Update(deltaTime);
+	if(world.GetBall(ball)->active) {
+		int scorer = Systems::UpdateBalls(world, deltaTime);
 		if(scorer > 0) {
 			ScorePoint(true);
 		}
@@ -412,22 +477,22 @@ void Game::Update(float deltaTime, float totalTime)
 			ScorePoint(false);
 		}
 		ballLight.intensity = 1;
-		ballLight.position = ball->GetTransform()->GetPosition();
+		ballLight.position = world.GetTransform(ball)->GetPosition();
 
-		UpdateEnemy(deltaTime);
+		Systems::UpdateEnemies(world, deltaTime, ball);
 	} 
 	else {
 		ballLight.intensity = 0; // don't show
 		if(Input::GetInstance().KeyPress('W')) {
-			ball->Serve(player->GetTransform()->GetPosition());
+			Systems::ServeBall(world, ball, world.GetTransform(player)->GetPosition());
 		}
 
 		// lock player to baseline when serving
-		XMFLOAT3 playPos = player->GetTransform()->GetPosition();
-		player->GetTransform()->SetPosition(playPos.x, playPos.y, -COURT_HALF_HEIGHT - 0.5f);
+		XMFLOAT3 playPos = world.GetTransform(player)->GetPosition();
+		world.GetTransform(player)->SetPosition(playPos.x, playPos.y, -COURT_HALF_HEIGHT - 0.5f);
 	}
 	
-	worldCam->Update(player->GetTransform()->GetPosition());
+	worldCam->Update(world.GetTransform(player)->GetPosition());
 }
 
 // --------------------------------------------------------
@@ -448,6 +513,16 @@ void Game::Draw(float deltaTime, float totalTime)
 		1.0f,
 		0);
 
+	stateCache->BeginFrame();
+	constantRing->BeginFrame();
+
+	// everything that stays the same for the whole frame goes in each shader's PerFrame buffer once.
+	// The per entity vertex shaders get world * viewProjection from the render queue instead
+	instancedVertexShader->SetMatrix4x4("viewProjection", worldCam->GetViewProjection());
+	instancedVertexShader->CopyBufferData("PerFrame");
+
+	pixelShader->SetFloat3("cameraPosition", worldCam->GetPosition());
+	pixelShader->SetFloat3("ambient", ambientColor);
 	pixelShader->SetData(
 		"directionalLight",   // The name of the (eventual) variable in the shader 
 		&dirLight,   // The address of the data to set 
@@ -457,33 +532,36 @@ void Game::Draw(float deltaTime, float totalTime)
 		"ballLight",
 		&ballLight,
 		sizeof(Light));
+	pixelShader->CopyBufferData("PerFrame");
 
 	
-	for(Entity* entity : court) {
-		entity->GetMaterial()->GetPixelShader()->SetFloat3("ambient", ambientColor);
-		entity->Draw(context, worldCam);
-	}
-	player->GetMaterial()->GetPixelShader()->SetFloat3("ambient", ambientColor);
-	player->Draw(context, worldCam);
-	player->racketHead->GetMaterial()->GetPixelShader()->SetFloat3("ambient", ambientColor);
-	player->racketHead->Draw(context, worldCam);
-	player->racketHandle->GetMaterial()->GetPixelShader()->SetFloat3("ambient", ambientColor);
-	player->racketHandle->Draw(context, worldCam);
-	if(ball->IsActive()) {
-		ball->GetMaterial()->GetPixelShader()->SetFloat3("ambient", ambientColor);
-		ball->Draw(context, worldCam);
-	}
+	// every transform that changed this frame gets its matrices rebuilt in one pass
+	TransformPool::Default().UpdateDirty();
 
-	enemy->GetMaterial()->GetPixelShader()->SetFloat3("ambient", ambientColor);
-	enemy->Draw(context, worldCam);
+	// sorted by shader, material and mesh, then front to back
+	renderQueue.Clear();
+	Systems::SubmitRenderables(world, renderQueue, worldCam);
+	renderQueue.Sort();
+	renderQueue.Execute(context, worldCam, constantRing.get(), stateCache.get(), instanceBuffer.get());
 
-	sky->Draw(context, worldCam);
+	sky->Draw(context, worldCam, stateCache.get());
+
+	constantRing->EndFrame();
 
 	// Present the back buffer to the user
 	//  - Puts the final frame we're drawing into the window so the user can see it
 	//  - Do this exactly ONCE PER FRAME (always at the very end of the frame)
 	swapChain->Present(vsync ? 1 : 0, 0);
 
+#ifdef REPORT_STATS
+	if(!firstFrameReported) {
+		char report[128];
+		sprintf_s(report, "Time to first frame: %.3f ms\n", std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - launchTime).count());
+		OutputDebugStringA(report);
+		firstFrameReported = true;
+	}
+#endif
+
 	// Due to the usage of a more sophisticated swap chain,
 	// the render target must be re-bound after every call to Present()
 	context->OMSetRenderTargets(1, backBufferRTV.GetAddressOf(), depthStencilView.Get());
@@ -516,45 +594,6 @@ void Game::ScorePoint(bool playerPoint)
 	SetWindowText(hWnd, title.c_str());
 }
 
-void Game::UpdateEnemy(float dt) {
-	// move towards ball
-	XMFLOAT3 ballPos = ball->GetTransform()->GetPosition();
-	XMFLOAT3 position = enemy->GetTransform()->GetPosition();
-	float enemSpeed = 8.0f;
-	if(position.x > ballPos.x + 1.0f) {
-		enemy->GetTransform()->MoveAbsolute(-enemSpeed * dt, 0, 0);
-	}
-	else if(position.x < ballPos.x - 1.0f) {
-		enemy->GetTransform()->MoveAbsolute(enemSpeed * dt, 0, 0);
-	}
-
-	if(ballPos.z > COURT_HALF_HEIGHT - 4.0f && ballPos.y > 3.0f && ballPos.y > position.y) { // jump to ball when it gets towards the back
-		enemy->GetTransform()->MoveAbsolute(0, 2 * enemSpeed * dt, 0);
-	}
-	else if (position.y > 1.5f) { // come back down when ball is gone
-		enemy->GetTransform()->MoveAbsolute(0, -2 * enemSpeed * dt, 0);
-	}
-
-	// move rackets too
-	rightHandle->GetTransform()->SetPosition(0.9f + position.x, position.y, position.z);
-	leftHandle->GetTransform()->SetPosition(-0.9f + position.x, position.y, position.z);
-	rightHead->GetTransform()->SetPosition(1.5f + position.x, position.y, position.z);
-	leftHead->GetTransform()->SetPosition(-1.5f + position.x, position.y, position.z);
-
-	// hit ball when close
-	if(ballPos.z > COURT_HALF_HEIGHT - 2.0f && ballPos.z < COURT_HALF_HEIGHT + 2.0f
-		&& abs(ballPos.x - position.x) < 1.0f
-		&& abs(ballPos.y - position.y) < 2.0f
-	) {
-		float chanceChanger = 1.0f; // more likely to hit cross court
-		if(position.x > 0) {
-			chanceChanger *= -1;
-		}
-
-		ball->Hit(Vector3(rand() % 1000 / 1000.0f * 8.0f - 4.0f + chanceChanger, 8, -13), false);
-	}
-}
-
 // --------------------------------------------------------
 // Loads six individual textures (the six faces of a cube map), then
 // creates a blank cube map and copies each of the six textures to
@@ -562,24 +601,25 @@ void Game::UpdateEnemy(float dt) {
 // the cube map and cleans up all of the temporary resources.
 // --------------------------------------------------------
 Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> Game::CreateCubemap(
-	const wchar_t* right,
-	const wchar_t* left,
-	const wchar_t* up,
-	const wchar_t* down,
-	const wchar_t* front,
-	const wchar_t* back)
+	const ImageData& right,
+	const ImageData& left,
+	const ImageData& up,
+	const ImageData& down,
+	const ImageData& front,
+	const ImageData& back)
 {
-	// Load the 6 textures into an array.
+	// Upload the 6 already decoded faces into an array.
 	// - We need references to the TEXTURES, not the SHADER RESOURCE VIEWS!
 	// - Specifically NOT generating mipmaps, as we usually don't need them for the sky!
 	// - Order matters here!  +X, -X, +Y, -Y, +Z, -Z
-	ID3D11Texture2D* textures[6] = {};
-	CreateWICTextureFromFile(device.Get(), right, (ID3D11Resource**)&textures[0], 0);
-	CreateWICTextureFromFile(device.Get(), left, (ID3D11Resource**)&textures[1], 0);
-	CreateWICTextureFromFile(device.Get(), up, (ID3D11Resource**)&textures[2], 0);
-	CreateWICTextureFromFile(device.Get(), down, (ID3D11Resource**)&textures[3], 0);
-	CreateWICTextureFromFile(device.Get(), front, (ID3D11Resource**)&textures[4], 0);
-	CreateWICTextureFromFile(device.Get(), back, (ID3D11Resource**)&textures[5], 0);
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> textures[6] = {
+		TextureUploader::CreateTexture2D(device, right),
+		TextureUploader::CreateTexture2D(device, left),
+		TextureUploader::CreateTexture2D(device, up),
+		TextureUploader::CreateTexture2D(device, down),
+		TextureUploader::CreateTexture2D(device, front),
+		TextureUploader::CreateTexture2D(device, back)
+	};
 
 	// We'll assume all of the textures are the same color format and resolution,
 	// so get the description of the first shader resource view
@@ -621,7 +661,7 @@ Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> Game::CreateCubemap(
 			cubeMapTexture, // Destination resource
 			subresource,	// Dest subresource index (one of the array elements)
 			0, 0, 0,		// XYZ location of copy
-			textures[i],	// Source resource
+			textures[i].Get(),	// Source resource
 			0,	// Source subresource index (we're assuming there's only one)
 			0);	// Source subresource "box" of data to copy (zero means the whole thing)
 	}
@@ -640,8 +680,6 @@ Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> Game::CreateCubemap(
 
 	// Now that we're done, clean up the stuff we don't need anymore
 	cubeMapTexture->Release();  // Done with this particular reference (the SRV has another)
-	for (int i = 0; i < 6; i++)
-		textures[i]->Release();
 
 	// Send back the SRV, which is what we need for our shaders
 	return cubeSRV;
@@ -6,14 +6,19 @@
 #include "Mesh.h"
 #include <memory>
 #include <vector>
-#include "Entity.h"
+#include "World.h"
+#include "Systems.h"
 #include "Camera.h"
 #include "SimpleShader.h"
 #include "Material.h"
 #include "Lights.h"
 #include "Sky.h"
-#include "Player.h"
-#include "Ball.h"
+#include "AssetLoader.h"
+#include "ConstantBufferRing.h"
+#include "StateCache.h"
+#include "RenderQueue.h"
+#include "StaticBatch.h"
+#include <chrono>
 
 class Game 
 	: public DXCore
@@ -37,21 +42,17 @@ public:
 	static const int AREA_HALF_HEIGHT = 18;
 
 private:
-	void UpdateEnemy(float dt);
+	std::chrono::high_resolution_clock::time_point launchTime;
+	bool firstFrameReported;
 
 	int playerScore;
 	int enemyScore;
 
-	std::vector<Entity*> court;
-	Player* player;
-	Ball* ball;
-	Entity* enemy;
-
-	// enemy rackets
-	Entity* leftHead;
-	Entity* rightHead;
-	Entity* leftHandle;
-	Entity* rightHandle;
+	// owns every entity in the scene except the sky
+	World world;
+	EntityId player;
+	EntityId ball;
+	EntityId enemy;
 
 	std::shared_ptr<Mesh> cube;
 	std::shared_ptr<Mesh> cylinder;
@@ -62,6 +63,7 @@ private:
 	std::shared_ptr<Material> lightGreen;
 	std::shared_ptr<Material> asteroid;
 	std::shared_ptr<Material> wood;
+	std::shared_ptr<Material> quantizedWood;
 	std::shared_ptr<Material> paint;
 
 	DirectX::XMFLOAT3 ambientColor;
@@ -74,6 +76,7 @@ private:
 	// Initialization helper methods - feel free to customize, combine, etc.
 	void LoadShaders(); 
 	void CreateBasicGeometry();
+	EntityId CreateRenderable(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material, ComponentMask components = 0);
 
 	// Note the usage of ComPtr below
 	//  - This is a smart pointer for objects that abide by the
@@ -90,9 +93,21 @@ private:
 	std::shared_ptr<SimplePixelShader> customPixelShader;
 	std::shared_ptr<SimplePixelShader> skyPixelShader;
 	std::shared_ptr<SimpleVertexShader> skyVertexShader;
+	std::shared_ptr<SimpleVertexShader> quantizedVertexShader;
+	std::shared_ptr<SimpleVertexShader> instancedVertexShader;
 
 	Microsoft::WRL::ComPtr<ID3D11SamplerState> samplerState;
 
+	// per-object constants for every entity draw
+	std::shared_ptr<ConstantBufferRing> constantRing;
+
+	// every bind the game makes goes through this so duplicates get dropped
+	std::shared_ptr<StateCache> stateCache;
+
+	// reused every frame so its storage sticks around
+	RenderQueue renderQueue;
+	std::shared_ptr<InstanceBuffer> instanceBuffer;
+
 	Sky* sky;
 
 	// --------------------------------------------------------
@@ -110,10 +125,10 @@ private:
 	// --------------------------------------------------------
 	// Helper for creating a cubemap from 6 individual textures
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> CreateCubemap(
-		const wchar_t* right,
-		const wchar_t* left,
-		const wchar_t* up,
-		const wchar_t* down,
-		const wchar_t* front,
-		const wchar_t* back);
+		const ImageData& right,
+		const ImageData& left,
+		const ImageData& up,
+		const ImageData& down,
+		const ImageData& front,
+		const ImageData& back);
 };
\ No newline at end of file
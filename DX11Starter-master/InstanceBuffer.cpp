@@ -0,0 +1,54 @@
+#include "InstanceBuffer.h"
+#include <string.h>
+
+InstanceBuffer::InstanceBuffer(Microsoft::WRL::ComPtr<ID3D11Device> device, Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, unsigned int initialCapacity) {
+	this->device = device;
+	this->context = context;
+	capacity = 0;
+	CreateBuffer(initialCapacity);
+}
+
+bool InstanceBuffer::CreateBuffer(unsigned int capacity) {
+	D3D11_BUFFER_DESC desc = {};
+	desc.ByteWidth = sizeof(InstanceData) * capacity;
+	desc.Usage = D3D11_USAGE_DYNAMIC;
+	desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+	buffer.Reset();
+	this->capacity = 0;
+	if(FAILED(device->CreateBuffer(&desc, 0, buffer.GetAddressOf()))) {
+		return false;
+	}
+	this->capacity = capacity;
+	return true;
+}
+
+bool InstanceBuffer::Upload(const InstanceData* instances, unsigned int count) {
+	if(count == 0) {
+		return true;
+	}
+
+	// doubling keeps a growing scene from reallocating every frame
+	if(count > capacity) {
+		unsigned int newCapacity = capacity > 0 ? capacity : 1;
+		while(newCapacity < count) {
+			newCapacity *= 2;
+		}
+		if(!CreateBuffer(newCapacity)) {
+			return false;
+		}
+	}
+
+	D3D11_MAPPED_SUBRESOURCE mapped = {};
+	if(FAILED(context->Map(buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+		return false;
+	}
+	memcpy(mapped.pData, instances, sizeof(InstanceData) * count);
+	context->Unmap(buffer.Get(), 0);
+	return true;
+}
+
+ID3D11Buffer* InstanceBuffer::GetBuffer() {
+	return buffer.Get();
+}
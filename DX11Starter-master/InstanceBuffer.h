@@ -0,0 +1,32 @@
+#pragma once
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <DirectXMath.h>
+
+// matches the _PER_INSTANCE inputs of InstancedVertexShader.hlsl
+struct InstanceData
+{
+	DirectX::XMFLOAT4X4 world;
+	DirectX::XMFLOAT4X4 worldInverseTranspose;
+};
+
+// --------------------------------------------------------
+// Dynamic vertex buffer holding a frame's instance data,
+// rewritten in one WRITE_DISCARD map and grown on demand
+// --------------------------------------------------------
+class InstanceBuffer
+{
+public:
+	InstanceBuffer(Microsoft::WRL::ComPtr<ID3D11Device> device, Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, unsigned int initialCapacity = 256);
+
+	bool Upload(const InstanceData* instances, unsigned int count);
+	ID3D11Buffer* GetBuffer();
+
+private:
+	Microsoft::WRL::ComPtr<ID3D11Device> device;
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext> context;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> buffer;
+	unsigned int capacity;
+
+	bool CreateBuffer(unsigned int capacity);
+};
@@ -0,0 +1,44 @@
+#include "ShaderStructs.hlsli"
+
+// set once per frame by Game::Draw
+cbuffer PerFrame : register(b0) {
+	matrix viewProjection;
+}
+
+// the _PER_INSTANCE suffix puts these in input slot 1, one element per instance
+struct VertexShaderInput
+{
+	float3 localPosition: POSITION; // XYZ position
+	float3 normal: NORMAL;
+	float3 tangent: TANGENT;
+	float2 uv: TEXCOORD;
+	float4 world0 : WORLD_PER_INSTANCE0;
+	float4 world1 : WORLD_PER_INSTANCE1;
+	float4 world2 : WORLD_PER_INSTANCE2;
+	float4 world3 : WORLD_PER_INSTANCE3;
+	float4 worldInverseTranspose0 : WORLD_INVERSE_TRANSPOSE_PER_INSTANCE0;
+	float4 worldInverseTranspose1 : WORLD_INVERSE_TRANSPOSE_PER_INSTANCE1;
+	float4 worldInverseTranspose2 : WORLD_INVERSE_TRANSPOSE_PER_INSTANCE2;
+	float4 worldInverseTranspose3 : WORLD_INVERSE_TRANSPOSE_PER_INSTANCE3;
+};
+
+VertexToPixel main( VertexShaderInput input )
+{
+	VertexToPixel output;
+
+	// rows arrive as the C++ matrix rows, so transposing gives the same
+	// matrices VertexShader.hlsl reads out of its constant buffer
+	matrix world = transpose(float4x4(input.world0, input.world1, input.world2, input.world3));
+	matrix worldInverseTranspose = transpose(float4x4(input.worldInverseTranspose0, input.worldInverseTranspose1, input.worldInverseTranspose2, input.worldInverseTranspose3));
+
+	// the world position is needed anyway, so projecting it costs one matrix-vector multiply
+	output.worldPosition = mul(world, float4(input.localPosition, 1.0f)).xyz;
+	output.screenPosition = mul(viewProjection, float4(output.worldPosition, 1.0f));
+	output.normal = mul((float3x3)worldInverseTranspose, input.normal);
+
+	output.tangent = mul((float3x3)worldInverseTranspose, input.tangent);
+
+	output.uv = input.uv;
+
+	return output;
+}
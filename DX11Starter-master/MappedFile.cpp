@@ -0,0 +1,110 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const char* fileName)
+{
+	data = nullptr;
+	size = 0;
+
+#ifdef _WIN32
+	mapping = nullptr;
+	file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if(file == INVALID_HANDLE_VALUE) {
+		file = nullptr;
+		return;
+	}
+
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+		Close();
+		return;
+	}
+
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if(mapping == nullptr) {
+		Close();
+		return;
+	}
+
+	data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if(data == nullptr) {
+		Close();
+		return;
+	}
+	size = (size_t)fileSize.QuadPart;
+#else
+	file = open(fileName, O_RDONLY);
+	if(file < 0) {
+		return;
+	}
+
+	struct stat fileInfo;
+	if(fstat(file, &fileInfo) != 0 || fileInfo.st_size == 0) {
+		Close();
+		return;
+	}
+
+	void* view = mmap(nullptr, (size_t)fileInfo.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	if(view == MAP_FAILED) {
+		Close();
+		return;
+	}
+	data = (const char*)view;
+	size = (size_t)fileInfo.st_size;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::IsOpen()
+{
+	return data != nullptr;
+}
+
+const char* MappedFile::GetData()
+{
+	return data;
+}
+
+size_t MappedFile::GetSize()
+{
+	return size;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if(data != nullptr) {
+		UnmapViewOfFile(data);
+	}
+	if(mapping != nullptr) {
+		CloseHandle(mapping);
+	}
+	if(file != nullptr) {
+		CloseHandle(file);
+	}
+	mapping = nullptr;
+	file = nullptr;
+#else
+	if(data != nullptr) {
+		munmap((void*)data, size);
+	}
+	if(file >= 0) {
+		close(file);
+	}
+	file = -1;
+#endif
+	data = nullptr;
+	size = 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <stddef.h>
+
+// read-only view of a whole file mapped into memory, so loaders can
+// tokenize the bytes in place instead of copying them line by line
+class MappedFile
+{
+public:
+	MappedFile(const char* fileName);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool IsOpen();
+	const char* GetData();
+	size_t GetSize();
+
+private:
+	void Close();
+
+	const char* data;
+	size_t size;
+
+#ifdef _WIN32
+	void* file; // HANDLE
+	void* mapping; // HANDLE
+#else
+	int file;
+#endif
+};
@@ -1,5 +1,24 @@
 #include "Material.h"
 
+unsigned int Material::nextId = 0;
+
+// grows the range starting at start to cover slot, leaving any new gaps null
+template<typename T>
+static void PlaceInRange(std::vector<T*>& range, unsigned int& start, unsigned int slot, T* value)
+{
+    if (range.empty()) {
+        start = slot;
+    }
+    else if (slot < start) {
+        range.insert(range.begin(), start - slot, nullptr);
+        start = slot;
+    }
+    if (slot - start >= range.size()) {
+        range.resize(slot - start + 1, nullptr);
+    }
+    range[slot - start] = value;
+}
+
 Material::Material(DirectX::XMFLOAT4 tint, std::shared_ptr<SimpleVertexShader> vertexShader, std::shared_ptr<SimplePixelShader> pixelShader, float roughness)
 {
     this->tint = tint;
@@ -7,6 +26,18 @@ Material::Material(DirectX::XMFLOAT4 tint, std::shared_ptr<SimpleVertexShader> v
     this->vertexShader = vertexShader;
     this->roughness = roughness;
     this->uvScale = 1.0f;
+    this->id = nextId++;
+    this->bindingsDirty = true;
+
+    variables.worldViewProjection = vertexShader->GetVariableHandle("worldViewProjection");
+    variables.world = vertexShader->GetVariableHandle("world");
+    variables.worldInverseTranspose = vertexShader->GetVariableHandle("worldInverseTranspose");
+    variables.positionOffset = vertexShader->GetVariableHandle("positionOffset");
+    variables.positionScale = vertexShader->GetVariableHandle("positionScale");
+
+    variables.colorTint = pixelShader->GetVariableHandle("colorTint");
+    variables.roughness = pixelShader->GetVariableHandle("roughness");
+    variables.uvScale = pixelShader->GetVariableHandle("uvScale");
 }
 
 DirectX::XMFLOAT4 Material::GetTint()
@@ -22,23 +53,57 @@ std::shared_ptr<SimplePixelShader> Material::GetPixelShader()
 void Material::AddTextureSRV(std::string name, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv)
 {
     textureSRVs.insert({ name, srv });
+    bindingsDirty = true;
 }
 
 void Material::AddSampler(std::string name, Microsoft::WRL::ComPtr<ID3D11SamplerState> samplerState)
 {
     samplers.insert({ name, samplerState });
+    bindingsDirty = true;
 }
 
-std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>> Material::GetTextureSRVs()
+const std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>>& Material::GetTextureSRVs()
 {
     return textureSRVs;
 }
 
-std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D11SamplerState>> Material::GetSamplers()
+const std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D11SamplerState>>& Material::GetSamplers()
 {
     return samplers;
 }
 
+const MaterialBindings& Material::GetBindings()
+{
+    if (bindingsDirty) {
+        CompileBindings();
+    }
+    return bindings;
+}
+
+// looks every name up in the pixel shader once, so drawing is two range binds
+void Material::CompileBindings()
+{
+    bindings.srvs.clear();
+    bindings.samplers.clear();
+    bindings.srvStart = 0;
+    bindings.samplerStart = 0;
+
+    for (auto& t : textureSRVs) {
+        const SimpleSRV* info = pixelShader->GetShaderResourceViewInfo(t.first);
+        if (info) {
+            PlaceInRange(bindings.srvs, bindings.srvStart, info->BindIndex, t.second.Get());
+        }
+    }
+    for (auto& s : samplers) {
+        const SimpleSampler* info = pixelShader->GetSamplerInfo(s.first);
+        if (info) {
+            PlaceInRange(bindings.samplers, bindings.samplerStart, info->BindIndex, s.second.Get());
+        }
+    }
+
+    bindingsDirty = false;
+}
+
 void Material::SetUVScale(float value)
 {
     uvScale = value;
@@ -54,6 +119,41 @@ float Material::GetRoughness()
     return roughness;
 }
 
+const MaterialVariables& Material::GetVariables()
+{
+    return variables;
+}
+
+unsigned int Material::GetId()
+{
+    return id;
+}
+
+void Material::SetInstancedVertexShader(std::shared_ptr<SimpleVertexShader> shader)
+{
+    instancedVertexShader = shader;
+}
+
+std::shared_ptr<SimpleVertexShader> Material::GetInstancedVertexShader()
+{
+    return instancedVertexShader;
+}
+
+void Material::ApplyPixelShader()
+{
+    pixelShader->SetFloat4(variables.colorTint, tint);
+    pixelShader->SetFloat(variables.roughness, roughness);
+    pixelShader->SetFloat(variables.uvScale, uvScale);
+
+    const MaterialBindings& b = GetBindings();
+    pixelShader->SetShaderResourceViews(b.srvStart, (unsigned int)b.srvs.size(), b.srvs.data());
+    pixelShader->SetSamplerStates(b.samplerStart, (unsigned int)b.samplers.size(), b.samplers.data());
+
+    // only actually uploads when this material differs from the last one drawn with the shader
+    pixelShader->CopyBufferData(variables.colorTint.ConstantBufferIndex);
+    pixelShader->SetShader();
+}
+
 std::shared_ptr<SimpleVertexShader> Material::GetVertexShader()
 {
     return vertexShader;
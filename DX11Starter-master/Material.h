@@ -3,8 +3,35 @@
 #include <memory>
 #include "SimpleShader.h"
 #include <unordered_map>
+#include <vector>
 #include <string.h>
 
+// shader variables every entity sets, looked up once per material instead of by name per draw
+struct MaterialVariables
+{
+	// vertex shader PerObject buffer
+	SimpleShaderVariableHandle worldViewProjection;
+	SimpleShaderVariableHandle world;
+	SimpleShaderVariableHandle worldInverseTranspose;
+	SimpleShaderVariableHandle positionOffset;
+	SimpleShaderVariableHandle positionScale;
+
+	// pixel shader PerMaterial buffer
+	SimpleShaderVariableHandle colorTint;
+	SimpleShaderVariableHandle roughness;
+	SimpleShaderVariableHandle uvScale;
+};
+
+// textures and samplers resolved to pixel shader registers, one contiguous range
+// each. Registers in a range the material has nothing for hold null
+struct MaterialBindings
+{
+	unsigned int srvStart;
+	std::vector<ID3D11ShaderResourceView*> srvs;
+	unsigned int samplerStart;
+	std::vector<ID3D11SamplerState*> samplers;
+};
+
 class Material
 {
 public:
@@ -15,19 +42,37 @@ public:
 	std::shared_ptr<SimplePixelShader> GetPixelShader();
 	void AddTextureSRV(std::string name, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv);
 	void AddSampler(std::string name, Microsoft::WRL::ComPtr<ID3D11SamplerState> samplerState);
-	std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>> GetTextureSRVs();
-	std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D11SamplerState>> GetSamplers();
+	const std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>>& GetTextureSRVs();
+	const std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D11SamplerState>>& GetSamplers();
+	const MaterialBindings& GetBindings();
 	void SetUVScale(float value);
 	float GetUVScale();
 	float GetRoughness();
+	const MaterialVariables& GetVariables();
+	unsigned int GetId();
+
+	// same pixel shader, but world matrices come from an instance buffer
+	void SetInstancedVertexShader(std::shared_ptr<SimpleVertexShader> shader);
+	std::shared_ptr<SimpleVertexShader> GetInstancedVertexShader();
+
+	// sets this material's pixel shader data, textures and samplers, then the shader itself
+	void ApplyPixelShader();
 
 private:
+	static unsigned int nextId;
+	unsigned int id; // sequential, for render queue sort keys
 	DirectX::XMFLOAT4 tint;
 	std::shared_ptr<SimpleVertexShader> vertexShader;
 	std::shared_ptr<SimplePixelShader> pixelShader;
+	std::shared_ptr<SimpleVertexShader> instancedVertexShader;
 	std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>> textureSRVs;
 	std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D11SamplerState>> samplers;
 	float roughness; // 0 - 1
 	float uvScale;
+	MaterialVariables variables;
+	MaterialBindings bindings; // raw pointers into the maps above, rebuilt when they change
+	bool bindingsDirty;
+
+	void CompileBindings();
 };
 
@@ -0,0 +1,10 @@
+#include "MatrixBatch.h"
+
+using namespace DirectX;
+
+void MatrixBatch::Multiply(const XMFLOAT4X4* left, size_t count, const XMFLOAT4X4& right, XMFLOAT4X4* out) {
+	XMMATRIX shared = XMLoadFloat4x4(&right);
+	for(size_t i = 0; i < count; i++) {
+		XMStoreFloat4x4(&out[i], XMMatrixMultiply(XMLoadFloat4x4(&left[i]), shared));
+	}
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <DirectXMath.h>
+#include <stddef.h>
+
+// Multiplies many matrices by the same matrix with XMMATRIX math,
+// loading the shared one into registers once. Row vector order,
+// so out[i] = left[i] * right, e.g. world * viewProjection.
+class MatrixBatch
+{
+public:
+	static void Multiply(const DirectX::XMFLOAT4X4* left, size_t count, const DirectX::XMFLOAT4X4& right, DirectX::XMFLOAT4X4* out);
+};
@@ -1,7 +1,13 @@
 #pragma once
 #include <d3d11.h>
+#include <DirectXCollision.h>
 #include <wrl/client.h>
+#include <chrono>
+#include <memory>
 #include "Vertex.h"
+#include "MeshData.h"
+#include "VertexQuantizer.h"
+#include "StateCache.h"
 
 class Mesh
 {
@@ -9,18 +15,41 @@ private:
 	Microsoft::WRL::ComPtr<ID3D11Buffer> vertexBuffer;
 	Microsoft::WRL::ComPtr<ID3D11Buffer> indexBuffer;
 	Microsoft::WRL::ComPtr<ID3D11DeviceContext> context;
-	void CreateMesh(Vertex* vertices, int numVertices, unsigned int* indices, int numIndices, Microsoft::WRL::ComPtr<ID3D11Device> device, Microsoft::WRL::ComPtr<ID3D11DeviceContext> context);
-	void CalculateTangents(Vertex* verts, int numVerts, unsigned int* indices, int numIndices);
+	void CreateBuffers(const Vertex* vertices, int numVertices, const unsigned int* indices, int numIndices, Microsoft::WRL::ComPtr<ID3D11Device> device);
 	int numIndices;
+	DXGI_FORMAT indexFormat; // R16_UINT whenever every index fits
+	WeldStats weldStats;
+	CacheStats cacheStats;
+	MeshBounds bounds;
+	VertexFormat vertexFormat;
+	DirectX::XMFLOAT3 positionOffset; // dequantization, bounds min
+	DirectX::XMFLOAT3 positionScale; // dequantization, bounds extent
+	void ReportLoad(std::shared_ptr<MeshData> data, std::chrono::high_resolution_clock::time_point uploadStart); // only with REPORT_STATS defined
+	void BindBuffers(StateCache* stateCache);
+	static unsigned int nextId;
+	unsigned int id; // sequential, for render queue sort keys
+	std::shared_ptr<MeshData> data; // kept for static batching, null for meshes built from raw arrays
 
 public:
 	Microsoft::WRL::ComPtr<ID3D11Buffer> GetVertexBuffer();
 	Microsoft::WRL::ComPtr<ID3D11Buffer> GetIndexBuffer();
 	int GetIndexCount();
-	void Draw();
+	DXGI_FORMAT GetIndexFormat();
+	WeldStats GetWeldStats();
+	CacheStats GetCacheStats();
+	VertexFormat GetVertexFormat();
+	DirectX::XMFLOAT3 GetPositionOffset();
+	DirectX::XMFLOAT3 GetPositionScale();
+	DirectX::BoundingBox GetBoundingBox();
+	DirectX::BoundingSphere GetBoundingSphere();
+	unsigned int GetId();
+	std::shared_ptr<MeshData> GetData();
+	void Draw(StateCache* stateCache = nullptr);
+	void DrawInstanced(ID3D11Buffer* instanceBuffer, UINT instanceStride, UINT instanceCount, UINT startInstance, StateCache* stateCache = nullptr);
 
-	Mesh(const char* fileName, Microsoft::WRL::ComPtr<ID3D11Device> device, Microsoft::WRL::ComPtr<ID3D11DeviceContext> context);
-	Mesh(Vertex* vertices, int numVertices, unsigned int* indices, int numIndices, Microsoft::WRL::ComPtr<ID3D11Device> device, Microsoft::WRL::ComPtr<ID3D11DeviceContext> context);
+	Mesh(const char* fileName, Microsoft::WRL::ComPtr<ID3D11Device> device, Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, bool optimizeVertexCache = true, VertexFormat vertexFormat = VertexFormatFull);
+	Mesh(std::shared_ptr<MeshData> data, Microsoft::WRL::ComPtr<ID3D11Device> device, Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, VertexFormat vertexFormat = VertexFormatFull);
+	Mesh(Vertex* vertices, int numVertices, unsigned int* indices, int numIndices, Microsoft::WRL::ComPtr<ID3D11Device> device, Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, bool optimizeVertexCache = true, VertexFormat vertexFormat = VertexFormatFull);
 	~Mesh();
 };
 
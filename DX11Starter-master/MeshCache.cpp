@@ -0,0 +1,111 @@
+#include "MeshCache.h"
+#include <fstream>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+MeshCache::MeshCache(const char* sourceFileName, uint32_t flags) : file(GetCachePath(sourceFileName).c_str())
+{
+	header = nullptr;
+	if(!file.IsOpen() || file.GetSize() < sizeof(MeshCacheHeader)) {
+		return;
+	}
+
+	const MeshCacheHeader* candidate = (const MeshCacheHeader*)file.GetData();
+	if(candidate->magic != Magic || candidate->version != Version || candidate->vertexStride != sizeof(Vertex) || candidate->flags != flags) {
+		return;
+	}
+
+	// a truncated or partially written cache is treated as stale
+	uint64_t expectedSize = sizeof(MeshCacheHeader)
+		+ (uint64_t)candidate->vertexCount * sizeof(Vertex)
+		+ (uint64_t)candidate->indexCount * sizeof(unsigned int);
+	if(file.GetSize() != expectedSize || candidate->vertexCount == 0 || candidate->indexCount == 0) {
+		return;
+	}
+
+	uint64_t sourceSize;
+	uint64_t sourceWriteTime;
+	if(!GetSourceStamp(sourceFileName, sourceSize, sourceWriteTime)
+		|| sourceSize != candidate->sourceSize
+		|| sourceWriteTime != candidate->sourceWriteTime) {
+		return;
+	}
+
+	header = candidate;
+}
+
+bool MeshCache::IsValid()
+{
+	return header != nullptr;
+}
+
+const MeshCacheHeader* MeshCache::GetHeader()
+{
+	return header;
+}
+
+const Vertex* MeshCache::GetVertices()
+{
+	return (const Vertex*)(file.GetData() + sizeof(MeshCacheHeader));
+}
+
+const unsigned int* MeshCache::GetIndices()
+{
+	return (const unsigned int*)(file.GetData() + sizeof(MeshCacheHeader) + header->vertexCount * sizeof(Vertex));
+}
+
+bool MeshCache::Write(const char* sourceFileName, const Vertex* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount, unsigned int sourceVertexCount, const MeshBounds& bounds, const CacheStats& cacheStats, uint32_t flags)
+{
+	MeshCacheHeader newHeader = {};
+	newHeader.magic = Magic;
+	newHeader.version = Version;
+	newHeader.vertexStride = sizeof(Vertex);
+	newHeader.vertexCount = vertexCount;
+	newHeader.indexCount = indexCount;
+	newHeader.sourceVertexCount = sourceVertexCount;
+	newHeader.flags = flags;
+	newHeader.cacheStats = cacheStats;
+	newHeader.bounds = bounds;
+	if(!GetSourceStamp(sourceFileName, newHeader.sourceSize, newHeader.sourceWriteTime)) {
+		return false;
+	}
+
+	std::ofstream out(GetCachePath(sourceFileName), std::ios::binary | std::ios::trunc);
+	if(!out.is_open()) {
+		return false;
+	}
+	out.write((const char*)&newHeader, sizeof(MeshCacheHeader));
+	out.write((const char*)vertices, sizeof(Vertex) * vertexCount);
+	out.write((const char*)indices, sizeof(unsigned int) * indexCount);
+	return out.good();
+}
+
+std::string MeshCache::GetCachePath(const char* sourceFileName)
+{
+	return std::string(sourceFileName) + ".meshcache";
+}
+
+bool MeshCache::GetSourceStamp(const char* sourceFileName, uint64_t& size, uint64_t& writeTime)
+{
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if(!GetFileAttributesExA(sourceFileName, GetFileExInfoStandard, &attributes)) {
+		return false;
+	}
+	size = ((uint64_t)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+	writeTime = ((uint64_t)attributes.ftLastWriteTime.dwHighDateTime << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+#else
+	struct stat info;
+	if(stat(sourceFileName, &info) != 0) {
+		return false;
+	}
+	size = (uint64_t)info.st_size;
+	// in nanoseconds, whole seconds would miss a source rewritten within one
+	writeTime = (uint64_t)info.st_mtim.tv_sec * 1000000000ull + (uint64_t)info.st_mtim.tv_nsec;
+#endif
+	return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include "Vertex.h"
+#include "BoundingVolumes.h"
+#include "VertexCacheOptimizer.h"
+#include "MappedFile.h"
+
+// --------------------------------------------------------
+// Binary cache of a fully processed mesh, stored next to the
+// source file as "<source>.meshcache". Layout:
+//   MeshCacheHeader
+//   Vertex[vertexCount]        (welded, tangents already computed)
+//   unsigned int[indexCount]
+// The cache is only used while the source size, last write
+// time, the format version and the processing flags all
+// still match.
+// --------------------------------------------------------
+enum MeshCacheFlags
+{
+	MeshCacheOptimized = 1 << 0 // reordered by VertexCacheOptimizer
+};
+
+struct MeshCacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t vertexStride;
+	uint32_t vertexCount;
+	uint32_t indexCount;
+	uint32_t sourceVertexCount; // before welding, for load reports
+	uint32_t flags; // MeshCacheFlags
+	CacheStats cacheStats; // from when the source was processed, for load reports
+	uint32_t reserved; // keeps the 64 bit fields aligned, always 0
+	uint64_t sourceSize;
+	uint64_t sourceWriteTime;
+	MeshBounds bounds;
+};
+
+class MeshCache
+{
+public:
+	// a cache written with other flags is a miss
+	MeshCache(const char* sourceFileName, uint32_t flags);
+
+	bool IsValid();
+	const MeshCacheHeader* GetHeader();
+	const Vertex* GetVertices();
+	const unsigned int* GetIndices();
+
+	static bool Write(const char* sourceFileName, const Vertex* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount, unsigned int sourceVertexCount, const MeshBounds& bounds, const CacheStats& cacheStats, uint32_t flags);
+
+	static const uint32_t Magic = 0x4348534D; // "MSHC"
+	static const uint32_t Version = 5;
+
+private:
+	static std::string GetCachePath(const char* sourceFileName);
+	static bool GetSourceStamp(const char* sourceFileName, uint64_t& size, uint64_t& writeTime);
+
+	MappedFile file;
+	const MeshCacheHeader* header;
+};
@@ -0,0 +1,88 @@
+#include "MeshData.h"
+#include "ObjParser.h"
+#include "TangentGenerator.h"
+#include <chrono>
+
+MeshData::MeshData(const char* fileName)
+{
+	this->fileName = fileName;
+	source = "obj";
+	loadMilliseconds = 0.0;
+	weldStats = {};
+	cacheStats = {};
+	bounds = {};
+}
+
+std::shared_ptr<MeshData> MeshData::Load(const char* fileName, bool optimizeVertexCache, unsigned int threadCount)
+{
+	std::chrono::high_resolution_clock::time_point loadStart = std::chrono::high_resolution_clock::now();
+	std::shared_ptr<MeshData> data(new MeshData(fileName));
+
+	// warm start: keep the cache mapped and point straight into it
+	uint32_t cacheFlags = (optimizeVertexCache ? MeshCacheOptimized : 0);
+	data->cache.reset(new MeshCache(fileName, cacheFlags));
+	if(data->cache->IsValid()) {
+		const MeshCacheHeader* header = data->cache->GetHeader();
+		data->source = "cache";
+		data->weldStats.originalVertexCount = header->sourceVertexCount;
+		data->weldStats.weldedVertexCount = header->vertexCount;
+		data->weldStats.bytesSaved = (data->weldStats.originalVertexCount - data->weldStats.weldedVertexCount) * sizeof(Vertex);
+		data->bounds = header->bounds;
+		data->cacheStats = header->cacheStats;
+	} else {
+		data->cache.reset();
+
+		// parse the memory mapped file in place
+		if(ObjParser::Load(fileName, data->vertices, data->indices, threadCount)) {
+			// share identical corners so the index buffer actually indexes something
+			data->weldStats = VertexWelder::Weld(data->vertices, data->indices);
+			Process(data->vertices.data(), data->GetVertexCount(), data->indices.data(), data->GetIndexCount(), optimizeVertexCache, data->cacheStats, data->bounds, threadCount);
+
+			// tangents and ordering are final now, so the next launch can skip all of the above
+			MeshCache::Write(fileName, data->vertices.data(), (unsigned int)data->vertices.size(), data->indices.data(), (unsigned int)data->indices.size(), (unsigned int)data->weldStats.originalVertexCount, data->bounds, data->cacheStats, cacheFlags);
+		}
+	}
+
+	data->loadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - loadStart).count();
+	return data;
+}
+
+void MeshData::Process(Vertex* vertices, int numVertices, unsigned int* indices, int numIndices, bool optimizeVertexCache, CacheStats& cacheStats, MeshBounds& bounds, unsigned int threadCount)
+{
+	bounds = BoundingVolumes::Compute(vertices, numVertices);
+
+	// reorder triangles for the post-transform cache, then vertices for fetch locality
+	if(optimizeVertexCache) {
+		cacheStats = VertexCacheOptimizer::Optimize(vertices, numVertices, indices, numIndices);
+	} else {
+		cacheStats.acmrBefore = cacheStats.acmrAfter = VertexCacheOptimizer::ComputeACMR(indices, numIndices, numVertices);
+		cacheStats.atvrBefore = cacheStats.atvrAfter = VertexCacheOptimizer::ComputeATVR(indices, numIndices, numVertices);
+	}
+
+	TangentGenerator::Generate(vertices, numVertices, indices, numIndices, threadCount);
+}
+
+bool MeshData::IsValid()
+{
+	return GetVertexCount() > 0 && GetIndexCount() > 0;
+}
+
+const Vertex* MeshData::GetVertices()
+{
+	return cache ? cache->GetVertices() : vertices.data();
+}
+
+const unsigned int* MeshData::GetIndices()
+{
+	return cache ? cache->GetIndices() : indices.data();
+}
+
+int MeshData::GetVertexCount()
+{
+	return cache ? (int)cache->GetHeader()->vertexCount : (int)vertices.size();
+}
+
+int MeshData::GetIndexCount()
+{
+	return cache ? (int)cache->GetHeader()->indexCount : (int)indices.size();
+}
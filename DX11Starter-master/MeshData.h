@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <string>
+#include "Vertex.h"
+#include "VertexWelder.h"
+#include "VertexCacheOptimizer.h"
+#include "BoundingVolumes.h"
+#include "MeshCache.h"
+
+// --------------------------------------------------------
+// A mesh as it is right before upload: welded, reordered,
+// tangents filled in, bounds computed. Load() does no D3D
+// work at all, so it is safe to call from a loader thread
+// (or from a headless test) and hand the result to Mesh.
+// --------------------------------------------------------
+class MeshData
+{
+public:
+	// threadCount is for parsing and tangents, 0 picks the core count
+	static std::shared_ptr<MeshData> Load(const char* fileName, bool optimizeVertexCache = true, unsigned int threadCount = 0);
+
+	// the in place part of Load(), shared with meshes built from raw arrays
+	static void Process(Vertex* vertices, int numVertices, unsigned int* indices, int numIndices, bool optimizeVertexCache, CacheStats& cacheStats, MeshBounds& bounds, unsigned int threadCount = 0);
+
+	bool IsValid();
+	const Vertex* GetVertices();
+	const unsigned int* GetIndices();
+	int GetVertexCount();
+	int GetIndexCount();
+
+	std::string fileName;
+	const char* source; // "cache" or "obj"
+	double loadMilliseconds;
+	WeldStats weldStats;
+	CacheStats cacheStats;
+	MeshBounds bounds;
+
+private:
+	MeshData(const char* fileName);
+
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	std::unique_ptr<MeshCache> cache; // when valid, the arrays live in the mapped cache instead
+};
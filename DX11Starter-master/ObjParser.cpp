@@ -0,0 +1,564 @@
+#include "ObjParser.h"
+#include "MappedFile.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <float.h>
+#include <string>
+#include <thread>
+using namespace DirectX;
+
+// exact powers of ten for doubles, anything past this goes through strtof
+static const double powersOfTen[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+bool ObjParser::Load(const char* fileName, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, unsigned int threadCount)
+{
+	MappedFile file(fileName);
+	if(!file.IsOpen()) {
+		return false;
+	}
+
+	if(file.GetSize() >= ParallelThreshold) {
+		return ParseParallel(file.GetData(), file.GetSize(), vertices, indices, threadCount);
+	}
+	return Parse(file.GetData(), file.GetSize(), vertices, indices);
+}
+
+bool ObjParser::Parse(const char* data, size_t size, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+	std::vector<XMFLOAT3> positions;
+	std::vector<XMFLOAT3> normals;
+	std::vector<XMFLOAT2> uvs;
+
+	// rough guess from typical line lengths to avoid most regrowth
+	positions.reserve(size / 96);
+	normals.reserve(size / 96);
+	uvs.reserve(size / 96);
+	vertices.reserve(size / 16);
+	indices.reserve(size / 16);
+
+	FaceCorner corners[MaxFaceCorners];
+	Vertex faceVerts[MaxFaceCorners];
+
+	const char* end = data + size;
+	const char* line = data;
+	while(line < end) {
+		const char* lineEnd;
+		const char* next = NextLine(line, end, lineEnd);
+
+		switch(ClassifyLine(line, lineEnd)) {
+		case LinePosition: {
+			XMFLOAT3 position;
+			const char* c = ParseFloat(line + 1, lineEnd, position.x);
+			c = ParseFloat(c, lineEnd, position.y);
+			ParseFloat(c, lineEnd, position.z);
+			positions.push_back(position);
+		}
+			break;
+
+		case LineUV: {
+			XMFLOAT2 uv;
+			const char* c = ParseFloat(line + 2, lineEnd, uv.x);
+			ParseFloat(c, lineEnd, uv.y);
+			uvs.push_back(uv);
+		}
+			break;
+
+		case LineNormal: {
+			XMFLOAT3 normal;
+			const char* c = ParseFloat(line + 2, lineEnd, normal.x);
+			c = ParseFloat(c, lineEnd, normal.y);
+			ParseFloat(c, lineEnd, normal.z);
+			normals.push_back(normal);
+		}
+			break;
+
+		case LineFace: {
+			int cornerCount = ParseFace(line, lineEnd, corners);
+			Attributes attributes = { positions.data(), positions.size(), uvs.data(), uvs.size(), normals.data(), normals.size() };
+			if(BuildFace(corners, cornerCount, attributes, faceVerts)) {
+				size_t firstVertex = vertices.size();
+				vertices.resize(firstVertex + (cornerCount - 2) * 3);
+				indices.resize(firstVertex + (cornerCount - 2) * 3);
+				EmitFace(faceVerts, cornerCount, vertices.data(), indices.data(), firstVertex);
+			}
+		}
+			break;
+
+		default:
+			break;
+		}
+
+		line = next;
+	}
+
+	return indices.size() > 0;
+}
+
+// --------------------------------------------------------
+// Parallel version of Parse(), in four passes over chunks
+// that start and end on line boundaries:
+//  1. count v/vt/vn/f records and face corners per chunk
+//  2. prefix sum the counts, then parse every chunk straight
+//     into preallocated attribute and face arrays
+//  3. count the triangles each chunk's faces really produce
+//     (a face can be rejected for an out of range index)
+//  4. prefix sum those and fill the vertex/index arrays
+// Each face remembers the attribute counts at its line, so
+// index resolution sees exactly what the serial parser saw.
+// --------------------------------------------------------
+bool ObjParser::ParseParallel(const char* data, size_t size, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, unsigned int threadCount)
+{
+	if(threadCount == 0) {
+		threadCount = std::thread::hardware_concurrency();
+	}
+	size_t maxUsefulThreads = size / (16 * 1024) + 1;
+	if(threadCount > maxUsefulThreads) {
+		threadCount = (unsigned int)maxUsefulThreads;
+	}
+	if(threadCount <= 1) {
+		return Parse(data, size, vertices, indices);
+	}
+
+	const char* end = data + size;
+
+	// split evenly, then push each split forward past the next newline
+	std::vector<const char*> bounds(threadCount + 1);
+	bounds[0] = data;
+	bounds[threadCount] = end;
+	for(unsigned int i = 1; i < threadCount; i++) {
+		const char* split = data + size * i / threadCount;
+		if(split < bounds[i - 1]) {
+			split = bounds[i - 1];
+		}
+		const char* newline = (const char*)memchr(split, '\n', end - split);
+		bounds[i] = (newline == nullptr ? end : newline + 1);
+	}
+
+	std::vector<std::thread> workers;
+	auto runChunks = [&](auto work) {
+		workers.clear();
+		for(unsigned int t = 0; t < threadCount; t++) {
+			workers.emplace_back(work, t);
+		}
+		for(std::thread& worker : workers) {
+			worker.join();
+		}
+	};
+
+	// pass 1: counts
+	std::vector<ChunkCounts> counts(threadCount);
+	runChunks([&](unsigned int t) {
+		ChunkCounts local = {};
+		FaceCorner corners[MaxFaceCorners];
+		const char* line = bounds[t];
+		while(line < bounds[t + 1]) {
+			const char* lineEnd;
+			const char* next = NextLine(line, end, lineEnd);
+			switch(ClassifyLine(line, lineEnd)) {
+			case LinePosition: local.positions++; break;
+			case LineUV: local.uvs++; break;
+			case LineNormal: local.normals++; break;
+			case LineFace:
+				local.faces++;
+				local.corners += ParseFace(line, lineEnd, corners);
+				break;
+			default: break;
+			}
+			line = next;
+		}
+		counts[t] = local;
+	});
+
+	std::vector<ChunkCounts> offsets(threadCount);
+	ChunkCounts totals = {};
+	for(unsigned int t = 0; t < threadCount; t++) {
+		offsets[t] = totals;
+		totals.positions += counts[t].positions;
+		totals.uvs += counts[t].uvs;
+		totals.normals += counts[t].normals;
+		totals.faces += counts[t].faces;
+		totals.corners += counts[t].corners;
+	}
+
+	// pass 2: fill attributes and raw faces at the chunk offsets
+	std::vector<XMFLOAT3> positions(totals.positions);
+	std::vector<XMFLOAT2> uvs(totals.uvs);
+	std::vector<XMFLOAT3> normals(totals.normals);
+	std::vector<FaceRecord> faces(totals.faces);
+	std::vector<FaceCorner> corners(totals.corners);
+	runChunks([&](unsigned int t) {
+		ChunkCounts cursor = offsets[t];
+		const char* line = bounds[t];
+		while(line < bounds[t + 1]) {
+			const char* lineEnd;
+			const char* next = NextLine(line, end, lineEnd);
+			switch(ClassifyLine(line, lineEnd)) {
+			case LinePosition: {
+				XMFLOAT3& position = positions[cursor.positions++];
+				const char* c = ParseFloat(line + 1, lineEnd, position.x);
+				c = ParseFloat(c, lineEnd, position.y);
+				ParseFloat(c, lineEnd, position.z);
+			}
+				break;
+
+			case LineUV: {
+				XMFLOAT2& uv = uvs[cursor.uvs++];
+				const char* c = ParseFloat(line + 2, lineEnd, uv.x);
+				ParseFloat(c, lineEnd, uv.y);
+			}
+				break;
+
+			case LineNormal: {
+				XMFLOAT3& normal = normals[cursor.normals++];
+				const char* c = ParseFloat(line + 2, lineEnd, normal.x);
+				c = ParseFloat(c, lineEnd, normal.y);
+				ParseFloat(c, lineEnd, normal.z);
+			}
+				break;
+
+			case LineFace: {
+				FaceRecord& face = faces[cursor.faces++];
+				face.firstCorner = cursor.corners;
+				face.cornerCount = ParseFace(line, lineEnd, corners.data() + cursor.corners);
+				face.positionCount = cursor.positions;
+				face.uvCount = cursor.uvs;
+				face.normalCount = cursor.normals;
+				cursor.corners += face.cornerCount;
+			}
+				break;
+
+			default:
+				break;
+			}
+			line = next;
+		}
+	});
+
+	// pass 3: triangles per chunk, rejected faces produce none
+	runChunks([&](unsigned int t) {
+		size_t triangles = 0;
+		for(size_t f = offsets[t].faces; f < offsets[t].faces + counts[t].faces; f++) {
+			const FaceRecord& face = faces[f];
+			Attributes attributes = { positions.data(), face.positionCount, uvs.data(), face.uvCount, normals.data(), face.normalCount };
+			if(IsFaceValid(corners.data() + face.firstCorner, face.cornerCount, attributes)) {
+				triangles += face.cornerCount - 2;
+			}
+		}
+		counts[t].triangles = triangles;
+	});
+
+	size_t totalTriangles = 0;
+	for(unsigned int t = 0; t < threadCount; t++) {
+		offsets[t].triangles = totalTriangles;
+		totalTriangles += counts[t].triangles;
+	}
+
+	// pass 4: emit the triangles at their final offsets
+	vertices.resize(totalTriangles * 3);
+	indices.resize(totalTriangles * 3);
+	runChunks([&](unsigned int t) {
+		Vertex faceVerts[MaxFaceCorners];
+		size_t nextVertex = offsets[t].triangles * 3;
+		for(size_t f = offsets[t].faces; f < offsets[t].faces + counts[t].faces; f++) {
+			const FaceRecord& face = faces[f];
+			Attributes attributes = { positions.data(), face.positionCount, uvs.data(), face.uvCount, normals.data(), face.normalCount };
+			if(BuildFace(corners.data() + face.firstCorner, face.cornerCount, attributes, faceVerts)) {
+				EmitFace(faceVerts, face.cornerCount, vertices.data(), indices.data(), nextVertex);
+				nextVertex += (face.cornerCount - 2) * 3;
+			}
+		}
+	});
+
+	return indices.size() > 0;
+}
+
+// finds the end of this line (minus any '\r') and returns the start of the next
+const char* ObjParser::NextLine(const char* line, const char* end, const char*& lineEnd)
+{
+	lineEnd = (const char*)memchr(line, '\n', end - line);
+	if(lineEnd == nullptr) {
+		lineEnd = end;
+	}
+	const char* next = lineEnd + 1;
+	if(lineEnd > line && lineEnd[-1] == '\r') {
+		lineEnd--;
+	}
+	return next;
+}
+
+ObjParser::LineType ObjParser::ClassifyLine(const char* line, const char* lineEnd)
+{
+	if(lineEnd - line < 2) {
+		return LineOther;
+	}
+
+	if(line[0] == 'v') {
+		if(line[1] == 'n') {
+			return LineNormal;
+		}
+		if(line[1] == 't') {
+			return LineUV;
+		}
+		if(line[1] == ' ' || line[1] == '\t') {
+			return LinePosition;
+		}
+	}
+	else if(line[0] == 'f' && (line[1] == ' ' || line[1] == '\t')) {
+		return LineFace;
+	}
+
+	return LineOther;
+}
+
+// reads up to MaxFaceCorners corners from an "f" line, returns how many were read
+int ObjParser::ParseFace(const char* line, const char* lineEnd, FaceCorner* corners)
+{
+	int cornerCount = 0;
+	const char* c = SkipSpaces(line + 1, lineEnd);
+	while(c < lineEnd && cornerCount < MaxFaceCorners) {
+		// parse into a local so a bad corner doesn't write past the ones
+		// counted, in the parallel path that slot belongs to the next face
+		FaceCorner corner;
+		c = ParseCorner(c, lineEnd, corner);
+		if(c == nullptr) {
+			break;
+		}
+		corners[cornerCount++] = corner;
+		c = SkipSpaces(c, lineEnd);
+	}
+	return cornerCount;
+}
+
+// --------------------------------------------------------
+// A face is skipped if it has fewer than 3 corners or any
+// index is out of range for the attributes read so far
+// --------------------------------------------------------
+bool ObjParser::IsFaceValid(const FaceCorner* corners, int cornerCount, const Attributes& attributes)
+{
+	if(cornerCount < 3) {
+		return false;
+	}
+
+	for(int i = 0; i < cornerCount; i++) {
+		if(ResolveIndex(corners[i].position, attributes.positionCount) < 0
+			|| (corners[i].uv != 0 && ResolveIndex(corners[i].uv, attributes.uvCount) < 0)
+			|| (corners[i].normal != 0 && ResolveIndex(corners[i].normal, attributes.normalCount) < 0)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// looks up every corner of a valid face and converts it to a left handed vertex
+bool ObjParser::BuildFace(const FaceCorner* corners, int cornerCount, const Attributes& attributes, Vertex* faceVerts)
+{
+	if(!IsFaceValid(corners, cornerCount, attributes)) {
+		return false;
+	}
+
+	for(int i = 0; i < cornerCount; i++) {
+		int p = ResolveIndex(corners[i].position, attributes.positionCount);
+		int t = ResolveIndex(corners[i].uv, attributes.uvCount);
+		int n = ResolveIndex(corners[i].normal, attributes.normalCount);
+
+		// the old loader read a missing uv as index 1, which is
+		// the first uv in the file or (0, 0) if there are none
+		Vertex& vert = faceVerts[i];
+		vert.Position = attributes.positions[p];
+		vert.UV = (t >= 0 ? attributes.uvs[t] : (attributes.uvCount > 0 ? attributes.uvs[0] : XMFLOAT2(0, 0)));
+		vert.Normal = (n >= 0 ? attributes.normals[n] : XMFLOAT3(0, 0, 0));
+		vert.Tangent = XMFLOAT3(0, 0, 0);
+
+		// convert from right handed to left handed and flip the uv upside down
+		vert.UV.y = 1.0f - vert.UV.y;
+		vert.Position.z *= -1.0f;
+		vert.Normal.z *= -1.0f;
+	}
+
+	return true;
+}
+
+// fan triangulates with the winding flipped, which matches
+// the old (v1, v3, v2) (v1, v4, v3) order for quads
+void ObjParser::EmitFace(const Vertex* faceVerts, int cornerCount, Vertex* vertices, unsigned int* indices, size_t firstVertex)
+{
+	size_t v = firstVertex;
+	for(int i = 2; i < cornerCount; i++) {
+		vertices[v] = faceVerts[0];
+		vertices[v + 1] = faceVerts[i];
+		vertices[v + 2] = faceVerts[i - 1];
+		indices[v] = (unsigned int)v;
+		indices[v + 1] = (unsigned int)(v + 1);
+		indices[v + 2] = (unsigned int)(v + 2);
+		v += 3;
+	}
+}
+
+const char* ObjParser::SkipSpaces(const char* c, const char* end)
+{
+	while(c < end && (*c == ' ' || *c == '\t')) {
+		c++;
+	}
+	return c;
+}
+
+// --------------------------------------------------------
+// Reads a decimal float such as "-0.923880" or "1.5e-05".
+// Plain decimals are assembled from an integer mantissa and
+// an exact power of ten in double, which is one correct
+// rounding. Narrowing that to float is a second rounding and
+// only differs from strtof when the double lands exactly
+// halfway between two floats, so those (and anything long,
+// huge or denormal) fall back to strtof.
+// --------------------------------------------------------
+const char* ObjParser::ParseFloat(const char* c, const char* end, float& result)
+{
+	c = SkipSpaces(c, end);
+	const char* start = c;
+
+	bool negative = false;
+	if(c < end && (*c == '-' || *c == '+')) {
+		negative = (*c == '-');
+		c++;
+	}
+
+	uint64_t mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	bool any = false;
+	while(c < end && *c >= '0' && *c <= '9') {
+		if(digits < 19) {
+			mantissa = mantissa * 10 + (*c - '0');
+			if(mantissa > 0) {
+				digits++;
+			}
+		} else {
+			exponent++;
+		}
+		any = true;
+		c++;
+	}
+	if(c < end && *c == '.') {
+		c++;
+		while(c < end && *c >= '0' && *c <= '9') {
+			if(digits < 19) {
+				mantissa = mantissa * 10 + (*c - '0');
+				if(mantissa > 0) {
+					digits++;
+				}
+				exponent--;
+			}
+			any = true;
+			c++;
+		}
+	}
+	if(!any) {
+		result = 0.0f;
+		return c;
+	}
+	if(c < end && (*c == 'e' || *c == 'E')) {
+		int power = 0;
+		const char* afterExponent = ParseInt(c + 1, end, power);
+		if(afterExponent != c + 1) {
+			// ParseInt saturates, keep the sum from overflowing too
+			if(power > 100000) {
+				power = 100000;
+			} else if(power < -100000) {
+				power = -100000;
+			}
+			exponent += power;
+			c = afterExponent;
+		}
+	}
+
+	if(mantissa < (1ull << 53) && exponent >= -22 && exponent <= 22) {
+		double value = (double)mantissa;
+		value = (exponent < 0 ? value / powersOfTen[-exponent] : value * powersOfTen[exponent]);
+
+		// a normal float keeps the top 23 of the double's 52 fraction bits,
+		// the dropped 29 being exactly 1000...0 means a float midpoint
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		if(value == 0.0 || (value >= FLT_MIN && value <= FLT_MAX && (bits & 0x1FFFFFFF) != 0x10000000)) {
+			result = (float)(negative ? -value : value);
+			return c;
+		}
+	}
+
+	// rare slow path, the mapped view is not null terminated so copy the token
+	char token[128];
+	size_t length = c - start;
+	if(length < sizeof(token)) {
+		memcpy(token, start, length);
+		token[length] = '\0';
+		result = strtof(token, nullptr);
+	} else {
+		result = strtof(std::string(start, length).c_str(), nullptr);
+	}
+	return c;
+}
+
+const char* ObjParser::ParseInt(const char* c, const char* end, int& result)
+{
+	bool negative = false;
+	if(c < end && (*c == '-' || *c == '+')) {
+		negative = (*c == '-');
+		c++;
+	}
+
+	// saturates instead of overflowing, which is out of range for any index
+	int value = 0;
+	while(c < end && *c >= '0' && *c <= '9') {
+		int digit = *c - '0';
+		value = (value > (INT_MAX - digit) / 10 ? INT_MAX : value * 10 + digit);
+		c++;
+	}
+
+	result = (negative ? -value : value);
+	return c;
+}
+
+// --------------------------------------------------------
+// Reads one face corner in any of the OBJ forms:
+// "v", "v/vt", "v//vn" or "v/vt/vn". Missing parts are 0.
+// Returns null if the corner is not a number.
+// --------------------------------------------------------
+const char* ObjParser::ParseCorner(const char* c, const char* end, FaceCorner& corner)
+{
+	corner.position = 0;
+	corner.uv = 0;
+	corner.normal = 0;
+
+	const char* after = ParseInt(c, end, corner.position);
+	if(after == c || corner.position == 0) {
+		return nullptr;
+	}
+	c = after;
+
+	if(c < end && *c == '/') {
+		c = ParseInt(c + 1, end, corner.uv);
+		if(c < end && *c == '/') {
+			c = ParseInt(c + 1, end, corner.normal);
+		}
+	}
+
+	return c;
+}
+
+// converts a 1-based (or negative, relative) OBJ index to a 0-based one, -1 if invalid
+int ObjParser::ResolveIndex(int index, size_t count)
+{
+	if(index > 0 && (size_t)index <= count) {
+		return index - 1;
+	}
+	if(index < 0 && (size_t)(-index) <= count) {
+		return (int)count + index;
+	}
+	return -1;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <vector>
+#include <stddef.h>
+#include "Vertex.h"
+
+// Wavefront OBJ loader that tokenizes a memory mapped file in place.
+// Produces the same left-handed, unwelded triangle list as the original
+// getline/sscanf loader in Mesh, without a line length limit.
+class ObjParser
+{
+public:
+	static bool Load(const char* fileName, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, unsigned int threadCount = 0);
+	static bool Parse(const char* data, size_t size, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+	// splits the file at line boundaries and parses the chunks on several
+	// threads, output is bit-identical to Parse(). 0 threads picks the core count
+	static bool ParseParallel(const char* data, size_t size, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, unsigned int threadCount = 0);
+
+	// files at least this big are parsed in parallel by Load(), unless it's given 1 thread
+	static const size_t ParallelThreshold = 256 * 1024;
+
+private:
+	enum LineType { LineOther, LinePosition, LineUV, LineNormal, LineFace };
+
+	struct FaceCorner
+	{
+		int position;
+		int uv;
+		int normal;
+	};
+
+	// attribute arrays as they were when a face was read, since OBJ
+	// indices (and relative ones especially) depend on that point
+	struct Attributes
+	{
+		const DirectX::XMFLOAT3* positions;
+		size_t positionCount;
+		const DirectX::XMFLOAT2* uvs;
+		size_t uvCount;
+		const DirectX::XMFLOAT3* normals;
+		size_t normalCount;
+	};
+
+	struct ChunkCounts
+	{
+		size_t positions;
+		size_t uvs;
+		size_t normals;
+		size_t faces;
+		size_t corners;
+		size_t triangles;
+	};
+
+	struct FaceRecord
+	{
+		size_t firstCorner;
+		int cornerCount;
+		size_t positionCount;
+		size_t uvCount;
+		size_t normalCount;
+	};
+
+	static const int MaxFaceCorners = 64;
+
+	static const char* NextLine(const char* line, const char* end, const char*& lineEnd);
+	static LineType ClassifyLine(const char* line, const char* lineEnd);
+	static int ParseFace(const char* line, const char* lineEnd, FaceCorner* corners);
+	static bool IsFaceValid(const FaceCorner* corners, int cornerCount, const Attributes& attributes);
+	static bool BuildFace(const FaceCorner* corners, int cornerCount, const Attributes& attributes, Vertex* faceVerts);
+	static void EmitFace(const Vertex* faceVerts, int cornerCount, Vertex* vertices, unsigned int* indices, size_t firstVertex);
+
+	static const char* SkipSpaces(const char* c, const char* end);
+	static const char* ParseFloat(const char* c, const char* end, float& result);
+	static const char* ParseInt(const char* c, const char* end, int& result);
+	static const char* ParseCorner(const char* c, const char* end, FaceCorner& corner);
+	static int ResolveIndex(int index, size_t count);
+};
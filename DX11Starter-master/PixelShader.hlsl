@@ -1,16 +1,21 @@
 #include "ShaderStructs.hlsli"
 #include "Lighting.hlsli"
 
-cbuffer ExternalData : register(b0) {
-	float4 colorTint;
+// set once per frame by Game::Draw
+cbuffer PerFrame : register(b0) {
 	float3 cameraPosition;
-	float roughness;
-	float uvScale;
 	float3 ambient;
 	Light directionalLight;
 	Light ballLight;
 }
 
+// only changes when the material does
+cbuffer PerMaterial : register(b1) {
+	float4 colorTint;
+	float roughness;
+	float uvScale;
+}
+
 Texture2D Albedo : register(t0);
 Texture2D NormalMap : register(t1);
 Texture2D RoughnessMap : register(t2);
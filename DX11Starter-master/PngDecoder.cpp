@@ -0,0 +1,508 @@
+#include "PngDecoder.h"
+#include <string.h>
+
+// deflate's length and distance codes, base value and extra bits
+static const uint16_t lengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t distanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const uint8_t distanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+// the order a dynamic block sends its code length code lengths in
+static const uint8_t codeLengthOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+// the biggest texture D3D11 can create, anything past it is a bad header
+static const unsigned int maxDimension = 16384;
+
+bool PngDecoder::Decode(const unsigned char* data, size_t size, unsigned int& width, unsigned int& height, std::vector<unsigned char>& pixels)
+{
+	static const unsigned char signature[8] = { 137, 'P', 'N', 'G', 13, 10, 26, 10 };
+	if(size < 8 || memcmp(data, signature, 8) != 0) {
+		return false;
+	}
+
+	unsigned int imageWidth = 0;
+	unsigned int imageHeight = 0;
+	unsigned int bitDepth = 0;
+	unsigned int colorType = 0;
+	unsigned char palette[256][4];
+	unsigned int paletteSize = 0;
+	bool hasColorKey = false;
+	unsigned int colorKey[3] = {};
+	std::vector<unsigned char> compressed;
+
+	size_t position = 8;
+	bool ended = false;
+	while(!ended) {
+		if(size - position < 12) {
+			return false;
+		}
+		uint32_t length = ReadBigEndian(data + position);
+		const unsigned char* type = data + position + 4;
+		const unsigned char* chunk = data + position + 8;
+		if(length > size - position - 12) {
+			return false;
+		}
+		position += 12 + (size_t)length;
+
+		if(memcmp(type, "IHDR", 4) == 0) {
+			if(length != 13) {
+				return false;
+			}
+			imageWidth = ReadBigEndian(chunk);
+			imageHeight = ReadBigEndian(chunk + 4);
+			bitDepth = chunk[8];
+			colorType = chunk[9];
+			bool validDepth;
+			switch(colorType) {
+			case 0: validDepth = bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8 || bitDepth == 16; break;
+			case 3: validDepth = bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8; break;
+			case 2: case 4: case 6: validDepth = bitDepth == 8 || bitDepth == 16; break;
+			default: validDepth = false; break;
+			}
+			// compression and filter method 0 are the only ones there are, and no Adam7
+			if(!validDepth || chunk[10] != 0 || chunk[11] != 0 || chunk[12] != 0
+				|| imageWidth == 0 || imageHeight == 0 || imageWidth > maxDimension || imageHeight > maxDimension) {
+				return false;
+			}
+		}
+		else if(memcmp(type, "PLTE", 4) == 0) {
+			if(length % 3 != 0 || length > 256 * 3) {
+				return false;
+			}
+			paletteSize = length / 3;
+			for(unsigned int i = 0; i < paletteSize; i++) {
+				palette[i][0] = chunk[i * 3];
+				palette[i][1] = chunk[i * 3 + 1];
+				palette[i][2] = chunk[i * 3 + 2];
+				palette[i][3] = 255;
+			}
+		}
+		else if(memcmp(type, "tRNS", 4) == 0) {
+			if(colorType == 3) {
+				for(unsigned int i = 0; i < length && i < paletteSize; i++) {
+					palette[i][3] = chunk[i];
+				}
+			} else if(colorType == 0 && length >= 2) {
+				hasColorKey = true;
+				colorKey[0] = (chunk[0] << 8) | chunk[1];
+			} else if(colorType == 2 && length >= 6) {
+				hasColorKey = true;
+				for(int c = 0; c < 3; c++) {
+					colorKey[c] = (chunk[c * 2] << 8) | chunk[c * 2 + 1];
+				}
+			}
+		}
+		else if(memcmp(type, "IDAT", 4) == 0) {
+			compressed.insert(compressed.end(), chunk, chunk + length);
+		}
+		else if(memcmp(type, "IEND", 4) == 0) {
+			ended = true;
+		}
+	}
+	if(imageWidth == 0 || compressed.empty() || (colorType == 3 && paletteSize == 0)) {
+		return false;
+	}
+
+	static const unsigned int channelsByType[7] = { 1, 0, 3, 1, 2, 0, 4 };
+	unsigned int channels = channelsByType[colorType];
+	unsigned int bitsPerPixel = channels * bitDepth;
+	size_t rowBytes = ((size_t)imageWidth * bitsPerPixel + 7) / 8;
+	size_t scanlineSize = (rowBytes + 1) * imageHeight;
+
+	std::vector<unsigned char> scanlines;
+	if(!Inflate(compressed.data(), compressed.size(), scanlineSize, scanlines) || scanlines.size() != scanlineSize) {
+		return false;
+	}
+	if(!Unfilter(scanlines.data(), imageHeight, rowBytes, bitsPerPixel >= 8 ? bitsPerPixel / 8 : 1)) {
+		return false;
+	}
+
+	// expand whatever this is to RGBA8
+	std::vector<unsigned char> rgba((size_t)imageWidth * imageHeight * 4);
+	unsigned int maxSample = (1u << bitDepth) - 1;
+	for(unsigned int y = 0; y < imageHeight; y++) {
+		const unsigned char* row = scanlines.data() + y * (rowBytes + 1) + 1;
+		unsigned char* out = rgba.data() + (size_t)y * imageWidth * 4;
+		for(unsigned int x = 0; x < imageWidth; x++, out += 4) {
+			unsigned int samples[4];
+			for(unsigned int c = 0; c < channels; c++) {
+				size_t index = (size_t)x * channels + c;
+				if(bitDepth == 16) {
+					samples[c] = (row[index * 2] << 8) | row[index * 2 + 1];
+				} else if(bitDepth == 8) {
+					samples[c] = row[index];
+				} else {
+					size_t bit = index * bitDepth;
+					samples[c] = (row[bit / 8] >> (8 - bitDepth - bit % 8)) & maxSample;
+				}
+			}
+
+			if(colorType == 3) {
+				if(samples[0] >= paletteSize) {
+					return false;
+				}
+				memcpy(out, palette[samples[0]], 4);
+				continue;
+			}
+
+			unsigned char scaled[4];
+			for(unsigned int c = 0; c < channels; c++) {
+				scaled[c] = (unsigned char)(bitDepth == 16 ? (samples[c] * 255 + 32767) / 65535 : samples[c] * 255 / maxSample);
+			}
+			switch(colorType) {
+			case 0:
+				out[0] = out[1] = out[2] = scaled[0];
+				out[3] = (hasColorKey && samples[0] == (colorKey[0] & maxSample) ? 0 : 255);
+				break;
+			case 2:
+				out[0] = scaled[0];
+				out[1] = scaled[1];
+				out[2] = scaled[2];
+				out[3] = (hasColorKey && samples[0] == colorKey[0] && samples[1] == colorKey[1] && samples[2] == colorKey[2] ? 0 : 255);
+				break;
+			case 4:
+				out[0] = out[1] = out[2] = scaled[0];
+				out[3] = scaled[1];
+				break;
+			default:
+				memcpy(out, scaled, 4);
+				break;
+			}
+		}
+	}
+
+	width = imageWidth;
+	height = imageHeight;
+	pixels.swap(rgba);
+	return true;
+}
+
+bool PngDecoder::Inflate(const unsigned char* data, size_t size, size_t maxSize, std::vector<unsigned char>& output)
+{
+	// zlib header: deflate with a window of at most 32k, no preset dictionary
+	if(size < 2 || (data[0] & 0x0F) != 8 || (data[0] >> 4) > 7 || ((data[0] << 8) | data[1]) % 31 != 0 || (data[1] & 0x20) != 0) {
+		return false;
+	}
+
+	static const std::vector<uint16_t> fixedLengthTable = []() {
+		uint8_t lengths[288];
+		memset(lengths, 8, 144);
+		memset(lengths + 144, 9, 112);
+		memset(lengths + 256, 7, 24);
+		memset(lengths + 280, 8, 8);
+		std::vector<uint16_t> table;
+		BuildTable(lengths, 288, table);
+		return table;
+	}();
+	static const std::vector<uint16_t> fixedDistanceTable = []() {
+		uint8_t lengths[30];
+		memset(lengths, 5, 30);
+		std::vector<uint16_t> table;
+		BuildTable(lengths, 30, table);
+		return table;
+	}();
+
+	BitReader bits = { data + 2, size - 2, 0, 0, 0, 0, false };
+	std::vector<uint16_t> lengthTable;
+	std::vector<uint16_t> distanceTable;
+	output.clear();
+	output.reserve(maxSize);
+
+	bool last = false;
+	while(!last) {
+		last = bits.Read(1) != 0;
+		unsigned int blockType = bits.Read(2);
+		if(blockType == 0) {
+			// stored: skip to the byte boundary, then a length and its complement
+			bits.Skip(bits.count % 8);
+			unsigned int length = bits.Read(16);
+			unsigned int complement = bits.Read(16);
+			if((length ^ 0xFFFF) != complement || output.size() + length > maxSize) {
+				return false;
+			}
+			for(unsigned int i = 0; i < length; i++) {
+				output.push_back((unsigned char)bits.Read(8));
+			}
+		}
+		else if(blockType == 1) {
+			if(!InflateCodes(bits, fixedLengthTable, fixedDistanceTable, maxSize, output)) {
+				return false;
+			}
+		}
+		else if(blockType == 2) {
+			if(!ReadDynamicTables(bits, lengthTable, distanceTable) || !InflateCodes(bits, lengthTable, distanceTable, maxSize, output)) {
+				return false;
+			}
+		}
+		else {
+			return false;
+		}
+
+		if(bits.overrun) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void PngDecoder::BitReader::Refill()
+{
+	while(count <= 56) {
+		if(position < size) {
+			buffer |= (uint64_t)data[position] << count;
+		} else {
+			padding += 8;
+		}
+		position++;
+		count += 8;
+	}
+}
+
+unsigned int PngDecoder::BitReader::Peek(int bits)
+{
+	if(count < bits) {
+		Refill();
+	}
+	return (unsigned int)(buffer & ((1ull << bits) - 1));
+}
+
+// the zero padding is always the newest bits, so eating into it means the data ran out
+void PngDecoder::BitReader::Skip(int bits)
+{
+	buffer >>= bits;
+	count -= bits;
+	if(count < padding) {
+		overrun = true;
+	}
+}
+
+unsigned int PngDecoder::BitReader::Read(int bits)
+{
+	unsigned int value = Peek(bits);
+	Skip(bits);
+	return value;
+}
+
+// --------------------------------------------------------
+// Canonical Huffman codes from their lengths. Deflate sends
+// codes most significant bit first inside an LSB first
+// stream, so each code is reversed and then repeated for
+// every value of the bits after it.
+// --------------------------------------------------------
+bool PngDecoder::BuildTable(const uint8_t* lengths, int count, std::vector<uint16_t>& table)
+{
+	int lengthCounts[MaxCodeBits + 1] = {};
+	for(int i = 0; i < count; i++) {
+		lengthCounts[lengths[i]]++;
+	}
+	lengthCounts[0] = 0;
+
+	// more codes than the lengths have room for is an error, fewer is allowed
+	int left = 1;
+	int nextCode[MaxCodeBits + 1] = {};
+	for(int length = 1; length <= MaxCodeBits; length++) {
+		left = (left << 1) - lengthCounts[length];
+		if(left < 0) {
+			return false;
+		}
+		nextCode[length] = (nextCode[length - 1] + lengthCounts[length - 1]) << 1;
+	}
+
+	table.assign(1 << MaxCodeBits, 0);
+	for(int symbol = 0; symbol < count; symbol++) {
+		int length = lengths[symbol];
+		if(length == 0) {
+			continue;
+		}
+		unsigned int code = nextCode[length]++;
+		unsigned int reversed = 0;
+		for(int bit = 0; bit < length; bit++) {
+			reversed = (reversed << 1) | ((code >> bit) & 1);
+		}
+		for(unsigned int index = reversed; index < table.size(); index += 1u << length) {
+			table[index] = (uint16_t)((symbol << 4) | length);
+		}
+	}
+	return true;
+}
+
+int PngDecoder::DecodeSymbol(BitReader& bits, const std::vector<uint16_t>& table)
+{
+	uint16_t entry = table[bits.Peek(MaxCodeBits)];
+	if(entry == 0) {
+		return -1;
+	}
+	bits.Skip(entry & 15);
+	return entry >> 4;
+}
+
+bool PngDecoder::ReadDynamicTables(BitReader& bits, std::vector<uint16_t>& lengthTable, std::vector<uint16_t>& distanceTable)
+{
+	unsigned int lengthCount = bits.Read(5) + 257;
+	unsigned int distanceCount = bits.Read(5) + 1;
+	unsigned int codeLengthCount = bits.Read(4) + 4;
+	if(lengthCount > 286 || distanceCount > 30) {
+		return false;
+	}
+
+	uint8_t codeLengthLengths[19] = {};
+	for(unsigned int i = 0; i < codeLengthCount; i++) {
+		codeLengthLengths[codeLengthOrder[i]] = (uint8_t)bits.Read(3);
+	}
+	std::vector<uint16_t> codeLengthTable;
+	if(!BuildTable(codeLengthLengths, 19, codeLengthTable)) {
+		return false;
+	}
+
+	// both alphabets' lengths come as one run length coded list
+	uint8_t lengths[286 + 30];
+	unsigned int total = lengthCount + distanceCount;
+	unsigned int i = 0;
+	while(i < total) {
+		int symbol = DecodeSymbol(bits, codeLengthTable);
+		if(symbol < 0 || bits.overrun) {
+			return false;
+		}
+		if(symbol < 16) {
+			lengths[i++] = (uint8_t)symbol;
+			continue;
+		}
+
+		uint8_t value = 0;
+		unsigned int repeat;
+		if(symbol == 16) {
+			if(i == 0) {
+				return false;
+			}
+			value = lengths[i - 1];
+			repeat = 3 + bits.Read(2);
+		} else if(symbol == 17) {
+			repeat = 3 + bits.Read(3);
+		} else {
+			repeat = 11 + bits.Read(7);
+		}
+		if(i + repeat > total) {
+			return false;
+		}
+		memset(lengths + i, value, repeat);
+		i += repeat;
+	}
+
+	// a block with no end of block code could never finish
+	return lengths[256] != 0
+		&& BuildTable(lengths, lengthCount, lengthTable)
+		&& BuildTable(lengths + lengthCount, distanceCount, distanceTable);
+}
+
+bool PngDecoder::InflateCodes(BitReader& bits, const std::vector<uint16_t>& lengthTable, const std::vector<uint16_t>& distanceTable, size_t maxSize, std::vector<unsigned char>& output)
+{
+	while(true) {
+		int symbol = DecodeSymbol(bits, lengthTable);
+		if(symbol < 0 || bits.overrun) {
+			return false;
+		}
+		if(symbol < 256) {
+			if(output.size() >= maxSize) {
+				return false;
+			}
+			output.push_back((unsigned char)symbol);
+			continue;
+		}
+		if(symbol == 256) {
+			return true;
+		}
+
+		symbol -= 257;
+		if(symbol >= 29) {
+			return false;
+		}
+		size_t length = lengthBase[symbol] + bits.Read(lengthExtra[symbol]);
+
+		int distanceSymbol = DecodeSymbol(bits, distanceTable);
+		if(distanceSymbol < 0 || distanceSymbol >= 30) {
+			return false;
+		}
+		size_t distance = distanceBase[distanceSymbol] + bits.Read(distanceExtra[distanceSymbol]);
+		if(distance > output.size() || output.size() + length > maxSize) {
+			return false;
+		}
+
+		// byte at a time, a match can overlap the bytes it is producing
+		size_t from = output.size() - distance;
+		for(size_t i = 0; i < length; i++) {
+			output.push_back(output[from + i]);
+		}
+	}
+}
+
+// --------------------------------------------------------
+// Undoes the per scanline filters in place. Each row is a
+// filter type byte and rowBytes of data, and predicts from
+// the byte filterStride back (the previous pixel) and the
+// row above, which count as zero off the edges.
+// --------------------------------------------------------
+bool PngDecoder::Unfilter(unsigned char* scanlines, unsigned int height, size_t rowBytes, unsigned int filterStride)
+{
+	std::vector<unsigned char> zeroRow(rowBytes, 0);
+	const unsigned char* above = zeroRow.data();
+
+	for(unsigned int y = 0; y < height; y++) {
+		unsigned char filter = scanlines[y * (rowBytes + 1)];
+		unsigned char* row = scanlines + y * (rowBytes + 1) + 1;
+
+		switch(filter) {
+		case 0: // none
+			break;
+
+		case 1: // sub
+			for(size_t i = filterStride; i < rowBytes; i++) {
+				row[i] = (unsigned char)(row[i] + row[i - filterStride]);
+			}
+			break;
+
+		case 2: // up
+			for(size_t i = 0; i < rowBytes; i++) {
+				row[i] = (unsigned char)(row[i] + above[i]);
+			}
+			break;
+
+		case 3: // average
+			for(size_t i = 0; i < rowBytes; i++) {
+				int left = (i >= filterStride ? row[i - filterStride] : 0);
+				row[i] = (unsigned char)(row[i] + ((left + above[i]) >> 1));
+			}
+			break;
+
+		case 4: // paeth, whichever neighbour is closest to left + above - upper left
+			for(size_t i = 0; i < rowBytes; i++) {
+				int left = (i >= filterStride ? row[i - filterStride] : 0);
+				int upperLeft = (i >= filterStride ? above[i - filterStride] : 0);
+				int estimate = left + above[i] - upperLeft;
+				int distanceLeft = estimate > left ? estimate - left : left - estimate;
+				int distanceAbove = estimate > above[i] ? estimate - above[i] : above[i] - estimate;
+				int distanceUpperLeft = estimate > upperLeft ? estimate - upperLeft : upperLeft - estimate;
+				int predictor;
+				if(distanceLeft <= distanceAbove && distanceLeft <= distanceUpperLeft) {
+					predictor = left;
+				} else if(distanceAbove <= distanceUpperLeft) {
+					predictor = above[i];
+				} else {
+					predictor = upperLeft;
+				}
+				row[i] = (unsigned char)(row[i] + predictor);
+			}
+			break;
+
+		default:
+			return false;
+		}
+
+		above = row;
+	}
+	return true;
+}
+
+uint32_t PngDecoder::ReadBigEndian(const unsigned char* bytes)
+{
+	return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+}
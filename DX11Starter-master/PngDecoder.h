@@ -0,0 +1,53 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// --------------------------------------------------------
+// PNG reader for platforms without WIC. Reads every
+// non-interlaced color type and bit depth and expands it to
+// 8 bit RGBA like WIC's format converter: 16 bit channels
+// are rounded to 8, low bit depths are scaled up and tRNS
+// becomes alpha. CRCs, the zlib checksum and ancillary
+// chunks (gamma, ICC profiles) are not checked or applied.
+// --------------------------------------------------------
+class PngDecoder
+{
+public:
+	// false, with the outputs untouched, for anything it can't read
+	static bool Decode(const unsigned char* data, size_t size, unsigned int& width, unsigned int& height, std::vector<unsigned char>& pixels);
+
+	// zlib stream to bytes, fails rather than produce more than maxSize
+	static bool Inflate(const unsigned char* data, size_t size, size_t maxSize, std::vector<unsigned char>& output);
+
+private:
+	static const int MaxCodeBits = 15;
+
+	// LSB first, like deflate packs them. Reads past the end come back as zeros
+	// and set overrun, which the callers check once per block or symbol
+	struct BitReader
+	{
+		const unsigned char* data;
+		size_t size;
+		size_t position;
+		uint64_t buffer;
+		int count; // bits in buffer
+		int padding; // how many of those are zeros from past the end
+		bool overrun;
+
+		void Refill();
+		unsigned int Peek(int bits);
+		void Skip(int bits);
+		unsigned int Read(int bits);
+	};
+
+	// indexed by the next MaxCodeBits bits (reversed codes), each entry
+	// is symbol << 4 | code length, and 0 for bits that aren't a code
+	static bool BuildTable(const uint8_t* lengths, int count, std::vector<uint16_t>& table);
+	static int DecodeSymbol(BitReader& bits, const std::vector<uint16_t>& table);
+	static bool ReadDynamicTables(BitReader& bits, std::vector<uint16_t>& lengthTable, std::vector<uint16_t>& distanceTable);
+	static bool InflateCodes(BitReader& bits, const std::vector<uint16_t>& lengthTable, const std::vector<uint16_t>& distanceTable, size_t maxSize, std::vector<unsigned char>& output);
+
+	static bool Unfilter(unsigned char* scanlines, unsigned int height, size_t rowBytes, unsigned int filterStride);
+	static uint32_t ReadBigEndian(const unsigned char* bytes);
+};
@@ -0,0 +1,46 @@
+#include "ShaderStructs.hlsli"
+
+// set for every entity, worldViewProjection is multiplied out on the CPU
+cbuffer PerObject : register(b1) { 
+	matrix worldViewProjection;
+	matrix world;
+	matrix worldInverseTranspose;
+	float3 positionOffset; // mesh bounds min
+	float3 positionScale; // mesh bounds extent
+}
+
+// layout comes from VertexQuantizer::InputElements, not reflection
+struct VertexShaderInput
+{ 
+	float4 quantizedPosition: POSITION; // UNORM, 0-1 across the bounds
+	float2 normal: NORMAL; // SNORM, octahedral
+	float2 tangent: TANGENT; // SNORM, octahedral
+	float2 uv: TEXCOORD; // half floats, already widened by the input assembler
+};
+
+// mirrors VertexQuantizer::DecodeOctahedral
+float3 DecodeOctahedral(float2 encoded)
+{
+	float3 direction = float3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+	float fold = saturate(-direction.z);
+	direction.xy += direction.xy >= 0.0f ? -fold : fold;
+	return normalize(direction);
+}
+
+VertexToPixel main( VertexShaderInput input )
+{
+	// Set up output struct
+	VertexToPixel output;
+
+	float3 localPosition = positionOffset + input.quantizedPosition.xyz * positionScale;
+
+	output.screenPosition = mul(worldViewProjection, float4(localPosition, 1.0f));
+	output.normal = mul((float3x3)worldInverseTranspose, DecodeOctahedral(input.normal));
+
+	output.tangent = mul((float3x3)worldInverseTranspose, DecodeOctahedral(input.tangent));
+	output.worldPosition = mul(world, localPosition);
+
+	output.uv = input.uv;
+
+	return output;
+}
@@ -0,0 +1,42 @@
+#include "RadixSort.h"
+#include <string.h>
+
+void RadixSort::Sort(std::vector<RenderItem>& items, std::vector<RenderItem>& scratch) {
+	size_t count = items.size();
+	if(count < 2) {
+		return;
+	}
+	scratch.resize(count);
+
+	// every byte's histogram in one read of the keys
+	size_t histograms[8][256];
+	memset(histograms, 0, sizeof(histograms));
+	for(size_t i = 0; i < count; i++) {
+		uint64_t key = items[i].key;
+		for(int b = 0; b < 8; b++) {
+			histograms[b][(key >> (b * 8)) & 0xFF]++;
+		}
+	}
+
+	for(int b = 0; b < 8; b++) {
+		size_t* histogram = histograms[b];
+		int shift = b * 8;
+
+		// all keys share this byte, so the pass wouldn't move anything
+		if(histogram[(items[0].key >> shift) & 0xFF] == count) {
+			continue;
+		}
+
+		size_t offsets[256];
+		size_t total = 0;
+		for(int i = 0; i < 256; i++) {
+			offsets[i] = total;
+			total += histogram[i];
+		}
+
+		for(size_t i = 0; i < count; i++) {
+			scratch[offsets[(items[i].key >> shift) & 0xFF]++] = items[i];
+		}
+		items.swap(scratch);
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <vector>
+#include "RenderItem.h"
+
+// --------------------------------------------------------
+// LSD radix sort of render items on their 64 bit key, 8 bits
+// at a time. Stable, and skips any byte every key has in
+// common, which for RenderQueue keys is most of the high ones.
+// --------------------------------------------------------
+class RadixSort
+{
+public:
+	// scratch is resized as needed, keep it around to avoid reallocating
+	static void Sort(std::vector<RenderItem>& items, std::vector<RenderItem>& scratch);
+};
@@ -0,0 +1,17 @@
+#pragma once
+#include <stdint.h>
+
+class Transform;
+class Mesh;
+class Material;
+
+// one draw in a RenderQueue. The pointers only have to last until
+// Execute, so nothing is created or destroyed in the World in between
+struct RenderItem
+{
+	uint64_t key;
+	Transform* transform;
+	Mesh* mesh;
+	Material* material;
+	unsigned int worldIndex; // into the queue's world matrices, set by Submit
+};
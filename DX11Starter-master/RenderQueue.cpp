@@ -0,0 +1,148 @@
+#include "RenderQueue.h"
+#include "World.h"
+
+using namespace DirectX;
+
+uint64_t RenderQueue::MakeKey(RenderPass pass, unsigned int shaderId, unsigned int materialId, unsigned int meshId, float depth) {
+	if(depth < 0.0f) {
+		depth = 0.0f;
+	}
+	if(depth > 1.0f) {
+		depth = 1.0f;
+	}
+	uint64_t maxDepth = (1ull << DepthBits) - 1;
+	uint64_t quantizedDepth = (uint64_t)(depth * maxDepth);
+	if(pass == RenderPassTransparent) {
+		quantizedDepth = maxDepth - quantizedDepth;
+	}
+
+	uint64_t key = (uint64_t)pass & ((1ull << PassBits) - 1);
+	key = (key << ShaderBits) | (shaderId & ((1ull << ShaderBits) - 1));
+	key = (key << MaterialBits) | (materialId & ((1ull << MaterialBits) - 1));
+	key = (key << MeshBits) | (meshId & ((1ull << MeshBits) - 1));
+	key = (key << DepthBits) | quantizedDepth;
+	return key;
+}
+
+void RenderQueue::Clear() {
+	items.clear();
+	worlds.clear();
+}
+
+void RenderQueue::Submit(Transform* transform, const RenderComponent& render, std::shared_ptr<Camera> camera, RenderPass pass) {
+	// view space z of the bounds center, as a fraction of the draw distance
+	XMFLOAT4X4 world = transform->GetWorldMatrix();
+	XMFLOAT3 center = World::GetWorldBoundingSphere(render, world).Center;
+	XMFLOAT4X4 view = camera->GetView();
+	float viewZ = center.x * view._13 + center.y * view._23 + center.z * view._33 + view._43;
+
+	Material* material = render.material.get();
+	unsigned int shaderId = ((material->GetVertexShader()->GetId() & 0x3F) << 6) | (material->GetPixelShader()->GetId() & 0x3F);
+	Submit(MakeKey(pass, shaderId, material->GetId(), render.mesh->GetId(), viewZ / camera->GetFarClip()), transform, render.mesh.get(), material, world);
+}
+
+void RenderQueue::Submit(uint64_t key, Transform* transform, Mesh* mesh, Material* material) {
+	Submit(key, transform, mesh, material, transform->GetWorldMatrix());
+}
+
+void RenderQueue::Submit(uint64_t key, Transform* transform, Mesh* mesh, Material* material, const XMFLOAT4X4& world) {
+	items.push_back({ key, transform, mesh, material, (unsigned int)worlds.size() });
+	worlds.push_back(world);
+}
+
+void RenderQueue::Sort() {
+	RadixSort::Sort(items, scratch);
+}
+
+void RenderQueue::Execute(Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, std::shared_ptr<Camera> camera, ConstantBufferRing* constantRing, StateCache* stateCache, InstanceBuffer* instanceBuffer) {
+	// sorted items with the same key above the depth bits are next to each other. The
+	// ids in the key wrap, so the actual material and mesh are compared as well
+	runs.clear();
+	instances.clear();
+	for(size_t i = 0; i < items.size();) {
+		const RenderItem& first = items[i];
+		uint64_t state = first.key >> DepthBits;
+		size_t end = i + 1;
+		while(end < items.size() && (items[end].key >> DepthBits) == state &&
+			items[end].material == first.material && items[end].mesh == first.mesh) {
+			end++;
+		}
+
+		DrawRun run = { i, end - i, 0, false };
+		if(instanceBuffer && run.count >= MinInstances && CanInstance(first)) {
+			run.instanced = true;
+			run.firstInstance = instances.size();
+			for(size_t k = i; k < end; k++) {
+				instances.push_back({ worlds[items[k].worldIndex], items[k].transform->GetWorldInverseTransposeMatrix() });
+			}
+		}
+		runs.push_back(run);
+		i = end;
+	}
+
+	// one upload for every instanced run this frame
+	bool instancesReady = !instances.empty() && instanceBuffer->Upload(instances.data(), (unsigned int)instances.size());
+
+	// world * viewProjection for every item in one pass, in submission order like the worlds.
+	// Instanced runs don't read theirs, but multiplying a few extra is cheaper than tracking
+	// which items need one
+	worldViewProjections.resize(worlds.size());
+	MatrixBatch::Multiply(worlds.data(), worlds.size(), camera->GetViewProjection(), worldViewProjections.data());
+
+	drawCallCount = 0;
+	for(DrawRun& run : runs) {
+		if(run.instanced && instancesReady) {
+			const RenderItem& first = items[run.first];
+			first.material->ApplyPixelShader();
+			first.material->GetInstancedVertexShader()->SetShader();
+			first.mesh->DrawInstanced(instanceBuffer->GetBuffer(), sizeof(InstanceData), (UINT)run.count, (UINT)run.firstInstance, stateCache);
+			drawCallCount++;
+			continue;
+		}
+
+		for(size_t k = run.first; k < run.first + run.count; k++) {
+			Draw(items[k], constantRing, stateCache);
+			drawCallCount++;
+		}
+	}
+}
+
+bool RenderQueue::CanInstance(const RenderItem& item) {
+	// the instanced shader only reads full size vertices
+	return item.material->GetInstancedVertexShader() && item.mesh->GetVertexFormat() == VertexFormatFull;
+}
+
+void RenderQueue::Draw(const RenderItem& item, ConstantBufferRing* constantRing, StateCache* stateCache) {
+	const MaterialVariables& vars = item.material->GetVariables();
+	std::shared_ptr<SimpleVertexShader> vs = item.material->GetVertexShader();
+	vs->SetMatrix4x4(vars.worldViewProjection, worldViewProjections[item.worldIndex]);
+	vs->SetMatrix4x4(vars.world, worlds[item.worldIndex]);
+	vs->SetMatrix4x4(vars.worldInverseTranspose, item.transform->GetWorldInverseTransposeMatrix());
+	if(item.mesh->GetVertexFormat() == VertexFormatQuantized) {
+		vs->SetFloat3(vars.positionOffset, item.mesh->GetPositionOffset());
+		vs->SetFloat3(vars.positionScale, item.mesh->GetPositionScale());
+	}
+
+	// per-frame data was already copied by Game::Draw. The per-object buffer goes through
+	// the ring when there is one, and then SetShader leaves its slot to the ring's bind
+	// instead of binding the shader's own buffer there first
+	const SimpleConstantBuffer* perObject = vs->GetBufferInfo(vars.world.ConstantBufferIndex);
+	bool ringBound = constantRing && perObject && constantRing->BindVS(perObject->BindIndex, perObject->LocalDataBuffer, perObject->Size);
+	vs->SetExternalBuffer(ringBound ? (int)vars.world.ConstantBufferIndex : -1);
+
+	item.material->ApplyPixelShader();
+	vs->SetShader();
+	if(!ringBound) {
+		vs->CopyBufferData(vars.world.ConstantBufferIndex);
+	}
+
+	item.mesh->Draw(stateCache);
+}
+
+unsigned int RenderQueue::GetDrawCallCount() {
+	return drawCallCount;
+}
+
+const std::vector<RenderItem>& RenderQueue::GetItems() {
+	return items;
+}
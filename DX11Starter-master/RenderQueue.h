@@ -0,0 +1,73 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <memory>
+#include "Transform.h"
+#include "Components.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "Camera.h"
+#include "ConstantBufferRing.h"
+#include "StateCache.h"
+#include "InstanceBuffer.h"
+#include "MatrixBatch.h"
+#include "RenderItem.h"
+#include "RadixSort.h"
+
+enum RenderPass { RenderPassOpaque, RenderPassTransparent };
+
+// --------------------------------------------------------
+// Collects a frame's draws, sorts them by a packed key and
+// draws them in that order. From the top bit down the key is
+//   pass (4) | shaders (12) | material (12) | mesh (12) | depth (24)
+// so draws sharing state end up next to each other, and within
+// the same state opaque draws go front to back. Runs of draws
+// sharing all their state are instanced when an InstanceBuffer
+// is given and the material has an instanced vertex shader.
+// --------------------------------------------------------
+class RenderQueue
+{
+public:
+	static const int PassBits = 4;
+	static const int ShaderBits = 12;
+	static const int MaterialBits = 12;
+	static const int MeshBits = 12;
+	static const int DepthBits = 24;
+
+	// shorter runs aren't worth switching to the instanced shader for
+	static const size_t MinInstances = 2;
+
+	// depth is 0 at the camera to 1 at the far plane, transparent draws get it flipped
+	static uint64_t MakeKey(RenderPass pass, unsigned int shaderId, unsigned int materialId, unsigned int meshId, float depth);
+
+	void Clear();
+	void Submit(Transform* transform, const RenderComponent& render, std::shared_ptr<Camera> camera, RenderPass pass = RenderPassOpaque);
+	void Submit(uint64_t key, Transform* transform, Mesh* mesh, Material* material);
+	void Sort();
+	void Execute(Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, std::shared_ptr<Camera> camera, ConstantBufferRing* constantRing, StateCache* stateCache, InstanceBuffer* instanceBuffer = nullptr);
+
+	const std::vector<RenderItem>& GetItems();
+	unsigned int GetDrawCallCount(); // from the last Execute
+
+private:
+	struct DrawRun
+	{
+		size_t first;
+		size_t count;
+		size_t firstInstance;
+		bool instanced;
+	};
+
+	std::vector<RenderItem> items;
+	std::vector<RenderItem> scratch;
+	std::vector<DrawRun> runs;
+	std::vector<InstanceData> instances;
+	std::vector<DirectX::XMFLOAT4X4> worlds; // in submission order, read once per item by Submit
+	std::vector<DirectX::XMFLOAT4X4> worldViewProjections; // same order
+	unsigned int drawCallCount = 0;
+
+	// world has to be transform's current world matrix, for callers that already read it
+	void Submit(uint64_t key, Transform* transform, Mesh* mesh, Material* material, const DirectX::XMFLOAT4X4& world);
+	bool CanInstance(const RenderItem& item);
+	void Draw(const RenderItem& item, ConstantBufferRing* constantRing, StateCache* stateCache);
+};
@@ -0,0 +1,84 @@
+#include "RingAllocator.h"
+
+RingAllocator::RingAllocator(size_t capacity, size_t alignment) {
+	this->alignment = alignment > 0 ? alignment : 1;
+	this->capacity = capacity / this->alignment * this->alignment;
+	head = 0;
+	tail = 0;
+	allocatedTotal = 0;
+	retiredTotal = 0;
+}
+
+bool RingAllocator::Allocate(size_t size, size_t& offset, bool& wrapped) {
+	size_t aligned = (size + alignment - 1) / alignment * alignment;
+	if(aligned == 0) {
+		aligned = alignment;
+	}
+	size_t used = GetUsed();
+	if(aligned > capacity - used) {
+		return false;
+	}
+
+	// everything has retired, so there's no reason to leave a gap at the end
+	if(used == 0 && capacity - head < aligned) {
+		head = 0;
+		tail = 0;
+		for(FrameMark& frame : frames) {
+			frame.head = 0;
+		}
+	}
+
+	if(head >= tail) {
+		// free space is [head, capacity) then [0, tail)
+		if(capacity - head >= aligned) {
+			offset = head;
+		}
+		else if(tail >= aligned) {
+			// the end is too small, it stays allocated until this frame retires
+			allocatedTotal += capacity - head;
+			offset = 0;
+		}
+		else {
+			return false;
+		}
+	}
+	else {
+		// free space is [head, tail)
+		if(tail - head < aligned) {
+			return false;
+		}
+		offset = head;
+	}
+
+	head = offset + aligned;
+	if(head == capacity) {
+		head = 0;
+	}
+	allocatedTotal += aligned;
+	wrapped = offset == 0;
+	return true;
+}
+
+void RingAllocator::EndFrame(uint64_t fence) {
+	frames.push_back({ fence, head, allocatedTotal });
+}
+
+void RingAllocator::Retire(uint64_t completedFence) {
+	while(!frames.empty() && frames.front().fence <= completedFence) {
+		tail = frames.front().head;
+		retiredTotal = frames.front().allocatedTotal;
+		frames.pop_front();
+	}
+}
+
+size_t RingAllocator::GetCapacity() {
+	return capacity;
+}
+
+size_t RingAllocator::GetUsed() {
+	return (size_t)(allocatedTotal - retiredTotal);
+}
+
+size_t RingAllocator::GetFramesInFlight() {
+	return frames.size();
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <deque>
+
+// --------------------------------------------------------
+// Hands out aligned ranges of one fixed size buffer in order,
+// wrapping back to the start when it runs off the end. Space
+// is only given back once the GPU is done with it: EndFrame()
+// tags everything allocated so far with a fence value, and
+// Retire() frees every frame whose fence has completed.
+// Nothing here touches the device (see ConstantBufferRing).
+// --------------------------------------------------------
+class RingAllocator
+{
+public:
+	// constant buffer offsets have to be multiples of 16 constants
+	static const size_t DefaultAlignment = 256;
+
+	RingAllocator(size_t capacity, size_t alignment = DefaultAlignment);
+
+	// false when there isn't room until more frames retire. wrapped
+	// is set when the range starts back at the beginning of the buffer
+	bool Allocate(size_t size, size_t& offset, bool& wrapped);
+
+	void EndFrame(uint64_t fence);
+	void Retire(uint64_t completedFence);
+
+	size_t GetCapacity();
+	size_t GetUsed();
+	size_t GetFramesInFlight();
+
+private:
+	struct FrameMark
+	{
+		uint64_t fence;
+		size_t head;
+		uint64_t allocatedTotal;
+	};
+
+	size_t capacity;
+	size_t alignment;
+	size_t head;
+	size_t tail;
+
+	// running totals, including space skipped at the end on a wrap
+	uint64_t allocatedTotal;
+	uint64_t retiredTotal;
+
+	std::deque<FrameMark> frames;
+};
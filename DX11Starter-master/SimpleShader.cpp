@@ -4,6 +4,9 @@
 bool ISimpleShader::ReportErrors = false;
 bool ISimpleShader::ReportWarnings = false;
 
+// Ids are handed out in creation order
+unsigned int ISimpleShader::nextId = 0;
+
 // To enable error reporting, use either or both 
 // of the following lines somewhere in your program, 
 // preferably before loading/using any shaders.
@@ -29,6 +32,19 @@ ISimpleShader::ISimpleShader(Microsoft::WRL::ComPtr<ID3D11Device> device, Micros
 	this->constantBufferCount = 0;
 	this->constantBuffers = 0;
 	this->shaderValid = false;
+	this->stateCache = 0;
+	this->externalBufferIndex = -1;
+	this->id = nextId++;
+
+	// Partial constant buffer updates need D3D 11.1 and driver support
+	this->partialConstantBufferUpdates = false;
+	D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+	if (SUCCEEDED(device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))) &&
+		options.ConstantBufferPartialUpdate &&
+		SUCCEEDED(context.As(&this->deviceContext1)))
+	{
+		this->partialConstantBufferUpdates = true;
+	}
 }
 
 // --------------------------------------------------------
@@ -203,6 +219,10 @@ bool ISimpleShader::LoadShaderFile(LPCWSTR shaderFile)
 		constantBuffers[b].LocalDataBuffer = new unsigned char[bufferDesc.Size];
 		ZeroMemory(constantBuffers[b].LocalDataBuffer, bufferDesc.Size);
 
+		// The GPU copy starts out uninitialized, so the first copy always happens
+		constantBuffers[b].DirtyStart = 0;
+		constantBuffers[b].DirtyEnd = bufferDesc.Size;
+
 		// Loop through all variables in this buffer
 		for (unsigned int v = 0; v < bufferDesc.Variables; v++)
 		{
@@ -345,14 +365,9 @@ void ISimpleShader::CopyAllBufferData()
 	// Ensure the shader is valid
 	if (!shaderValid) return;
 
-	// Loop through the constant buffers and copy all data
+	// Loop through the constant buffers and copy any that changed
 	for (unsigned int i = 0; i < constantBufferCount; i++)
-	{
-		// Copy the entire local data buffer
-		deviceContext->UpdateSubresource(
-			constantBuffers[i].ConstantBuffer.Get(), 0, 0,
-			constantBuffers[i].LocalDataBuffer, 0, 0);
-	}
+		UploadIfDirty(&constantBuffers[i]);
 }
 
 // --------------------------------------------------------
@@ -379,10 +394,8 @@ void ISimpleShader::CopyBufferData(unsigned int index)
 	SimpleConstantBuffer* cb = &this->constantBuffers[index];
 	if (!cb) return;
 
-	// Copy the data and get out
-	deviceContext->UpdateSubresource(
-		cb->ConstantBuffer.Get(), 0, 0, 
-		cb->LocalDataBuffer, 0, 0);
+	// Copy the data (if it changed) and get out
+	UploadIfDirty(cb);
 }
 
 // --------------------------------------------------------
@@ -401,10 +414,79 @@ void ISimpleShader::CopyBufferData(std::string bufferName)
 	SimpleConstantBuffer* cb = this->FindConstantBuffer(bufferName);
 	if (!cb) return;
 
-	// Copy the data and get out
-	deviceContext->UpdateSubresource(
-		cb->ConstantBuffer.Get(), 0, 0, 
-		cb->LocalDataBuffer, 0, 0);
+	// Copy the data (if it changed) and get out
+	UploadIfDirty(cb);
+}
+
+// --------------------------------------------------------
+// Copies a buffer's dirty range to the GPU, or nothing at
+// all if none of its data changed since the last copy
+//
+// cb - The constant buffer to copy
+// --------------------------------------------------------
+void ISimpleShader::UploadIfDirty(SimpleConstantBuffer* cb)
+{
+	if (cb->DirtyStart >= cb->DirtyEnd)
+	{
+		uploadStats.UploadsSkipped++;
+		return;
+	}
+
+	uploadStats.UploadsIssued++;
+	uploadStats.BytesDirty += cb->DirtyEnd - cb->DirtyStart;
+
+	// Partial updates must cover whole 16 byte constants
+	unsigned int start = cb->DirtyStart & ~15u;
+	unsigned int end = (cb->DirtyEnd + 15u) & ~15u;
+	if (end > cb->Size) end = cb->Size;
+
+	if (partialConstantBufferUpdates && (start > 0 || end < cb->Size))
+	{
+		// Source data points at the start of the box, not the buffer
+		D3D11_BOX box = { start, 0, 0, end, 1, 1 };
+		deviceContext1->UpdateSubresource1(
+			cb->ConstantBuffer.Get(), 0, &box,
+			cb->LocalDataBuffer + start, 0, 0, 0);
+		uploadStats.BytesUploaded += end - start;
+	}
+	else
+	{
+		// Copy the entire local data buffer
+		deviceContext->UpdateSubresource(
+			cb->ConstantBuffer.Get(), 0, 0,
+			cb->LocalDataBuffer, 0, 0);
+		uploadStats.BytesUploaded += cb->Size;
+	}
+
+	cb->DirtyStart = 0;
+	cb->DirtyEnd = 0;
+}
+
+// --------------------------------------------------------
+// Writes into a local data buffer, growing its dirty range
+// only when the bytes actually differ from what's there
+// --------------------------------------------------------
+void ISimpleShader::WriteLocalData(unsigned int bufferIndex, unsigned int byteOffset, const void* data, unsigned int size)
+{
+	SimpleConstantBuffer* cb = &constantBuffers[bufferIndex];
+	unsigned char* dest = cb->LocalDataBuffer + byteOffset;
+
+	// Same values as last time, so the GPU copy is still current
+	if (memcmp(dest, data, size) == 0)
+		return;
+
+	memcpy(dest, data, size);
+
+	if (cb->DirtyStart >= cb->DirtyEnd)
+	{
+		cb->DirtyStart = byteOffset;
+		cb->DirtyEnd = byteOffset + size;
+	}
+	else
+	{
+		if (byteOffset < cb->DirtyStart) cb->DirtyStart = byteOffset;
+		if (byteOffset + size > cb->DirtyEnd) cb->DirtyEnd = byteOffset + size;
+	}
 }
 
 
@@ -446,10 +528,7 @@ bool ISimpleShader::SetData(std::string name, const void* data, unsigned int siz
 	}
 
 	// Set the data in the local data buffer
-	memcpy(
-		constantBuffers[var->ConstantBufferIndex].LocalDataBuffer + var->ByteOffset,
-		data,
-		size);
+	WriteLocalData(var->ConstantBufferIndex, var->ByteOffset, data, size);
 
 	// Success
 	return true;
@@ -535,6 +614,79 @@ bool ISimpleShader::SetMatrix4x4(std::string name, const DirectX::XMFLOAT4X4 dat
 	return this->SetData(name, &data, sizeof(float) * 16);
 }
 
+// --------------------------------------------------------
+// Resolves a variable name once, so it can be set later
+// without any lookups
+//
+// name - The name of the shader variable
+//
+// Returns a handle, which is not Valid if the variable doesn't exist
+// --------------------------------------------------------
+SimpleShaderVariableHandle ISimpleShader::GetVariableHandle(std::string name)
+{
+	SimpleShaderVariableHandle handle;
+	SimpleShaderVariable* var = FindVariable(name, -1);
+	if (var == 0)
+		return handle;
+
+	handle.ByteOffset = var->ByteOffset;
+	handle.Size = var->Size;
+	handle.ConstantBufferIndex = var->ConstantBufferIndex;
+	handle.Valid = true;
+	return handle;
+}
+
+// --------------------------------------------------------
+// Sets a variable through a handle with arbitrary data
+//
+// handle - A handle from this shader's GetVariableHandle()
+// data - The data to set in the buffer
+// size - The size of the data (this must be less than or equal to the variable's size)
+//
+// Returns true if data is copied, false if the handle isn't valid
+// --------------------------------------------------------
+bool ISimpleShader::SetData(const SimpleShaderVariableHandle& handle, const void* data, unsigned int size)
+{
+	// Missing variables were already reported (if at all) when resolving,
+	// so this stays quiet, the same way the name version would every frame
+	if (!handle.Valid || size > handle.Size || handle.ConstantBufferIndex >= constantBufferCount)
+		return false;
+
+	// Straight into the local data buffer
+	WriteLocalData(handle.ConstantBufferIndex, handle.ByteOffset, data, size);
+	return true;
+}
+
+bool ISimpleShader::SetInt(const SimpleShaderVariableHandle& handle, int data)
+{
+	return this->SetData(handle, &data, sizeof(int));
+}
+
+bool ISimpleShader::SetFloat(const SimpleShaderVariableHandle& handle, float data)
+{
+	return this->SetData(handle, &data, sizeof(float));
+}
+
+bool ISimpleShader::SetFloat2(const SimpleShaderVariableHandle& handle, const DirectX::XMFLOAT2& data)
+{
+	return this->SetData(handle, &data, sizeof(float) * 2);
+}
+
+bool ISimpleShader::SetFloat3(const SimpleShaderVariableHandle& handle, const DirectX::XMFLOAT3& data)
+{
+	return this->SetData(handle, &data, sizeof(float) * 3);
+}
+
+bool ISimpleShader::SetFloat4(const SimpleShaderVariableHandle& handle, const DirectX::XMFLOAT4& data)
+{
+	return this->SetData(handle, &data, sizeof(float) * 4);
+}
+
+bool ISimpleShader::SetMatrix4x4(const SimpleShaderVariableHandle& handle, const DirectX::XMFLOAT4X4& data)
+{
+	return this->SetData(handle, &data, sizeof(float) * 16);
+}
+
 // --------------------------------------------------------
 // Determines if the shader contains the specified
 // variable within one of its constant buffers
@@ -868,6 +1020,19 @@ void SimpleVertexShader::SetShaderAndCBs()
 	// Is shader valid?
 	if (!shaderValid) return;
 
+	// Let the cache skip anything that's already bound
+	if (stateCache)
+	{
+		stateCache->SetInputLayout(inputLayout.Get());
+		stateCache->SetVertexShader(shader.Get());
+		for (unsigned int i = 0; i < constantBufferCount; i++)
+		{
+			if (constantBuffers[i].Type == D3D11_CT_CBUFFER && (int)i != externalBufferIndex)
+				stateCache->SetVSConstantBuffer(constantBuffers[i].BindIndex, constantBuffers[i].ConstantBuffer.Get());
+		}
+		return;
+	}
+
 	// Set the shader and input layout
 	deviceContext->IASetInputLayout(inputLayout.Get());
 	deviceContext->VSSetShader(shader.Get(), 0, 0);
@@ -875,8 +1040,8 @@ void SimpleVertexShader::SetShaderAndCBs()
 	// Set the constant buffers
 	for (unsigned int i = 0; i < constantBufferCount; i++)
 	{
-		// Skip "buffers" that aren't true constant buffers
-		if (constantBuffers[i].Type != D3D11_CT_CBUFFER)
+		// Skip "buffers" that aren't true constant buffers, or are bound elsewhere
+		if (constantBuffers[i].Type != D3D11_CT_CBUFFER || (int)i == externalBufferIndex)
 			continue;
 
 		// This is a real constant buffer, so set it
@@ -1011,6 +1176,18 @@ void SimplePixelShader::SetShaderAndCBs()
 	// Is shader valid?
 	if (!shaderValid) return;
 	
+	// Let the cache skip anything that's already bound
+	if (stateCache)
+	{
+		stateCache->SetPixelShader(shader.Get());
+		for (unsigned int i = 0; i < constantBufferCount; i++)
+		{
+			if (constantBuffers[i].Type == D3D11_CT_CBUFFER)
+				stateCache->SetPSConstantBuffer(constantBuffers[i].BindIndex, constantBuffers[i].ConstantBuffer.Get());
+		}
+		return;
+	}
+
 	// Set the shader
 	deviceContext->PSSetShader(shader.Get(), 0, 0);
 
@@ -1053,7 +1230,10 @@ bool SimplePixelShader::SetShaderResourceView(std::string name, Microsoft::WRL::
 	}
 
 	// Set the shader resource view
-	deviceContext->PSSetShaderResources(srvInfo->BindIndex, 1, srv.GetAddressOf());
+	if (stateCache)
+		stateCache->SetPSShaderResource(srvInfo->BindIndex, srv.Get());
+	else
+		deviceContext->PSSetShaderResources(srvInfo->BindIndex, 1, srv.GetAddressOf());
 
 	// Success
 	return true;
@@ -1083,12 +1263,54 @@ bool SimplePixelShader::SetSamplerState(std::string name, Microsoft::WRL::ComPtr
 	}
 
 	// Set the shader resource view
-	deviceContext->PSSetSamplers(sampInfo->BindIndex, 1, samplerState.GetAddressOf());
+	if (stateCache)
+		stateCache->SetPSSampler(sampInfo->BindIndex, samplerState.Get());
+	else
+		deviceContext->PSSetSamplers(sampInfo->BindIndex, 1, samplerState.GetAddressOf());
 
 	// Success
 	return true;
 }
 
+// --------------------------------------------------------
+// Sets a contiguous range of shader resource views in the
+// pixel shader stage, for callers that looked up the
+// registers ahead of time (see Material)
+//
+// startSlot - The first register to set
+// count - How many registers to set
+// srvs - One SRV per register, null to unbind
+// --------------------------------------------------------
+void SimplePixelShader::SetShaderResourceViews(unsigned int startSlot, unsigned int count, ID3D11ShaderResourceView* const* srvs)
+{
+	if (count == 0)
+		return;
+
+	if (stateCache)
+		stateCache->SetPSShaderResources(startSlot, count, srvs);
+	else
+		deviceContext->PSSetShaderResources(startSlot, count, srvs);
+}
+
+// --------------------------------------------------------
+// Sets a contiguous range of sampler states in the pixel
+// shader stage
+//
+// startSlot - The first register to set
+// count - How many registers to set
+// samplerStates - One sampler per register, null to unbind
+// --------------------------------------------------------
+void SimplePixelShader::SetSamplerStates(unsigned int startSlot, unsigned int count, ID3D11SamplerState* const* samplerStates)
+{
+	if (count == 0)
+		return;
+
+	if (stateCache)
+		stateCache->SetPSSamplers(startSlot, count, samplerStates);
+	else
+		deviceContext->PSSetSamplers(startSlot, count, samplerStates);
+}
+
 
 
 
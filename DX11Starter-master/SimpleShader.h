@@ -3,10 +3,13 @@
 #pragma comment(lib, "d3dcompiler.lib")
 
 #include <d3d11.h>
+#include <d3d11_1.h>
 #include <d3dcompiler.h>
 #include <DirectXMath.h>
 #include <wrl/client.h>
 
+#include "StateCache.h"
+
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -23,6 +26,19 @@ struct SimpleShaderVariable
 	unsigned int ConstantBufferIndex;
 };
 
+// --------------------------------------------------------
+// A variable resolved ahead of time with GetVariableHandle().
+// Setting data through one skips the string and the table
+// lookup entirely. Only valid for the shader that made it.
+// --------------------------------------------------------
+struct SimpleShaderVariableHandle
+{
+	unsigned int ByteOffset = 0;
+	unsigned int Size = 0;
+	unsigned int ConstantBufferIndex = 0;
+	bool Valid = false;
+};
+
 // --------------------------------------------------------
 // Contains information about a specific
 // constant buffer in a shader, as well as
@@ -37,6 +53,23 @@ struct SimpleConstantBuffer
 	Microsoft::WRL::ComPtr<ID3D11Buffer> ConstantBuffer = 0;
 	unsigned char* LocalDataBuffer = 0;
 	std::vector<SimpleShaderVariable> Variables;
+
+	// Byte range of LocalDataBuffer changed since the last copy
+	// (empty when DirtyStart >= DirtyEnd)
+	unsigned int DirtyStart = 0;
+	unsigned int DirtyEnd = 0;
+};
+
+// --------------------------------------------------------
+// Counts how many constant buffer copies a shader actually
+// issued and how many were skipped because nothing changed
+// --------------------------------------------------------
+struct SimpleShaderUploadStats
+{
+	unsigned long long UploadsIssued = 0;
+	unsigned long long UploadsSkipped = 0;
+	unsigned long long BytesUploaded = 0;	// What was sent to the GPU
+	unsigned long long BytesDirty = 0;		// What had actually changed
 };
 
 // --------------------------------------------------------
@@ -68,6 +101,7 @@ public:
 
 	// Simple helpers
 	bool IsShaderValid() { return shaderValid; }
+	unsigned int GetId() { return id; }	// Sequential, unique per shader
 
 	// Activating the shader and copying data
 	void SetShader();
@@ -89,6 +123,16 @@ public:
 	bool SetMatrix4x4(std::string name, const float data[16]);
 	bool SetMatrix4x4(std::string name, const DirectX::XMFLOAT4X4 data);
 
+	// Sets data through pre-resolved handles
+	SimpleShaderVariableHandle GetVariableHandle(std::string name);
+	bool SetData(const SimpleShaderVariableHandle& handle, const void* data, unsigned int size);
+	bool SetInt(const SimpleShaderVariableHandle& handle, int data);
+	bool SetFloat(const SimpleShaderVariableHandle& handle, float data);
+	bool SetFloat2(const SimpleShaderVariableHandle& handle, const DirectX::XMFLOAT2& data);
+	bool SetFloat3(const SimpleShaderVariableHandle& handle, const DirectX::XMFLOAT3& data);
+	bool SetFloat4(const SimpleShaderVariableHandle& handle, const DirectX::XMFLOAT4& data);
+	bool SetMatrix4x4(const SimpleShaderVariableHandle& handle, const DirectX::XMFLOAT4X4& data);
+
 	// Setting shader resources
 	virtual bool SetShaderResourceView(std::string name, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv) = 0;
 	virtual bool SetSamplerState(std::string name, Microsoft::WRL::ComPtr<ID3D11SamplerState> samplerState) = 0;
@@ -118,6 +162,17 @@ public:
 	// Misc getters
 	Microsoft::WRL::ComPtr<ID3DBlob> GetShaderBlob() { return shaderBlob; }
 
+	// Upload tracking
+	const SimpleShaderUploadStats& GetUploadStats() { return uploadStats; }
+	void ResetUploadStats() { uploadStats = SimpleShaderUploadStats(); }
+
+	// Routes binds through a cache that drops redundant ones (vertex & pixel shaders)
+	void SetStateCache(StateCache* cache) { stateCache = cache; }
+
+	// Leaves one constant buffer's slot alone in SetShader(), for a buffer
+	// that's bound from elsewhere (vertex shaders). -1 binds them all
+	void SetExternalBuffer(int index) { externalBufferIndex = index; }
+
 	// Error reporting
 	static bool ReportErrors;
 	static bool ReportWarnings;
@@ -129,6 +184,25 @@ protected:
 	Microsoft::WRL::ComPtr<ID3D11Device> device;
 	Microsoft::WRL::ComPtr<ID3D11DeviceContext> deviceContext;
 
+	// Only used when the driver can update part of a constant buffer
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext1> deviceContext1;
+	bool partialConstantBufferUpdates;
+
+	// Optional redundant bind filtering
+	StateCache* stateCache;
+
+	// Constant buffer SetShader() doesn't bind, or -1
+	int externalBufferIndex;
+
+	// Shader ids
+	static unsigned int nextId;
+	unsigned int id;
+
+	// Dirty tracking
+	SimpleShaderUploadStats uploadStats;
+	void WriteLocalData(unsigned int bufferIndex, unsigned int byteOffset, const void* data, unsigned int size);
+	void UploadIfDirty(SimpleConstantBuffer* cb);
+
 	// Resource counts
 	unsigned int constantBufferCount;
 	
@@ -204,6 +278,10 @@ public:
 	bool SetShaderResourceView(std::string name, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv);
 	bool SetSamplerState(std::string name, Microsoft::WRL::ComPtr<ID3D11SamplerState> samplerState);
 
+	// Binds already resolved registers in one call each
+	void SetShaderResourceViews(unsigned int startSlot, unsigned int count, ID3D11ShaderResourceView* const* srvs);
+	void SetSamplerStates(unsigned int startSlot, unsigned int count, ID3D11SamplerState* const* samplerStates);
+
 protected:
 	Microsoft::WRL::ComPtr<ID3D11PixelShader> shader;
 	bool CreateShader(Microsoft::WRL::ComPtr<ID3DBlob> shaderBlob);
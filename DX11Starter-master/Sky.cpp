@@ -19,7 +19,7 @@ Sky::Sky(std::shared_ptr<Mesh> mesh, Microsoft::WRL::ComPtr<ID3D11SamplerState>
 	device.Get()->CreateDepthStencilState(&stencilDescription, &depthStencilState);
 }
 
-void Sky::Draw(Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, std::shared_ptr<Camera> camera)
+void Sky::Draw(Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, std::shared_ptr<Camera> camera, StateCache* stateCache)
 {
 	context->RSSetState(rasterizerState.Get());
 	context->OMSetDepthStencilState(depthStencilState.Get(), 0);
@@ -34,7 +34,7 @@ void Sky::Draw(Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, std::shared_
 	pixelShader->CopyAllBufferData();
 	pixelShader->SetShader();
 
-	mesh->Draw();
+	mesh->Draw(stateCache);
 
 	context->RSSetState(nullptr);
 	context->OMSetDepthStencilState(nullptr, 0);
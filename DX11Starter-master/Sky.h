@@ -15,7 +15,7 @@ public:
 		std::shared_ptr<SimplePixelShader> pixelShader, 
 		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> textureSRV);
 
-	void Draw(Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, std::shared_ptr<Camera> camera);
+	void Draw(Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, std::shared_ptr<Camera> camera, StateCache* stateCache = nullptr);
 
 private:
 	Microsoft::WRL::ComPtr<ID3D11SamplerState> samplerState;
@@ -0,0 +1,232 @@
+#include "StateCache.h"
+
+StateCache::StateCache(Microsoft::WRL::ComPtr<ID3D11DeviceContext> context) {
+	this->context = context;
+	context.As(&context1);
+
+	inputLayout = 0;
+	topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	for(unsigned int i = 0; i < VertexBufferSlots; i++) {
+		vertexBuffers[i] = 0;
+		vertexStrides[i] = 0;
+		vertexOffsets[i] = 0;
+	}
+	indexBuffer = 0;
+	indexFormat = DXGI_FORMAT_UNKNOWN;
+	indexOffset = 0;
+	vertexShader = 0;
+	pixelShader = 0;
+	for(unsigned int i = 0; i < ConstantBufferSlots; i++) {
+		vsConstantBuffers[i] = { 0, 0, 0, false };
+		psConstantBuffers[i] = { 0, 0, 0, false };
+	}
+	for(unsigned int i = 0; i < ResourceSlots; i++) {
+		psResources[i] = 0;
+	}
+	for(unsigned int i = 0; i < SamplerSlots; i++) {
+		psSamplers[i] = 0;
+	}
+
+	frameStats = {};
+	lastFrameStats = {};
+	totalStats = {};
+	frameCount = 0;
+	Invalidate();
+}
+
+void StateCache::BeginFrame() {
+	if(frameCount > 0) {
+		lastFrameStats = frameStats;
+	}
+	frameStats = {};
+	frameCount++;
+}
+
+// forgets everything, so the next bind of each kind always goes through
+void StateCache::Invalidate() {
+	inputLayoutKnown = false;
+	topologyKnown = false;
+	for(unsigned int i = 0; i < VertexBufferSlots; i++) {
+		vertexBufferKnown[i] = false;
+	}
+	indexBufferKnown = false;
+	vertexShaderKnown = false;
+	pixelShaderKnown = false;
+	for(unsigned int i = 0; i < ConstantBufferSlots; i++) {
+		vsConstantBuffers[i].known = false;
+		psConstantBuffers[i].known = false;
+	}
+	for(unsigned int i = 0; i < ResourceSlots; i++) {
+		psResourceKnown[i] = false;
+	}
+	for(unsigned int i = 0; i < SamplerSlots; i++) {
+		psSamplerKnown[i] = false;
+	}
+}
+
+bool StateCache::Changed(bool same, bool& known) {
+	if(known && same) {
+		frameStats.bindsFiltered++;
+		totalStats.bindsFiltered++;
+		return false;
+	}
+	known = true;
+	frameStats.bindsIssued++;
+	totalStats.bindsIssued++;
+	return true;
+}
+
+void StateCache::SetInputLayout(ID3D11InputLayout* layout) {
+	if(Changed(layout == inputLayout, inputLayoutKnown)) {
+		inputLayout = layout;
+		context->IASetInputLayout(layout);
+	}
+}
+
+void StateCache::SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology) {
+	if(Changed(topology == this->topology, topologyKnown)) {
+		this->topology = topology;
+		context->IASetPrimitiveTopology(topology);
+	}
+}
+
+void StateCache::SetVertexBuffer(UINT slot, ID3D11Buffer* buffer, UINT stride, UINT offset) {
+	bool unknown = false;
+	bool& known = slot < VertexBufferSlots ? vertexBufferKnown[slot] : unknown;
+	bool same = slot < VertexBufferSlots && buffer == vertexBuffers[slot] && stride == vertexStrides[slot] && offset == vertexOffsets[slot];
+	if(Changed(same, known)) {
+		if(slot < VertexBufferSlots) {
+			vertexBuffers[slot] = buffer;
+			vertexStrides[slot] = stride;
+			vertexOffsets[slot] = offset;
+		}
+		context->IASetVertexBuffers(slot, 1, &buffer, &stride, &offset);
+	}
+}
+
+void StateCache::SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset) {
+	if(Changed(buffer == indexBuffer && format == indexFormat && offset == indexOffset, indexBufferKnown)) {
+		indexBuffer = buffer;
+		indexFormat = format;
+		indexOffset = offset;
+		context->IASetIndexBuffer(buffer, format, offset);
+	}
+}
+
+void StateCache::SetVertexShader(ID3D11VertexShader* shader) {
+	if(Changed(shader == vertexShader, vertexShaderKnown)) {
+		vertexShader = shader;
+		context->VSSetShader(shader, 0, 0);
+	}
+}
+
+void StateCache::SetPixelShader(ID3D11PixelShader* shader) {
+	if(Changed(shader == pixelShader, pixelShaderKnown)) {
+		pixelShader = shader;
+		context->PSSetShader(shader, 0, 0);
+	}
+}
+
+bool StateCache::BindConstantBuffer(ConstantBufferBinding* bindings, UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT numConstants) {
+	if(slot >= ConstantBufferSlots) {
+		bool unknown = false;
+		return Changed(false, unknown);
+	}
+
+	ConstantBufferBinding& binding = bindings[slot];
+	bool same = binding.buffer == buffer && binding.firstConstant == firstConstant && binding.numConstants == numConstants;
+	if(!Changed(same, binding.known)) {
+		return false;
+	}
+	binding.buffer = buffer;
+	binding.firstConstant = firstConstant;
+	binding.numConstants = numConstants;
+	return true;
+}
+
+void StateCache::SetVSConstantBuffer(UINT slot, ID3D11Buffer* buffer) {
+	if(BindConstantBuffer(vsConstantBuffers, slot, buffer, 0, 0)) {
+		context->VSSetConstantBuffers(slot, 1, &buffer);
+	}
+}
+
+// binds part of a buffer, false if the context can't do offsets
+bool StateCache::SetVSConstantBuffer(UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT numConstants) {
+	if(!context1) {
+		return false;
+	}
+	if(BindConstantBuffer(vsConstantBuffers, slot, buffer, firstConstant, numConstants)) {
+		context1->VSSetConstantBuffers1(slot, 1, &buffer, &firstConstant, &numConstants);
+	}
+	return true;
+}
+
+void StateCache::SetPSConstantBuffer(UINT slot, ID3D11Buffer* buffer) {
+	if(BindConstantBuffer(psConstantBuffers, slot, buffer, 0, 0)) {
+		context->PSSetConstantBuffers(slot, 1, &buffer);
+	}
+}
+
+void StateCache::SetPSShaderResource(UINT slot, ID3D11ShaderResourceView* srv) {
+	bool unknown = false;
+	bool& known = slot < ResourceSlots ? psResourceKnown[slot] : unknown;
+	if(Changed(slot < ResourceSlots && psResources[slot] == srv, known)) {
+		if(slot < ResourceSlots) {
+			psResources[slot] = srv;
+		}
+		context->PSSetShaderResources(slot, 1, &srv);
+	}
+}
+
+void StateCache::SetPSSampler(UINT slot, ID3D11SamplerState* sampler) {
+	bool unknown = false;
+	bool& known = slot < SamplerSlots ? psSamplerKnown[slot] : unknown;
+	if(Changed(slot < SamplerSlots && psSamplers[slot] == sampler, known)) {
+		if(slot < SamplerSlots) {
+			psSamplers[slot] = sampler;
+		}
+		context->PSSetSamplers(slot, 1, &sampler);
+	}
+}
+
+void StateCache::SetPSShaderResources(UINT startSlot, UINT count, ID3D11ShaderResourceView* const* srvs) {
+	bool same = startSlot + count <= ResourceSlots;
+	for(UINT i = 0; same && i < count; i++) {
+		same = psResourceKnown[startSlot + i] && psResources[startSlot + i] == srvs[i];
+	}
+	bool known = same;
+	if(Changed(same, known)) {
+		for(UINT i = 0; i < count && startSlot + i < ResourceSlots; i++) {
+			psResources[startSlot + i] = srvs[i];
+			psResourceKnown[startSlot + i] = true;
+		}
+		context->PSSetShaderResources(startSlot, count, srvs);
+	}
+}
+
+void StateCache::SetPSSamplers(UINT startSlot, UINT count, ID3D11SamplerState* const* samplers) {
+	bool same = startSlot + count <= SamplerSlots;
+	for(UINT i = 0; same && i < count; i++) {
+		same = psSamplerKnown[startSlot + i] && psSamplers[startSlot + i] == samplers[i];
+	}
+	bool known = same;
+	if(Changed(same, known)) {
+		for(UINT i = 0; i < count && startSlot + i < SamplerSlots; i++) {
+			psSamplers[startSlot + i] = samplers[i];
+			psSamplerKnown[startSlot + i] = true;
+		}
+		context->PSSetSamplers(startSlot, count, samplers);
+	}
+}
+
+StateCacheStats StateCache::GetFrameStats() {
+	return lastFrameStats;
+}
+
+StateCacheStats StateCache::GetTotalStats() {
+	return totalStats;
+}
+
+unsigned long long StateCache::GetFrameCount() {
+	return frameCount;
+}
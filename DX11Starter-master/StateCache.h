@@ -0,0 +1,101 @@
+#pragma once
+#include <d3d11.h>
+#include <d3d11_1.h>
+#include <wrl/client.h>
+
+struct StateCacheStats
+{
+	unsigned long long bindsIssued;
+	unsigned long long bindsFiltered;
+};
+
+// --------------------------------------------------------
+// Sits between the renderer and the device context and drops
+// binds of whatever is already bound. Only knows about binds
+// made through it, so anything that goes around it has to call
+// Invalidate() afterwards. Raw pointers are safe to keep since
+// the context holds a reference to everything still bound.
+// --------------------------------------------------------
+class StateCache
+{
+public:
+	// slots past these are never filtered
+	static const unsigned int ConstantBufferSlots = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT;
+	static const unsigned int ResourceSlots = 16;
+	static const unsigned int SamplerSlots = D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT;
+	static const unsigned int VertexBufferSlots = 2; // per vertex and per instance
+
+	StateCache(Microsoft::WRL::ComPtr<ID3D11DeviceContext> context);
+
+	void BeginFrame();
+	void Invalidate();
+
+	void SetInputLayout(ID3D11InputLayout* layout);
+	void SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology);
+	void SetVertexBuffer(UINT slot, ID3D11Buffer* buffer, UINT stride, UINT offset);
+	void SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset);
+
+	void SetVertexShader(ID3D11VertexShader* shader);
+	void SetVSConstantBuffer(UINT slot, ID3D11Buffer* buffer);
+	bool SetVSConstantBuffer(UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT numConstants);
+
+	void SetPixelShader(ID3D11PixelShader* shader);
+	void SetPSConstantBuffer(UINT slot, ID3D11Buffer* buffer);
+	void SetPSShaderResource(UINT slot, ID3D11ShaderResourceView* srv);
+	void SetPSSampler(UINT slot, ID3D11SamplerState* sampler);
+
+	// a whole range is one bind, filtered only when every slot in it matches
+	void SetPSShaderResources(UINT startSlot, UINT count, ID3D11ShaderResourceView* const* srvs);
+	void SetPSSamplers(UINT startSlot, UINT count, ID3D11SamplerState* const* samplers);
+
+	// counts for the last finished frame, and since startup
+	StateCacheStats GetFrameStats();
+	StateCacheStats GetTotalStats();
+	unsigned long long GetFrameCount();
+
+private:
+	// a whole-buffer bind is stored with numConstants 0
+	struct ConstantBufferBinding
+	{
+		ID3D11Buffer* buffer;
+		UINT firstConstant;
+		UINT numConstants;
+		bool known;
+	};
+
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext> context;
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext1> context1;
+
+	ID3D11InputLayout* inputLayout;
+	D3D11_PRIMITIVE_TOPOLOGY topology;
+	ID3D11Buffer* vertexBuffers[VertexBufferSlots];
+	UINT vertexStrides[VertexBufferSlots];
+	UINT vertexOffsets[VertexBufferSlots];
+	ID3D11Buffer* indexBuffer;
+	DXGI_FORMAT indexFormat;
+	UINT indexOffset;
+	ID3D11VertexShader* vertexShader;
+	ID3D11PixelShader* pixelShader;
+	bool inputLayoutKnown;
+	bool topologyKnown;
+	bool vertexBufferKnown[VertexBufferSlots];
+	bool indexBufferKnown;
+	bool vertexShaderKnown;
+	bool pixelShaderKnown;
+
+	ConstantBufferBinding vsConstantBuffers[ConstantBufferSlots];
+	ConstantBufferBinding psConstantBuffers[ConstantBufferSlots];
+	ID3D11ShaderResourceView* psResources[ResourceSlots];
+	bool psResourceKnown[ResourceSlots];
+	ID3D11SamplerState* psSamplers[SamplerSlots];
+	bool psSamplerKnown[SamplerSlots];
+
+	StateCacheStats frameStats;
+	StateCacheStats lastFrameStats;
+	StateCacheStats totalStats;
+	unsigned long long frameCount;
+
+	// true (and counted) when the bind has to go to the context
+	bool Changed(bool same, bool& known);
+	bool BindConstantBuffer(ConstantBufferBinding* bindings, UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT numConstants);
+};
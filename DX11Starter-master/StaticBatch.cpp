@@ -0,0 +1,93 @@
+#include "StaticBatch.h"
+
+using namespace DirectX;
+
+StaticBatch::StaticBatch(Microsoft::WRL::ComPtr<ID3D11Device> device, Microsoft::WRL::ComPtr<ID3D11DeviceContext> context) {
+	this->device = device;
+	this->context = context;
+	sourceCount = 0;
+}
+
+void StaticBatch::Add(World& world, EntityId entity) {
+	world.GetTransform(entity)->Freeze();
+	sourceCount++;
+
+	std::shared_ptr<Material> material = world.GetRender(entity)->material;
+	for(Group& group : groups) {
+		if(group.material == material) {
+			group.entities.push_back(entity);
+			return;
+		}
+	}
+	groups.push_back({ material, { entity } });
+}
+
+void StaticBatch::Build(World& world) {
+	for(Group& group : groups) {
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+		size_t mergedCount = 0;
+		for(EntityId entity : group.entities) {
+			std::shared_ptr<Mesh> mesh = world.GetRender(entity)->mesh;
+			if(!CanMerge(mesh)) {
+				drawEntities.push_back(entity);
+				continue;
+			}
+			AppendTransformed(world.GetTransform(entity), mesh, vertices, indices);
+			world.Destroy(entity);
+			mergedCount++;
+		}
+
+		if(mergedCount == 0) {
+			continue;
+		}
+
+		// tangents get regenerated from the world space positions and uvs
+		EntityId batch = world.Create(HasTransform | HasRender);
+		RenderComponent* render = world.GetRender(batch);
+		render->mesh = std::make_shared<Mesh>(vertices.data(), (int)vertices.size(), indices.data(), (int)indices.size(), device, context);
+		render->material = group.material;
+		world.GetTransform(batch)->Freeze();
+		drawEntities.push_back(batch);
+	}
+	groups.clear();
+}
+
+const std::vector<EntityId>& StaticBatch::GetEntities() {
+	return drawEntities;
+}
+
+size_t StaticBatch::GetSourceCount() {
+	return sourceCount;
+}
+
+bool StaticBatch::CanMerge(std::shared_ptr<Mesh> mesh) {
+	return mesh->GetVertexFormat() == VertexFormatFull && mesh->GetData() && mesh->GetData()->IsValid();
+}
+
+void StaticBatch::AppendTransformed(Transform* transform, std::shared_ptr<Mesh> mesh, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+	std::shared_ptr<MeshData> data = mesh->GetData();
+	XMFLOAT4X4 worldFloats = transform->GetWorldMatrix();
+	XMFLOAT4X4 inverseTransposeFloats = transform->GetWorldInverseTransposeMatrix();
+	XMMATRIX world = XMLoadFloat4x4(&worldFloats);
+	XMMATRIX inverseTranspose = XMLoadFloat4x4(&inverseTransposeFloats);
+
+	unsigned int base = (unsigned int)vertices.size();
+	const Vertex* source = data->GetVertices();
+	for(int i = 0; i < data->GetVertexCount(); i++) {
+		Vertex vertex = source[i];
+		XMStoreFloat3(&vertex.Position, XMVector3TransformCoord(XMLoadFloat3(&source[i].Position), world));
+		XMStoreFloat3(&vertex.Normal, XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&source[i].Normal), inverseTranspose)));
+		XMStoreFloat3(&vertex.Tangent, XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&source[i].Tangent), world)));
+		vertices.push_back(vertex);
+	}
+
+	// a mirroring transform flips the winding, so swap two corners of each triangle back
+	bool mirrored = XMVectorGetX(XMMatrixDeterminant(world)) < 0.0f;
+	const unsigned int* sourceIndices = data->GetIndices();
+	for(int i = 0; i + 2 < data->GetIndexCount(); i += 3) {
+		indices.push_back(base + sourceIndices[i]);
+		indices.push_back(base + sourceIndices[mirrored ? i + 2 : i + 1]);
+		indices.push_back(base + sourceIndices[mirrored ? i + 1 : i + 2]);
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <vector>
+#include <memory>
+#include "World.h"
+#include "Mesh.h"
+#include "Material.h"
+
+// --------------------------------------------------------
+// Merges static entities that share a material into one
+// mesh at load time. Vertices are moved into world space on
+// the CPU, so each merged mesh draws with an identity world
+// matrix in a single call. The merged entities are replaced
+// in the World by one entity per material. Entities whose
+// mesh can't be merged (no CPU data, or quantized) are left
+// as they are, just frozen.
+// --------------------------------------------------------
+class StaticBatch
+{
+public:
+	StaticBatch(Microsoft::WRL::ComPtr<ID3D11Device> device, Microsoft::WRL::ComPtr<ID3D11DeviceContext> context);
+
+	// needs a transform and render component. Its transform is frozen right away
+	void Add(World& world, EntityId entity);
+
+	// destroys every entity it merged, so their ids stop being alive
+	void Build(World& world);
+
+	// the entities drawing what was added, merged or not
+	const std::vector<EntityId>& GetEntities();
+	size_t GetSourceCount();
+
+private:
+	struct Group
+	{
+		std::shared_ptr<Material> material;
+		std::vector<EntityId> entities;
+	};
+
+	Microsoft::WRL::ComPtr<ID3D11Device> device;
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext> context;
+	std::vector<Group> groups;
+	std::vector<EntityId> drawEntities;
+	size_t sourceCount;
+
+	static bool CanMerge(std::shared_ptr<Mesh> mesh);
+	static void AppendTransformed(Transform* transform, std::shared_ptr<Mesh> mesh, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+};
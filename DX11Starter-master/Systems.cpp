@@ -0,0 +1,314 @@
+#include "Systems.h"
+#include "Input.h"
+#include "Game.h"
+
+using namespace DirectX;
+
+void Systems::UpdatePlayers(World& world, float dt, EntityId ball) {
+	Input& input = Input::GetInstance();
+	Transform* ballTransform = world.GetTransform(ball);
+	BallComponent* ballState = world.GetBall(ball);
+
+	for(Archetype& archetype : world.GetArchetypes()) {
+		if(!archetype.Has(HasTransform | HasPlayer)) {
+			continue;
+		}
+
+		for(size_t i = 0; i < archetype.GetCount(); i++) {
+			Transform& transform = archetype.transforms[i];
+			PlayerComponent& player = archetype.players[i];
+			Vector3& velocity = player.velocity;
+			float maxSpeed = 13.0f;
+			float acceleration = 90.0f * dt;
+			float minY = 1.5f;
+
+			// accelerate from input
+			Vector3 moveDirection = Vector3();
+			if (input.KeyDown(VK_UP)) { moveDirection.z += 1; }
+			if (input.KeyDown(VK_DOWN)) { moveDirection.z -= 1; }
+			if (input.KeyDown(VK_LEFT)) {
+				moveDirection.x -= 1;
+				if(!input.KeyDown('W') && !input.KeyRelease('W')) { // don't release on the frame the player swings either
+					player.facingRight = false;
+				}
+			}
+			if (input.KeyDown(VK_RIGHT)) {
+				moveDirection.x += 1;
+				if(!input.KeyDown('W') && !input.KeyRelease('W')) {
+					player.facingRight = true;
+				}
+			}
+
+			if(!moveDirection.Equals(Vector3())) {
+				moveDirection.SetLength(acceleration);
+				velocity.Add(moveDirection);
+			}
+
+			if(transform.GetPosition().y <= minY) {
+				// apply friction
+				float friction = 40.0f;
+				Vector3 lastVel = velocity;
+				velocity.Add(-friction * dt);
+
+				// check if passed 0
+				if(lastVel.Dot(velocity) < 0) {
+					velocity.SetLength(0);
+				}
+			} else {
+				// apply gravity in air
+				if(input.KeyDown(VK_SPACE)) {
+					velocity.y -= 20 * dt; // extend jump height and fall slower
+				} else {
+					velocity.y -= 60 * dt; // regular gravity
+				}
+			}
+
+			// cap speed
+			Vector3 horVel = Vector3(velocity.x, 0, velocity.z);
+			if(input.KeyDown('W')) {
+				// move slower when holding a swing
+				maxSpeed /= 3.0f;
+			}
+			if(horVel.Length() > maxSpeed) {
+				horVel.SetLength(maxSpeed);
+				velocity = Vector3(horVel.x, velocity.y, horVel.z);
+			}
+
+			// jump
+			if(transform.GetPosition().y <= minY && input.KeyDown(VK_SPACE)) {
+				velocity.y = 20;  // jump velocity
+			}
+
+			// move
+			transform.MoveRelative(velocity.x * dt, velocity.y * dt, velocity.z * dt);
+
+			// lock player in court
+			XMFLOAT3 position = transform.GetPosition();
+			if(position.y < minY) { // floor
+				transform.SetPosition(position.x, minY, position.z);
+				position = transform.GetPosition();
+			}
+			if(position.x < -Game::AREA_HALF_WIDTH) { // left wall
+				transform.SetPosition(-Game::AREA_HALF_WIDTH, position.y, position.z);
+				position = transform.GetPosition();
+			}
+			else if(position.x > Game::AREA_HALF_WIDTH) { // right wall
+				transform.SetPosition(Game::AREA_HALF_WIDTH, position.y, position.z);
+				position = transform.GetPosition();
+			}
+			if(position.z > -1.0f) { // net
+				transform.SetPosition(position.x, position.y, -1.0f);
+			}
+			else if(position.z < -Game::AREA_HALF_HEIGHT) { // back wall
+				transform.SetPosition(position.x, position.y, -Game::AREA_HALF_HEIGHT);
+			}
+
+			// swing at ball
+			if(input.KeyRelease('W') && ballState) {
+				player.swingCooldown = 1.0f;
+
+				float reach = 2.0f;
+				if(!player.facingRight) {
+					reach *= -1; // swing left instead
+				}
+
+				// check sphere collision
+				XMFLOAT3 ballPosition = ballTransform->GetPosition();
+				float dx = ballPosition.x - position.x - reach;
+				float dy = ballPosition.y - position.y;
+				float dz = ballPosition.z - position.z;
+				float distSquared = dx * dx + dy * dy + dz * dz;
+				if(distSquared < 8) {
+					// hit ball
+					float aimer = 0.0f;
+					if(input.KeyDown(VK_RIGHT)) {
+						aimer = 4.0f;
+					}
+					if(input.KeyDown(VK_LEFT)) {
+						aimer = -4.0f;
+					}
+
+					aimer += dz * 3 * (player.facingRight ? -1 : 1);
+
+					if(position.y <= minY) {
+						HitBall(*ballState, Vector3(aimer, 8, 12), true); // ground stroke
+					} else {
+						HitBall(*ballState, Vector3(aimer, -1.5f * position.y, -3 * position.z + (position.z > -3.0f ? 2.0f : 0.0f)), true); // spike midair
+					}
+				}
+			}
+
+			if(player.swingCooldown > 0) {
+				player.swingCooldown -= dt;
+			}
+
+			// the racket is a child of the player, so it only moves itself when switching sides
+			for(EntityId partId : { player.racketHandle, player.racketHead }) {
+				Transform* part = world.GetTransform(partId);
+				if(!part) {
+					continue;
+				}
+				XMFLOAT3 local = part->GetPosition();
+				if((local.x > 0) != player.facingRight) {
+					part->SetPosition(-local.x, local.y, local.z);
+				}
+			}
+		}
+	}
+}
+
+int Systems::UpdateBalls(World& world, float dt) {
+	int result = 0;
+	float minY = 0.5f; // floor height
+
+	for(Archetype& archetype : world.GetArchetypes()) {
+		if(!archetype.Has(HasTransform | HasBall)) {
+			continue;
+		}
+
+		for(size_t i = 0; i < archetype.GetCount(); i++) {
+			Transform& transform = archetype.transforms[i];
+			BallComponent& ball = archetype.balls[i];
+			if(!ball.active) {
+				continue;
+			}
+
+			// apply gravity
+			if(dt < 1.0f) {
+				ball.velocity.y -= 10.0f * dt;
+			}
+
+			transform.MoveAbsolute(ball.velocity.x * dt, ball.velocity.y * dt, ball.velocity.z * dt);
+
+			// check for bounce
+			XMFLOAT3 position = transform.GetPosition();
+			if(position.y <= minY) {
+				transform.SetPosition(position.x, minY, position.z);
+				ball.velocity.y *= -1;
+
+				if(ball.hasBounced) {
+					// point ends from double bounce
+					ball.active = false;
+					result = (ball.playerHit ? 1 : -1);
+				}
+				else {
+					ball.hasBounced = true;
+
+					// check if bounced out of court
+					float buffer = 0.5f;
+					if(position.x < -Game::COURT_HALF_WIDTH - buffer// out left
+						|| position.x > Game::COURT_HALF_WIDTH + buffer // out right
+						|| position.z < -Game::COURT_HALF_HEIGHT - buffer// out back
+						|| position.z > Game::COURT_HALF_HEIGHT + buffer// out front
+					) {
+						ball.active = false;
+						result = (!ball.playerHit ? 1 : -1);
+					}
+
+					if(ball.playerHit && position.z < 0 || !ball.playerHit && position.z > 0) { // land in own court
+						ball.active = false;
+						result = (!ball.playerHit ? 1 : -1);
+					}
+				}
+			}
+
+			// check for net collision
+			if(abs(position.z) < 0.3f && abs(position.y) < 3.3f) {
+				ball.active = false;
+				result = (!ball.playerHit ? 1 : -1);
+			}
+
+			// a ball out of play isn't drawn
+			if(archetype.Has(HasRender)) {
+				archetype.renders[i].visible = ball.active;
+			}
+		}
+	}
+	return result;
+}
+
+void Systems::UpdateEnemies(World& world, float dt, EntityId ball) {
+	Transform* ballTransform = world.GetTransform(ball);
+	BallComponent* ballState = world.GetBall(ball);
+	if(!ballTransform || !ballState) {
+		return;
+	}
+	XMFLOAT3 ballPos = ballTransform->GetPosition();
+
+	for(Archetype& archetype : world.GetArchetypes()) {
+		if(!archetype.Has(HasTransform | HasEnemy)) {
+			continue;
+		}
+
+		for(size_t i = 0; i < archetype.GetCount(); i++) {
+			Transform& transform = archetype.transforms[i];
+			float enemSpeed = archetype.enemies[i].speed;
+
+			// move towards ball
+			XMFLOAT3 position = transform.GetPosition();
+			if(position.x > ballPos.x + 1.0f) {
+				transform.MoveAbsolute(-enemSpeed * dt, 0, 0);
+			}
+			else if(position.x < ballPos.x - 1.0f) {
+				transform.MoveAbsolute(enemSpeed * dt, 0, 0);
+			}
+
+			if(ballPos.z > Game::COURT_HALF_HEIGHT - 4.0f && ballPos.y > 3.0f && ballPos.y > position.y) { // jump to ball when it gets towards the back
+				transform.MoveAbsolute(0, 2 * enemSpeed * dt, 0);
+			}
+			else if (position.y > 1.5f) { // come back down when ball is gone
+				transform.MoveAbsolute(0, -2 * enemSpeed * dt, 0);
+			}
+
+			// hit ball when close
+			if(ballPos.z > Game::COURT_HALF_HEIGHT - 2.0f && ballPos.z < Game::COURT_HALF_HEIGHT + 2.0f
+				&& abs(ballPos.x - position.x) < 1.0f
+				&& abs(ballPos.y - position.y) < 2.0f
+			) {
+				float chanceChanger = 1.0f; // more likely to hit cross court
+				if(position.x > 0) {
+					chanceChanger *= -1;
+				}
+
+				HitBall(*ballState, Vector3(rand() % 1000 / 1000.0f * 8.0f - 4.0f + chanceChanger, 8, -13), false);
+			}
+		}
+	}
+}
+
+void Systems::SubmitRenderables(World& world, RenderQueue& queue, std::shared_ptr<Camera> camera) {
+	for(Archetype& archetype : world.GetArchetypes()) {
+		if(!archetype.Has(HasTransform | HasRender)) {
+			continue;
+		}
+
+		for(size_t i = 0; i < archetype.GetCount(); i++) {
+			if(archetype.renders[i].visible) {
+				queue.Submit(&archetype.transforms[i], archetype.renders[i], camera);
+			}
+		}
+	}
+}
+
+void Systems::HitBall(BallComponent& ball, Vector3 hit, bool fromPlayer) {
+	ball.playerHit = fromPlayer;
+	ball.hasBounced = false;
+	ball.velocity = hit;
+}
+
+void Systems::ServeBall(World& world, EntityId ball, XMFLOAT3 playerPosition) {
+	Transform* transform = world.GetTransform(ball);
+	BallComponent* state = world.GetBall(ball);
+	transform->SetPosition(playerPosition.x + 1.5f, playerPosition.y + 2.5f, playerPosition.z);
+	state->active = true;
+	state->velocity = Vector3(0, 12.0f, 0);
+
+	// make player lose if they miss the serve
+	state->playerHit = false;
+	state->hasBounced = true;
+
+	RenderComponent* render = world.GetRender(ball);
+	if(render) {
+		render->visible = true;
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <memory>
+#include "World.h"
+#include "Camera.h"
+#include "RenderQueue.h"
+
+// --------------------------------------------------------
+// The game's per-frame logic, one pass per kind of entity.
+// Each pass walks the archetypes that have its components
+// and loops over their arrays in order.
+// --------------------------------------------------------
+class Systems
+{
+public:
+	// input, movement and swinging at the ball
+	static void UpdatePlayers(World& world, float dt, EntityId ball);
+
+	// returns which side got a point: >0 player, <0 enemy, 0 no one
+	static int UpdateBalls(World& world, float dt);
+
+	// chases and returns the ball
+	static void UpdateEnemies(World& world, float dt, EntityId ball);
+
+	// every visible entity with a transform and something to draw
+	static void SubmitRenderables(World& world, RenderQueue& queue, std::shared_ptr<Camera> camera);
+
+	static void HitBall(BallComponent& ball, Vector3 hit, bool fromPlayer);
+	static void ServeBall(World& world, EntityId ball, DirectX::XMFLOAT3 playerPosition);
+};
@@ -0,0 +1,334 @@
+#include "TangentGenerator.h"
+#include <thread>
+#include <math.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define TANGENTS_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+using namespace DirectX;
+
+void TangentGenerator::Generate(Vertex* verts, int numVerts, const unsigned int* indices, int numIndices, unsigned int threadCount)
+{
+	int numTriangles = numIndices / 3;
+	if(threadCount == 0) {
+		threadCount = std::thread::hardware_concurrency();
+	}
+	unsigned int usefulThreads = (unsigned int)(numTriangles / TrianglesPerThread) + 1;
+	if(threadCount > usefulThreads) {
+		threadCount = usefulThreads;
+	}
+	if(threadCount < 1) {
+		threadCount = 1;
+	}
+
+	// each thread owns one set of sums, so there is nothing to race on
+	std::vector<Partial> partials(threadCount);
+	std::vector<std::thread> workers;
+	for(unsigned int t = 0; t < threadCount; t++) {
+		int first = (int)((long long)numTriangles * t / threadCount);
+		int last = (int)((long long)numTriangles * (t + 1) / threadCount);
+		Partial& sums = partials[t];
+		sums.x.assign(numVerts, 0.0f);
+		sums.y.assign(numVerts, 0.0f);
+		sums.z.assign(numVerts, 0.0f);
+		if(t + 1 == threadCount) {
+			AccumulateTriangles(verts, indices, first, last, sums);
+		} else {
+			workers.emplace_back(AccumulateTriangles, verts, indices, first, last, std::ref(sums));
+		}
+	}
+	for(std::thread& worker : workers) {
+		worker.join();
+	}
+
+	// reduce in thread order and orthonormalize, split by vertex range
+	workers.clear();
+	for(unsigned int t = 0; t < threadCount; t++) {
+		int first = (int)((long long)numVerts * t / threadCount);
+		int last = (int)((long long)numVerts * (t + 1) / threadCount);
+		if(t + 1 == threadCount) {
+			Orthonormalize(verts, partials, first, last);
+		} else {
+			workers.emplace_back(Orthonormalize, verts, std::cref(partials), first, last);
+		}
+	}
+	for(std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+// --------------------------------------------------------
+// Adds each triangle's tangent to its three vertices.
+// The SSE path handles four triangles per iteration with the
+// same operations in the same order as the scalar code, so a
+// single thread produces exactly the reference sums.
+// --------------------------------------------------------
+void TangentGenerator::AccumulateTriangles(const Vertex* verts, const unsigned int* indices, int firstTriangle, int lastTriangle, Partial& sums)
+{
+	float* sumX = sums.x.data();
+	float* sumY = sums.y.data();
+	float* sumZ = sums.z.data();
+	int tri = firstTriangle;
+
+#ifdef TANGENTS_USE_SSE
+	alignas(16) float lanes[10][4];
+	alignas(16) float tangentX[4];
+	alignas(16) float tangentY[4];
+	alignas(16) float tangentZ[4];
+	for(; tri + 4 <= lastTriangle; tri += 4) {
+		// gather the AoS vertices into SoA lanes
+		for(int lane = 0; lane < 4; lane++) {
+			const unsigned int* triangle = &indices[(tri + lane) * 3];
+			const Vertex& v1 = verts[triangle[0]];
+			const Vertex& v2 = verts[triangle[1]];
+			const Vertex& v3 = verts[triangle[2]];
+			lanes[0][lane] = v1.Position.x;
+			lanes[1][lane] = v1.Position.y;
+			lanes[2][lane] = v1.Position.z;
+			lanes[3][lane] = v2.Position.x;
+			lanes[4][lane] = v2.Position.y;
+			lanes[5][lane] = v2.Position.z;
+			lanes[6][lane] = v3.Position.x;
+			lanes[7][lane] = v3.Position.y;
+			lanes[8][lane] = v3.Position.z;
+			lanes[9][lane] = 0.0f;
+		}
+		__m128 x1 = _mm_sub_ps(_mm_load_ps(lanes[3]), _mm_load_ps(lanes[0]));
+		__m128 y1 = _mm_sub_ps(_mm_load_ps(lanes[4]), _mm_load_ps(lanes[1]));
+		__m128 z1 = _mm_sub_ps(_mm_load_ps(lanes[5]), _mm_load_ps(lanes[2]));
+		__m128 x2 = _mm_sub_ps(_mm_load_ps(lanes[6]), _mm_load_ps(lanes[0]));
+		__m128 y2 = _mm_sub_ps(_mm_load_ps(lanes[7]), _mm_load_ps(lanes[1]));
+		__m128 z2 = _mm_sub_ps(_mm_load_ps(lanes[8]), _mm_load_ps(lanes[2]));
+
+		for(int lane = 0; lane < 4; lane++) {
+			const unsigned int* triangle = &indices[(tri + lane) * 3];
+			const Vertex& v1 = verts[triangle[0]];
+			const Vertex& v2 = verts[triangle[1]];
+			const Vertex& v3 = verts[triangle[2]];
+			lanes[0][lane] = v1.UV.x;
+			lanes[1][lane] = v1.UV.y;
+			lanes[2][lane] = v2.UV.x;
+			lanes[3][lane] = v2.UV.y;
+			lanes[4][lane] = v3.UV.x;
+			lanes[5][lane] = v3.UV.y;
+		}
+		__m128 s1 = _mm_sub_ps(_mm_load_ps(lanes[2]), _mm_load_ps(lanes[0]));
+		__m128 t1 = _mm_sub_ps(_mm_load_ps(lanes[3]), _mm_load_ps(lanes[1]));
+		__m128 s2 = _mm_sub_ps(_mm_load_ps(lanes[4]), _mm_load_ps(lanes[0]));
+		__m128 t2 = _mm_sub_ps(_mm_load_ps(lanes[5]), _mm_load_ps(lanes[1]));
+
+		__m128 r = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sub_ps(_mm_mul_ps(s1, t2), _mm_mul_ps(s2, t1)));
+		_mm_store_ps(tangentX, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(t2, x1), _mm_mul_ps(t1, x2)), r));
+		_mm_store_ps(tangentY, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(t2, y1), _mm_mul_ps(t1, y2)), r));
+		_mm_store_ps(tangentZ, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(t2, z1), _mm_mul_ps(t1, z2)), r));
+
+		// scatter in triangle order, lanes can share vertices
+		for(int lane = 0; lane < 4; lane++) {
+			const unsigned int* triangle = &indices[(tri + lane) * 3];
+			for(int corner = 0; corner < 3; corner++) {
+				sumX[triangle[corner]] += tangentX[lane];
+				sumY[triangle[corner]] += tangentY[lane];
+				sumZ[triangle[corner]] += tangentZ[lane];
+			}
+		}
+	}
+#endif
+
+	// leftover triangles (or everything without SSE)
+	for(; tri < lastTriangle; tri++) {
+		const unsigned int* triangle = &indices[tri * 3];
+		const Vertex& v1 = verts[triangle[0]];
+		const Vertex& v2 = verts[triangle[1]];
+		const Vertex& v3 = verts[triangle[2]];
+
+		float x1 = v2.Position.x - v1.Position.x;
+		float y1 = v2.Position.y - v1.Position.y;
+		float z1 = v2.Position.z - v1.Position.z;
+		float x2 = v3.Position.x - v1.Position.x;
+		float y2 = v3.Position.y - v1.Position.y;
+		float z2 = v3.Position.z - v1.Position.z;
+
+		float s1 = v2.UV.x - v1.UV.x;
+		float t1 = v2.UV.y - v1.UV.y;
+		float s2 = v3.UV.x - v1.UV.x;
+		float t2 = v3.UV.y - v1.UV.y;
+
+		float r = 1.0f / (s1 * t2 - s2 * t1);
+		float tx = (t2 * x1 - t1 * x2) * r;
+		float ty = (t2 * y1 - t1 * y2) * r;
+		float tz = (t2 * z1 - t1 * z2) * r;
+
+		for(int corner = 0; corner < 3; corner++) {
+			sumX[triangle[corner]] += tx;
+			sumY[triangle[corner]] += ty;
+			sumZ[triangle[corner]] += tz;
+		}
+	}
+}
+
+// --------------------------------------------------------
+// Sums the partials in thread order, then Gram-Schmidt
+// orthonormalizes against the normal, four vertices per
+// SSE iteration. Zero length tangents stay zero, which is
+// what XMVector3Normalize does in the reference.
+// --------------------------------------------------------
+void TangentGenerator::Orthonormalize(Vertex* verts, const std::vector<Partial>& partials, int firstVertex, int lastVertex)
+{
+	int v = firstVertex;
+
+#ifdef TANGENTS_USE_SSE
+	alignas(16) float lanes[6][4];
+	for(; v + 4 <= lastVertex; v += 4) {
+		__m128 tx = _mm_loadu_ps(&partials[0].x[v]);
+		__m128 ty = _mm_loadu_ps(&partials[0].y[v]);
+		__m128 tz = _mm_loadu_ps(&partials[0].z[v]);
+		for(size_t p = 1; p < partials.size(); p++) {
+			tx = _mm_add_ps(tx, _mm_loadu_ps(&partials[p].x[v]));
+			ty = _mm_add_ps(ty, _mm_loadu_ps(&partials[p].y[v]));
+			tz = _mm_add_ps(tz, _mm_loadu_ps(&partials[p].z[v]));
+		}
+
+		for(int lane = 0; lane < 4; lane++) {
+			lanes[0][lane] = verts[v + lane].Normal.x;
+			lanes[1][lane] = verts[v + lane].Normal.y;
+			lanes[2][lane] = verts[v + lane].Normal.z;
+		}
+		__m128 nx = _mm_load_ps(lanes[0]);
+		__m128 ny = _mm_load_ps(lanes[1]);
+		__m128 nz = _mm_load_ps(lanes[2]);
+
+		__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, tx), _mm_mul_ps(ny, ty)), _mm_mul_ps(nz, tz));
+		tx = _mm_sub_ps(tx, _mm_mul_ps(nx, dot));
+		ty = _mm_sub_ps(ty, _mm_mul_ps(ny, dot));
+		tz = _mm_sub_ps(tz, _mm_mul_ps(nz, dot));
+
+		__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty)), _mm_mul_ps(tz, tz)));
+		__m128 nonZero = _mm_cmpneq_ps(length, _mm_setzero_ps());
+		_mm_store_ps(lanes[3], _mm_and_ps(_mm_div_ps(tx, length), nonZero));
+		_mm_store_ps(lanes[4], _mm_and_ps(_mm_div_ps(ty, length), nonZero));
+		_mm_store_ps(lanes[5], _mm_and_ps(_mm_div_ps(tz, length), nonZero));
+
+		for(int lane = 0; lane < 4; lane++) {
+			verts[v + lane].Tangent = XMFLOAT3(lanes[3][lane], lanes[4][lane], lanes[5][lane]);
+		}
+	}
+#endif
+
+	for(; v < lastVertex; v++) {
+		float tx = partials[0].x[v];
+		float ty = partials[0].y[v];
+		float tz = partials[0].z[v];
+		for(size_t p = 1; p < partials.size(); p++) {
+			tx += partials[p].x[v];
+			ty += partials[p].y[v];
+			tz += partials[p].z[v];
+		}
+
+		const XMFLOAT3& n = verts[v].Normal;
+		float dot = (n.x * tx + n.y * ty) + n.z * tz;
+		tx -= n.x * dot;
+		ty -= n.y * dot;
+		tz -= n.z * dot;
+
+		float length = sqrtf((tx * tx + ty * ty) + tz * tz);
+		if(length != 0.0f) {
+			verts[v].Tangent = XMFLOAT3(tx / length, ty / length, tz / length);
+		} else {
+			verts[v].Tangent = XMFLOAT3(0, 0, 0);
+		}
+	}
+}
+
+// --------------------------------------------------------
+// Author: Chris Cascioli
+// Purpose: Calculates the tangents of the vertices in a mesh
+// 
+// - You are allowed to directly copy/paste this into your code base
+//   for assignments, given that you clearly cite that this is not
+//   code of your own design.
+//
+// - Code originally adapted from: http://www.terathon.com/code/tangent.html
+//   - Updated version now found here: http://foundationsofgameenginedev.com/FGED2-sample.pdf
+//   - See listing 7.4 in section 7.5 (page 9 of the PDF)
+//
+// - Note: For this code to work, your Vertex format must
+//         contain an XMFLOAT3 called Tangent
+//
+// - Be sure to call this BEFORE creating your D3D vertex/index buffers
+//
+// Kept as the scalar reference that Generate() must agree with
+// --------------------------------------------------------
+void TangentGenerator::GenerateReference(Vertex* verts, int numVerts, const unsigned int* indices, int numIndices)
+{
+	// Reset tangents
+	for (int i = 0; i < numVerts; i++)
+	{
+		verts[i].Tangent = XMFLOAT3(0, 0, 0);
+	}
+
+	// Calculate tangents one whole triangle at a time
+	for (int i = 0; i < numIndices;)
+	{
+		// Grab indices and vertices of first triangle
+		unsigned int i1 = indices[i++];
+		unsigned int i2 = indices[i++];
+		unsigned int i3 = indices[i++];
+		Vertex* v1 = &verts[i1];
+		Vertex* v2 = &verts[i2];
+		Vertex* v3 = &verts[i3];
+
+		// Calculate vectors relative to triangle positions
+		float x1 = v2->Position.x - v1->Position.x;
+		float y1 = v2->Position.y - v1->Position.y;
+		float z1 = v2->Position.z - v1->Position.z;
+
+		float x2 = v3->Position.x - v1->Position.x;
+		float y2 = v3->Position.y - v1->Position.y;
+		float z2 = v3->Position.z - v1->Position.z;
+
+		// Do the same for vectors relative to triangle uv's
+		float s1 = v2->UV.x - v1->UV.x;
+		float t1 = v2->UV.y - v1->UV.y;
+
+		float s2 = v3->UV.x - v1->UV.x;
+		float t2 = v3->UV.y - v1->UV.y;
+
+		// Create vectors for tangent calculation
+		float r = 1.0f / (s1 * t2 - s2 * t1);
+
+		float tx = (t2 * x1 - t1 * x2) * r;
+		float ty = (t2 * y1 - t1 * y2) * r;
+		float tz = (t2 * z1 - t1 * z2) * r;
+
+		// Adjust tangents of each vert of the triangle
+		v1->Tangent.x += tx;
+		v1->Tangent.y += ty;
+		v1->Tangent.z += tz;
+
+		v2->Tangent.x += tx;
+		v2->Tangent.y += ty;
+		v2->Tangent.z += tz;
+
+		v3->Tangent.x += tx;
+		v3->Tangent.y += ty;
+		v3->Tangent.z += tz;
+	}
+
+	// Ensure all of the tangents are orthogonal to the normals
+	for (int i = 0; i < numVerts; i++)
+	{
+		// Grab the two vectors
+		XMVECTOR normal = XMLoadFloat3(&verts[i].Normal);
+		XMVECTOR tangent = XMLoadFloat3(&verts[i].Tangent);
+
+		// Use Gram-Schmidt orthonormalize to ensure
+		// the normal and tangent are exactly 90 degrees apart
+		tangent = XMVector3Normalize(
+			tangent - normal * XMVector3Dot(normal, tangent));
+
+		// Store the tangent
+		XMStoreFloat3(&verts[i].Tangent, tangent);
+	}
+}
\ No newline at end of file
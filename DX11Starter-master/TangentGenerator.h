@@ -0,0 +1,29 @@
+#pragma once
+#include <vector>
+#include "Vertex.h"
+
+// Computes per-vertex tangents from positions and uvs.
+// Generate() gathers four triangles at a time into SSE lanes and splits
+// the triangles across threads, each accumulating into its own partial
+// sums that are then added up in thread order, so results do not depend
+// on scheduling. Falls back to plain floats on non-x86 builds.
+class TangentGenerator
+{
+public:
+	static void Generate(Vertex* verts, int numVerts, const unsigned int* indices, int numIndices, unsigned int threadCount = 0);
+	static void GenerateReference(Vertex* verts, int numVerts, const unsigned int* indices, int numIndices);
+
+	// meshes with fewer triangles than this per thread stay on one thread
+	static const int TrianglesPerThread = 16384;
+
+private:
+	struct Partial
+	{
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<float> z;
+	};
+
+	static void AccumulateTriangles(const Vertex* verts, const unsigned int* indices, int firstTriangle, int lastTriangle, Partial& sums);
+	static void Orthonormalize(Vertex* verts, const std::vector<Partial>& partials, int firstVertex, int lastVertex);
+};
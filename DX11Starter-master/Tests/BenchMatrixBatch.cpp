@@ -0,0 +1,70 @@
+#include "Benchmark.h"
+#include "MatrixBatch.h"
+#include <stdio.h>
+#include <string.h>
+#include <random>
+#include <vector>
+
+using namespace DirectX;
+
+// the per object path RenderQueue replaced: both matrices loaded for every object
+static void MultiplyEach(const XMFLOAT4X4* left, size_t count, const XMFLOAT4X4& right, XMFLOAT4X4* out)
+{
+	for(size_t i = 0; i < count; i++) {
+		XMStoreFloat4x4(&out[i], XMMatrixMultiply(XMLoadFloat4x4(&left[i]), XMLoadFloat4x4(&right)));
+	}
+}
+
+static void MultiplyScalar(const XMFLOAT4X4* left, size_t count, const XMFLOAT4X4& right, XMFLOAT4X4* out)
+{
+	for(size_t i = 0; i < count; i++) {
+		for(int row = 0; row < 4; row++) {
+			for(int column = 0; column < 4; column++) {
+				out[i].m[row][column] =
+					left[i].m[row][0] * right.m[0][column] + left[i].m[row][1] * right.m[1][column] +
+					left[i].m[row][2] * right.m[2][column] + left[i].m[row][3] * right.m[3][column];
+			}
+		}
+	}
+}
+
+// --------------------------------------------------------
+// World * viewProjection for 1k, 10k and 100k objects:
+// MatrixBatch::Multiply against loading both matrices per
+// object and against plain scalar code, in ns per object
+// --------------------------------------------------------
+int main()
+{
+	std::mt19937 random(20);
+	std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+	XMFLOAT4X4 viewProjection;
+	for(int i = 0; i < 16; i++) {
+		(&viewProjection._11)[i] = value(random);
+	}
+
+	printf("%-8s %12s %12s %12s\n", "objects", "batch", "per object", "scalar");
+	for(size_t count : { 1000, 10000, 100000 }) {
+		std::vector<XMFLOAT4X4> worlds(count);
+		for(XMFLOAT4X4& world : worlds) {
+			for(int i = 0; i < 16; i++) {
+				(&world._11)[i] = value(random);
+			}
+		}
+		std::vector<XMFLOAT4X4> batched(count);
+		std::vector<XMFLOAT4X4> each(count);
+		std::vector<XMFLOAT4X4> scalar(count);
+
+		double batch = MeasureMilliseconds(21, [&]() { MatrixBatch::Multiply(worlds.data(), count, viewProjection, batched.data()); });
+		double perObject = MeasureMilliseconds(21, [&]() { MultiplyEach(worlds.data(), count, viewProjection, each.data()); });
+		double plain = MeasureMilliseconds(21, [&]() { MultiplyScalar(worlds.data(), count, viewProjection, scalar.data()); });
+
+		// the batch has to give exactly what loading per object does
+		if(memcmp(batched.data(), each.data(), count * sizeof(XMFLOAT4X4)) != 0) {
+			printf("batch and per object results differ\n");
+			return 1;
+		}
+
+		printf("%-8zu %9.2f ns %9.2f ns %9.2f ns\n", count, batch * 1e6 / count, perObject * 1e6 / count, plain * 1e6 / count);
+	}
+	return 0;
+}
@@ -0,0 +1,36 @@
+#include "Benchmark.h"
+#include "TestCheck.h"
+#include "MeshData.h"
+#include <stdio.h>
+#include <string>
+
+// --------------------------------------------------------
+// MeshData::Load with no cache (parse, weld, optimize,
+// tangents, then write the cache) against loading the same
+// mesh from its cache, with what the vertex cache optimizer
+// did to ACMR and ATVR. Runs on copies so Assets/ stays clean.
+// --------------------------------------------------------
+int main()
+{
+	printf("%-12s %10s %10s %10s %8s %14s %14s\n", "model", "vertices", "cold ms", "warm ms", "speedup", "acmr", "atvr");
+	for(const char* model : { "sphere.obj", "torus.obj", "helix.obj" }) {
+		std::string objPath = CopyAsset((std::string("Models/") + model).c_str(), (std::string("bench_") + model).c_str());
+		std::string cachePath = objPath + ".meshcache";
+		int vertexCount = 0;
+		CacheStats stats = {};
+
+		double cold = MeasureMilliseconds(9, [&]() {
+			remove(cachePath.c_str());
+			std::shared_ptr<MeshData> data = MeshData::Load(objPath.c_str());
+			vertexCount = data->GetVertexCount();
+			stats = data->cacheStats;
+		});
+		double warm = MeshData::Load(objPath.c_str())->source[0] == 'c' ? MeasureMilliseconds(51, [&]() {
+			MeshData::Load(objPath.c_str());
+		}) : 0.0;
+
+		printf("%-12s %10d %10.3f %10.3f %7.1fx %6.3f->%6.3f %6.3f->%6.3f\n", model, vertexCount, cold, warm, warm > 0.0 ? cold / warm : 0.0,
+			stats.acmrBefore, stats.acmrAfter, stats.atvrBefore, stats.atvrAfter);
+	}
+	return 0;
+}
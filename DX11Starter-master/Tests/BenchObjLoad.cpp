@@ -0,0 +1,110 @@
+#include "Benchmark.h"
+#include "ObjParser.h"
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace DirectX;
+
+// --------------------------------------------------------
+// The getline/sscanf loader Mesh used to have, kept here
+// as the baseline. Triangles and quads with v/vt/vn or
+// v//vn corners only, which is all it ever handled.
+// --------------------------------------------------------
+static bool LoadWithSscanf(const char* fileName, std::vector<Vertex>& verts, std::vector<unsigned int>& indices)
+{
+	std::ifstream obj(fileName);
+	if(!obj.is_open()) {
+		return false;
+	}
+
+	std::vector<XMFLOAT3> positions;
+	std::vector<XMFLOAT3> normals;
+	std::vector<XMFLOAT2> uvs;
+	unsigned int indexCounter = 0;
+	char chars[100];
+
+	while(obj.good()) {
+		obj.getline(chars, 100);
+
+		if(chars[0] == 'v' && chars[1] == 'n') {
+			XMFLOAT3 norm;
+			sscanf(chars, "vn %f %f %f", &norm.x, &norm.y, &norm.z);
+			normals.push_back(norm);
+		}
+		else if(chars[0] == 'v' && chars[1] == 't') {
+			XMFLOAT2 uv;
+			sscanf(chars, "vt %f %f", &uv.x, &uv.y);
+			uvs.push_back(uv);
+		}
+		else if(chars[0] == 'v') {
+			XMFLOAT3 pos;
+			sscanf(chars, "v %f %f %f", &pos.x, &pos.y, &pos.z);
+			positions.push_back(pos);
+		}
+		else if(chars[0] == 'f') {
+			unsigned int i[12];
+			int numbersRead = sscanf(chars, "f %u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u",
+				&i[0], &i[1], &i[2], &i[3], &i[4], &i[5], &i[6], &i[7], &i[8], &i[9], &i[10], &i[11]);
+			if(numbersRead == 1) {
+				numbersRead = sscanf(chars, "f %u//%u %u//%u %u//%u %u//%u", &i[0], &i[2], &i[3], &i[5], &i[6], &i[8], &i[9], &i[11]);
+				i[1] = i[4] = i[7] = i[10] = 1;
+				if(uvs.size() == 0) {
+					uvs.push_back(XMFLOAT2(0, 0));
+				}
+			}
+
+			Vertex corner[4] = {};
+			int cornerCount = (numbersRead == 12 || numbersRead == 8 ? 4 : 3);
+			for(int c = 0; c < cornerCount; c++) {
+				corner[c].Position = positions[i[c * 3] - 1];
+				corner[c].UV = uvs[i[c * 3 + 1] - 1];
+				corner[c].Normal = normals[i[c * 3 + 2] - 1];
+				corner[c].UV.y = 1.0f - corner[c].UV.y;
+				corner[c].Position.z *= -1.0f;
+				corner[c].Normal.z *= -1.0f;
+			}
+
+			verts.push_back(corner[0]);
+			verts.push_back(corner[2]);
+			verts.push_back(corner[1]);
+			if(cornerCount == 4) {
+				verts.push_back(corner[0]);
+				verts.push_back(corner[3]);
+				verts.push_back(corner[2]);
+			}
+			while(indexCounter < verts.size()) {
+				indices.push_back(indexCounter++);
+			}
+		}
+	}
+	return true;
+}
+
+int main()
+{
+	printf("%-12s %10s %12s %12s %8s\n", "model", "vertices", "sscanf ms", "parser ms", "speedup");
+	for(const char* model : { "sphere.obj", "torus.obj", "helix.obj" }) {
+		std::string path = std::string(ASSETS_DIR) + "Models/" + model;
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+
+		double oldTime = MeasureMilliseconds(15, [&]() {
+			vertices.clear();
+			indices.clear();
+			LoadWithSscanf(path.c_str(), vertices, indices);
+		});
+		std::vector<Vertex> oldVertices = vertices;
+
+		double newTime = MeasureMilliseconds(15, [&]() {
+			vertices.clear();
+			indices.clear();
+			ObjParser::Load(path.c_str(), vertices, indices);
+		});
+
+		bool same = oldVertices.size() == vertices.size() && memcmp(oldVertices.data(), vertices.data(), vertices.size() * sizeof(Vertex)) == 0;
+		printf("%-12s %10zu %12.3f %12.3f %7.1fx%s\n", model, vertices.size(), oldTime, newTime, oldTime / newTime, same ? "" : "  (output differs!)");
+	}
+	return 0;
+}
@@ -0,0 +1,47 @@
+#include "Benchmark.h"
+#include "RadixSort.h"
+#include <stdio.h>
+#include <random>
+
+// --------------------------------------------------------
+// RadixSort against std::sort and std::stable_sort on the
+// key, for render queue shaped keys: a couple of hundred
+// distinct states above random 24 bit depths. Every run
+// sorts a fresh copy of the same unsorted items.
+// --------------------------------------------------------
+int main()
+{
+	std::mt19937_64 random(16);
+	auto byKey = [](const RenderItem& a, const RenderItem& b) { return a.key < b.key; };
+	printf("%-8s %12s %12s %14s\n", "items", "radix", "std::sort", "stable_sort");
+
+	for(size_t count : { 10000, 100000 }) {
+		std::vector<RenderItem> unsorted(count);
+		for(size_t i = 0; i < count; i++) {
+			uint64_t state = random() % 200;
+			uint64_t depth = random() & 0xFFFFFF;
+			unsorted[i] = { ((state * 0x9E3779B97F4A7C15ull) & 0xFFFFFFFFFF000000ull) | depth, nullptr, nullptr, nullptr, (unsigned int)i };
+		}
+
+		std::vector<RenderItem> items;
+		std::vector<RenderItem> scratch;
+		double radix = MeasureMilliseconds(21, [&]() {
+			items = unsorted;
+			RadixSort::Sort(items, scratch);
+		});
+		double quick = MeasureMilliseconds(21, [&]() {
+			items = unsorted;
+			std::sort(items.begin(), items.end(), byKey);
+		});
+		double stable = MeasureMilliseconds(21, [&]() {
+			items = unsorted;
+			std::stable_sort(items.begin(), items.end(), byKey);
+		});
+		double copy = MeasureMilliseconds(21, [&]() {
+			items = unsorted;
+		});
+
+		printf("%-8zu %9.3f ms %9.3f ms %11.3f ms   (copy %.3f ms each)\n", count, radix, quick, stable, copy);
+	}
+	return 0;
+}
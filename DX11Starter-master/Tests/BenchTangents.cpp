@@ -0,0 +1,39 @@
+#include "Benchmark.h"
+#include "TestMeshes.h"
+#include "TangentGenerator.h"
+#include <stdio.h>
+#include <thread>
+
+// --------------------------------------------------------
+// Triangles per second for the scalar reference, Generate()
+// on one thread (SSE only) and Generate() on every core
+// --------------------------------------------------------
+int main()
+{
+	unsigned int cores = std::thread::hardware_concurrency();
+	printf("%-10s %12s %14s %14s %14s\n", "triangles", "", "reference", "1 thread", "all threads");
+
+	for(int size : { 100, 300, 1000 }) {
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+		MakeGrid(size, vertices, indices);
+		int vertexCount = (int)vertices.size();
+		int indexCount = (int)indices.size();
+		double triangles = indexCount / 3.0;
+
+		double reference = MeasureMilliseconds(7, [&]() {
+			TangentGenerator::GenerateReference(vertices.data(), vertexCount, indices.data(), indexCount);
+		});
+		double single = MeasureMilliseconds(7, [&]() {
+			TangentGenerator::Generate(vertices.data(), vertexCount, indices.data(), indexCount, 1);
+		});
+		double threaded = MeasureMilliseconds(7, [&]() {
+			TangentGenerator::Generate(vertices.data(), vertexCount, indices.data(), indexCount, cores);
+		});
+
+		printf("%-10.0f %12s %11.1f M/s %11.1f M/s %11.1f M/s\n", triangles, "",
+			triangles / reference / 1000.0, triangles / single / 1000.0, triangles / threaded / 1000.0);
+	}
+	printf("(%u cores)\n", cores);
+	return 0;
+}
@@ -0,0 +1,55 @@
+#include "Benchmark.h"
+#include "TransformPool.h"
+#include <stdio.h>
+#include <random>
+#include <thread>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// Rebuilding every matrix after all of 1k, 10k and 100k
+// transforms moved: UpdateEachDirty() (the old one matrix
+// at a time path) against UpdateDirty() on one thread and
+// on every core. Setting the components isn't timed.
+// --------------------------------------------------------
+int main()
+{
+	std::mt19937 random(21);
+	std::uniform_real_distribution<float> value(-7.0f, 7.0f);
+	std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+	unsigned int cores = std::thread::hardware_concurrency();
+
+	printf("%-10s %14s %14s %14s\n", "transforms", "each dirty", "1 thread", "all threads");
+	for(unsigned int count : { 1000u, 10000u, 100000u }) {
+		TransformPool pool;
+		std::vector<unsigned int> slots;
+		std::vector<XMFLOAT3> positions;
+		std::vector<XMFLOAT3> rotations;
+		std::vector<XMFLOAT3> scales;
+		for(unsigned int i = 0; i < count; i++) {
+			slots.push_back(pool.Allocate());
+			positions.push_back(XMFLOAT3(value(random), value(random), value(random)));
+			rotations.push_back(XMFLOAT3(value(random), value(random), value(random)));
+			scales.push_back(XMFLOAT3(scale(random), scale(random), scale(random)));
+		}
+		auto moveAll = [&]() {
+			for(unsigned int i = 0; i < count; i++) {
+				pool.SetPosition(slots[i], positions[i]);
+				pool.SetPitchYawRoll(slots[i], rotations[i]);
+				pool.SetScale(slots[i], scales[i]);
+			}
+		};
+
+		double each = MeasureMilliseconds(15, moveAll, [&]() { pool.UpdateEachDirty(); });
+		double single = MeasureMilliseconds(15, moveAll, [&]() { pool.UpdateDirty(1); });
+		double threaded = MeasureMilliseconds(15, moveAll, [&]() { pool.UpdateDirty(0); });
+		if(pool.GetDirtyCount() != 0) {
+			printf("slots left dirty\n");
+			return 1;
+		}
+
+		printf("%-10u %11.3f ms %11.3f ms %11.3f ms\n", count, each, single, threaded);
+	}
+	printf("(%u cores)\n", cores);
+	return 0;
+}
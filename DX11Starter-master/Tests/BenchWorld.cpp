@@ -0,0 +1,120 @@
+#include "Benchmark.h"
+#include "World.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <random>
+
+using namespace DirectX;
+
+// the layout World replaced: every entity its own heap object holding a
+// transform and the shared pointers, reached through a vector of pointers
+struct HeapEntity
+{
+	Transform transform;
+	std::shared_ptr<Mesh> mesh;
+	std::shared_ptr<Material> material;
+	BallComponent ball;
+};
+
+// what SubmitRenderables hands the queue per entity
+struct Gathered
+{
+	Transform* transform;
+	Mesh* mesh;
+	Material* material;
+};
+
+// --------------------------------------------------------
+// The two loops the systems run every frame, over 2k, 10k
+// and 50k entities: the SubmitRenderables gather and an
+// UpdateBalls style move by velocity. Systems.cpp needs the
+// window and input, so the loops are copied here. The heap
+// entities are allocated between other allocations and then
+// shuffled, like a list that has been played with a while.
+// --------------------------------------------------------
+int main()
+{
+	std::mt19937 random(25);
+	std::uniform_real_distribution<float> value(-50.0f, 50.0f);
+	const float dt = 1.0f / 60.0f;
+
+	printf("%-9s %14s %14s %14s %14s\n", "entities", "gather heap", "gather world", "move heap", "move world");
+	for(unsigned int count : { 2000u, 10000u, 50000u }) {
+		World world;
+		std::vector<HeapEntity*> heap;
+		std::vector<void*> noise;
+		for(unsigned int i = 0; i < count; i++) {
+			XMFLOAT3 position(value(random), value(random), value(random));
+			Vector3 velocity(value(random), value(random), value(random));
+
+			EntityId id = world.Create(HasTransform | HasRender | HasBall);
+			world.GetTransform(id)->SetPosition(position.x, position.y, position.z);
+			world.GetBall(id)->velocity = velocity;
+			world.GetBall(id)->active = true;
+
+			heap.push_back(new HeapEntity());
+			heap.back()->transform.SetPosition(position.x, position.y, position.z);
+			heap.back()->ball.velocity = velocity;
+			heap.back()->ball.active = true;
+			noise.push_back(malloc(16 + random() % 200));
+		}
+		std::shuffle(heap.begin(), heap.end(), random);
+
+		std::vector<Gathered> gathered;
+		gathered.reserve(count);
+		double gatherHeap = MeasureMilliseconds(101, [&]() {
+			gathered.clear();
+			for(HeapEntity* entity : heap) {
+				gathered.push_back({ &entity->transform, entity->mesh.get(), entity->material.get() });
+			}
+		});
+		double gatherWorld = MeasureMilliseconds(101, [&]() {
+			gathered.clear();
+			for(Archetype& archetype : world.GetArchetypes()) {
+				if(!archetype.Has(HasTransform | HasRender)) {
+					continue;
+				}
+				for(size_t i = 0; i < archetype.GetCount(); i++) {
+					if(archetype.renders[i].visible) {
+						gathered.push_back({ &archetype.transforms[i], archetype.renders[i].mesh.get(), archetype.renders[i].material.get() });
+					}
+				}
+			}
+		});
+
+		double moveHeap = MeasureMilliseconds(31, [&]() {
+			for(HeapEntity* entity : heap) {
+				if(entity->ball.active) {
+					Vector3 velocity = entity->ball.velocity;
+					entity->transform.MoveAbsolute(velocity.x * dt, velocity.y * dt, velocity.z * dt);
+				}
+			}
+		});
+		double moveWorld = MeasureMilliseconds(31, [&]() {
+			for(Archetype& archetype : world.GetArchetypes()) {
+				if(!archetype.Has(HasTransform | HasBall)) {
+					continue;
+				}
+				for(size_t i = 0; i < archetype.GetCount(); i++) {
+					BallComponent& ball = archetype.balls[i];
+					if(ball.active) {
+						archetype.transforms[i].MoveAbsolute(ball.velocity.x * dt, ball.velocity.y * dt, ball.velocity.z * dt);
+					}
+				}
+			}
+		});
+		if(gathered.size() != count) {
+			printf("gathered %zu of %u\n", gathered.size(), count);
+			return 1;
+		}
+
+		printf("%-9u %11.3f ms %11.3f ms %11.3f ms %11.3f ms\n", count, gatherHeap, gatherWorld, moveHeap, moveWorld);
+		for(HeapEntity* entity : heap) {
+			delete entity;
+		}
+		for(void* block : noise) {
+			free(block);
+		}
+	}
+	return 0;
+}
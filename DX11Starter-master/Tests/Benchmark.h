@@ -0,0 +1,37 @@
+#pragma once
+#include <chrono>
+#include <algorithm>
+#include <vector>
+
+// --------------------------------------------------------
+// Runs work() repeats times and returns the median in
+// milliseconds, which shrugs off the odd slow run better
+// than the mean does.
+// --------------------------------------------------------
+template<typename Work>
+double MeasureMilliseconds(int repeats, Work work)
+{
+	std::vector<double> times;
+	for(int i = 0; i < repeats; i++) {
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		work();
+		times.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+	}
+	std::sort(times.begin(), times.end());
+	return times[times.size() / 2];
+}
+
+// same, with setup() run before every repeat and left out of the time
+template<typename Setup, typename Work>
+double MeasureMilliseconds(int repeats, Setup setup, Work work)
+{
+	std::vector<double> times;
+	for(int i = 0; i < repeats; i++) {
+		setup();
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		work();
+		times.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+	}
+	std::sort(times.begin(), times.end());
+	return times[times.size() / 2];
+}
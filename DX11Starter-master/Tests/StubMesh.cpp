@@ -0,0 +1,11 @@
+#include "StubMesh.h"
+
+DirectX::BoundingBox GetMeshBoundingBox(Mesh& mesh)
+{
+	return mesh.box;
+}
+
+DirectX::BoundingSphere GetMeshBoundingSphere(Mesh& mesh)
+{
+	return mesh.sphere;
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include "Components.h"
+
+// --------------------------------------------------------
+// Stands in for Mesh in tests that use the World without a
+// device. Only the local bounds are there, and they're set
+// directly rather than computed from vertices.
+// --------------------------------------------------------
+class Mesh
+{
+public:
+	DirectX::BoundingBox box;
+	DirectX::BoundingSphere sphere;
+};
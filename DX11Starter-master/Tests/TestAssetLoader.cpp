@@ -0,0 +1,90 @@
+#include "TestCheck.h"
+#include "AssetLoader.h"
+#include "MappedFile.h"
+#include "PngDecoder.h"
+#include <string.h>
+#include <string>
+
+// the asset paths are plain ASCII
+static std::wstring Wide(const std::string& text)
+{
+	return std::wstring(text.begin(), text.end());
+}
+
+// --------------------------------------------------------
+// The worker pool without a device: mesh and image futures
+// give what the synchronous loads do, however many workers
+// there are, queued jobs finish before the loader is gone,
+// and missing files come back empty rather than throwing
+// --------------------------------------------------------
+int main()
+{
+	const char* models[] = { "sphere.obj", "torus.obj", "helix.obj", "cube.obj", "cylinder.obj" };
+	const char* textures[] = { "pixel.png", "normal.png", "PBR/wood_albedo.png", "PBR/paint_normals.png", "PBR/asteroid.png", "PBR/cobblestone_metal.png" };
+
+	// what the workers should come up with
+	std::vector<std::string> objPaths;
+	std::vector<std::shared_ptr<MeshData>> expectedMeshes;
+	for(const char* model : models) {
+		objPaths.push_back(CopyAsset((std::string("Models/") + model).c_str(), (std::string("loader_") + model).c_str()));
+		std::string referencePath = CopyAsset((std::string("Models/") + model).c_str(), (std::string("loader_reference_") + model).c_str());
+		remove((referencePath + ".meshcache").c_str());
+		expectedMeshes.push_back(MeshData::Load(referencePath.c_str()));
+		CHECK(expectedMeshes.back()->IsValid());
+	}
+	std::vector<std::vector<unsigned char>> expectedPixels;
+	for(const char* texture : textures) {
+		MappedFile file((std::string(ASSETS_DIR) + "Textures/" + texture).c_str());
+		unsigned int width, height;
+		expectedPixels.push_back(std::vector<unsigned char>());
+		CHECK(PngDecoder::Decode((const unsigned char*)file.GetData(), file.GetSize(), width, height, expectedPixels.back()));
+	}
+
+	for(unsigned int threads : { 1u, 3u, 0u }) {
+		for(const std::string& objPath : objPaths) {
+			remove((objPath + ".meshcache").c_str());
+		}
+
+		std::vector<std::future<std::shared_ptr<MeshData>>> meshes;
+		std::vector<std::future<std::shared_ptr<ImageData>>> images;
+		std::future<std::shared_ptr<MeshData>> missingMesh;
+		std::future<std::shared_ptr<ImageData>> missingImage;
+		{
+			AssetLoader loader(threads);
+			for(const std::string& objPath : objPaths) {
+				meshes.push_back(loader.LoadMesh(objPath));
+			}
+			for(const char* texture : textures) {
+				images.push_back(loader.DecodeImage(Wide(std::string(ASSETS_DIR) + "Textures/" + texture)));
+			}
+			missingMesh = loader.LoadMesh(std::string(OUTPUT_DIR) + "missing.obj");
+			missingImage = loader.DecodeImage(Wide(std::string(OUTPUT_DIR) + "missing.png"));
+
+			// the first one waited on while the rest are still queued or running
+			CHECK(meshes[0].get()->GetVertexCount() == expectedMeshes[0]->GetVertexCount());
+			meshes[0] = loader.LoadMesh(objPaths[0]);
+		}
+
+		// the loader is gone, everything it was given still finished
+		for(size_t i = 0; i < meshes.size(); i++) {
+			std::shared_ptr<MeshData> mesh = meshes[i].get();
+			std::shared_ptr<MeshData> expected = expectedMeshes[i];
+			CHECK(mesh->IsValid());
+			CHECK(mesh->GetVertexCount() == expected->GetVertexCount() && mesh->GetIndexCount() == expected->GetIndexCount());
+			CHECK(memcmp(mesh->GetVertices(), expected->GetVertices(), expected->GetVertexCount() * sizeof(Vertex)) == 0);
+			CHECK(memcmp(mesh->GetIndices(), expected->GetIndices(), expected->GetIndexCount() * sizeof(unsigned int)) == 0);
+		}
+		for(size_t i = 0; i < images.size(); i++) {
+			std::shared_ptr<ImageData> image = images[i].get();
+			CHECK(image->width > 0 && image->height > 0);
+			CHECK(image->pixels.size() == (size_t)image->width * image->height * 4);
+			CHECK(image->pixels == expectedPixels[i]);
+			CHECK(image->fileName == Wide(std::string(ASSETS_DIR) + "Textures/" + textures[i]));
+		}
+		CHECK(!missingMesh.get()->IsValid());
+		std::shared_ptr<ImageData> missing = missingImage.get();
+		CHECK(missing->width == 0 && missing->height == 0 && missing->pixels.empty());
+	}
+
+	return CheckResult();
+}
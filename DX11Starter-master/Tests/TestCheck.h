@@ -0,0 +1,39 @@
+#pragma once
+#include <stdio.h>
+#include <string>
+#include <fstream>
+
+// --------------------------------------------------------
+// Just enough for the headless tests: a failed CHECK prints
+// where it was and the test carries on, then main() returns
+// CheckResult() so ctest sees the failure.
+// --------------------------------------------------------
+static int checkFailures = 0;
+
+#define CHECK(condition) \
+	do { \
+		if(!(condition)) { \
+			printf("%s(%d): CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+			checkFailures++; \
+		} \
+	} while(0)
+
+inline int CheckResult()
+{
+	if(checkFailures > 0) {
+		printf("%d check(s) failed\n", checkFailures);
+		return 1;
+	}
+	printf("passed\n");
+	return 0;
+}
+
+// tests that write files (mesh caches) work on copies in the build directory
+inline std::string CopyAsset(const char* assetPath, const char* copyName)
+{
+	std::string copyPath = std::string(OUTPUT_DIR) + copyName;
+	std::ifstream in(std::string(ASSETS_DIR) + assetPath, std::ios::binary);
+	std::ofstream out(copyPath, std::ios::binary | std::ios::trunc);
+	out << in.rdbuf();
+	return copyPath;
+}
@@ -0,0 +1,252 @@
+#include "TestCheck.h"
+#include "ConstantBufferRing.h"
+#include <string.h>
+#include <vector>
+
+// --------------------------------------------------------
+// Stands in for the GPU: the buffer is plain memory and a
+// fence completes when the test says so, or when the ring
+// waits on it
+// --------------------------------------------------------
+class StubDevice : public IConstantBufferDevice
+{
+public:
+	struct Bind
+	{
+		unsigned int slot;
+		unsigned int firstConstant;
+		unsigned int numConstants;
+	};
+
+	bool supported = true;
+	std::vector<unsigned char> buffer;
+	std::vector<bool> mapDiscards;
+	std::vector<Bind> binds;
+	std::vector<uint64_t> signaled;
+	uint64_t gpuFrame = 0; // last fence the "GPU" is past
+	int waits = 0;
+
+	bool CreateBuffer(unsigned int size) {
+		buffer.resize(size);
+		return supported;
+	}
+
+	unsigned char* Map(bool discard) {
+		mapDiscards.push_back(discard);
+		return buffer.data();
+	}
+
+	void Unmap() {}
+
+	void BindVS(unsigned int slot, unsigned int firstConstant, unsigned int numConstants) {
+		binds.push_back({ slot, firstConstant, numConstants });
+	}
+
+	void SignalFence(uint64_t frame) {
+		signaled.push_back(frame);
+	}
+
+	bool IsFenceComplete(uint64_t frame, bool wait) {
+		if(frame <= gpuFrame) {
+			return true;
+		}
+		if(wait) {
+			waits++;
+			gpuFrame = frame;
+			return true;
+		}
+		return false;
+	}
+};
+
+static void TestAllocatorAlignment()
+{
+	// sizes round up to whole 256 byte blocks, so ranges are back to back blocks
+	RingAllocator ring(4096);
+	CHECK(ring.GetCapacity() == 4096);
+	size_t expected = 0;
+	for(size_t size : { 1, 16, 200, 256, 257, 600, 0, 512 }) {
+		size_t offset = 1;
+		bool wrapped = false;
+		CHECK(ring.Allocate(size, offset, wrapped));
+		CHECK(offset % 256 == 0);
+		CHECK(offset == expected);
+		CHECK(wrapped == (offset == 0));
+		size_t blocks = size == 0 ? 1 : (size + 255) / 256;
+		expected += blocks * 256;
+	}
+	CHECK(ring.GetUsed() == expected);
+
+	// a capacity that isn't a whole number of blocks is rounded down
+	RingAllocator uneven(1000);
+	CHECK(uneven.GetCapacity() == 768);
+}
+
+static void TestAllocatorRetire()
+{
+	size_t offset;
+	bool wrapped;
+	RingAllocator ring(1024);
+	for(int i = 0; i < 4; i++) {
+		CHECK(ring.Allocate(256, offset, wrapped));
+	}
+	CHECK(!ring.Allocate(1, offset, wrapped));
+	ring.EndFrame(1);
+	CHECK(ring.GetFramesInFlight() == 1);
+
+	// nothing comes back until the frame's fence has
+	ring.Retire(0);
+	CHECK(ring.GetUsed() == 1024);
+	CHECK(!ring.Allocate(1, offset, wrapped));
+
+	ring.Retire(1);
+	CHECK(ring.GetUsed() == 0);
+	CHECK(ring.GetFramesInFlight() == 0);
+	CHECK(ring.Allocate(256, offset, wrapped));
+
+	// retiring an older frame leaves the newer one's space alone
+	RingAllocator frames(1024);
+	CHECK(frames.Allocate(512, offset, wrapped));
+	frames.EndFrame(1);
+	CHECK(frames.Allocate(256, offset, wrapped));
+	frames.EndFrame(2);
+	frames.Retire(1);
+	CHECK(frames.GetUsed() == 256);
+	CHECK(frames.GetFramesInFlight() == 1);
+}
+
+static void TestAllocatorWrap()
+{
+	size_t offset;
+	bool wrapped;
+	RingAllocator ring(1024);
+	CHECK(ring.Allocate(512, offset, wrapped) && offset == 0);
+	ring.EndFrame(1);
+	CHECK(ring.Allocate(256, offset, wrapped) && offset == 512 && !wrapped);
+	ring.EndFrame(2);
+	ring.Retire(1);
+
+	// 256 left at the end isn't enough, so it wraps and the end is skipped
+	CHECK(ring.Allocate(512, offset, wrapped));
+	CHECK(offset == 0 && wrapped);
+	CHECK(ring.GetUsed() == 1024);
+	CHECK(!ring.Allocate(1, offset, wrapped));
+	ring.EndFrame(3);
+
+	// the skipped end belongs to frame 3, frame 2's block is the only free one
+	ring.Retire(2);
+	CHECK(ring.GetUsed() == 768);
+	CHECK(ring.Allocate(256, offset, wrapped));
+	CHECK(offset == 512 && !wrapped);
+	CHECK(!ring.Allocate(1, offset, wrapped));
+	ring.EndFrame(4);
+
+	ring.Retire(4);
+	CHECK(ring.GetUsed() == 0);
+}
+
+static void TestRingUnsupported()
+{
+	unsigned char data[64] = {};
+	ConstantBufferRing none(nullptr);
+	CHECK(!none.IsSupported());
+	CHECK(!none.BindVS(1, data, sizeof(data)));
+	CHECK(none.GetFallbackCount() == 1);
+
+	std::shared_ptr<StubDevice> device = std::make_shared<StubDevice>();
+	device->supported = false;
+	ConstantBufferRing ring(device);
+	CHECK(!ring.IsSupported());
+	ring.BeginFrame();
+	CHECK(!ring.BindVS(1, data, sizeof(data)));
+	ring.EndFrame();
+	CHECK(device->mapDiscards.empty());
+	CHECK(device->binds.empty());
+	CHECK(device->signaled.empty());
+}
+
+static void TestRingBinds()
+{
+	std::shared_ptr<StubDevice> device = std::make_shared<StubDevice>();
+	ConstantBufferRing ring(device, 4096);
+	CHECK(ring.IsSupported());
+	CHECK(device->buffer.size() == 4096);
+
+	unsigned char small[64];
+	unsigned char large[300];
+	memset(small, 0xAB, sizeof(small));
+	memset(large, 0xCD, sizeof(large));
+
+	ring.BeginFrame();
+	CHECK(ring.BindVS(1, small, sizeof(small)));
+	CHECK(ring.BindVS(1, large, sizeof(large)));
+	CHECK(ring.BindVS(2, small, sizeof(small)));
+	ring.EndFrame();
+
+	// offsets and sizes in constants, whole 256 byte blocks
+	CHECK(device->binds.size() == 3);
+	CHECK(device->binds[0].slot == 1 && device->binds[0].firstConstant == 0 && device->binds[0].numConstants == 16);
+	CHECK(device->binds[1].slot == 1 && device->binds[1].firstConstant == 16 && device->binds[1].numConstants == 32);
+	CHECK(device->binds[2].slot == 2 && device->binds[2].firstConstant == 48 && device->binds[2].numConstants == 16);
+	CHECK(device->buffer[0] == 0xAB && device->buffer[63] == 0xAB);
+	CHECK(device->buffer[256] == 0xCD && device->buffer[256 + 299] == 0xCD);
+	CHECK(device->buffer[768] == 0xAB);
+
+	// the first map of a dynamic buffer has to discard, later ones append
+	CHECK(device->mapDiscards.size() == 3);
+	CHECK(device->mapDiscards[0] && !device->mapDiscards[1] && !device->mapDiscards[2]);
+	CHECK(device->signaled.size() == 1 && device->signaled[0] == 1);
+	CHECK(ring.GetBoundCount() == 3);
+}
+
+static void TestRingFrames()
+{
+	// four 256 byte binds a frame fill a 4096 byte ring in exactly four frames
+	std::shared_ptr<StubDevice> device = std::make_shared<StubDevice>();
+	ConstantBufferRing ring(device, 4096);
+	unsigned char data[256] = {};
+	for(int frame = 1; frame <= 4; frame++) {
+		ring.BeginFrame();
+		for(int i = 0; i < 4; i++) {
+			CHECK(ring.BindVS(1, data, sizeof(data)));
+		}
+		ring.EndFrame();
+	}
+	CHECK(device->waits == 0);
+	CHECK(ring.GetWrapCount() == 1); // only the very first bind
+
+	// a fifth frame in flight has to wait for the first, and then reuses its space
+	ring.BeginFrame();
+	CHECK(device->waits == 1);
+	CHECK(device->gpuFrame == 1);
+	CHECK(ring.BindVS(1, data, sizeof(data)));
+	CHECK(device->binds.back().firstConstant == 0);
+	CHECK(device->mapDiscards.back());
+	CHECK(ring.GetWrapCount() == 2);
+	ring.EndFrame();
+
+	// frames the GPU has finished are retired without waiting
+	device->gpuFrame = 4;
+	ring.BeginFrame();
+	CHECK(device->waits == 1);
+	for(int i = 0; i < 15; i++) {
+		CHECK(ring.BindVS(1, data, sizeof(data)));
+	}
+
+	// frame 5's block is still in flight, so the ring is full and the caller falls back
+	CHECK(!ring.BindVS(1, data, sizeof(data)));
+	CHECK(ring.GetFallbackCount() == 1);
+	ring.EndFrame();
+	CHECK(device->signaled.size() == 6);
+}
+
+int main()
+{
+	TestAllocatorAlignment();
+	TestAllocatorRetire();
+	TestAllocatorWrap();
+	TestRingUnsupported();
+	TestRingBinds();
+	TestRingFrames();
+	return CheckResult();
+}
@@ -0,0 +1,94 @@
+#include "TestCheck.h"
+#include "TransformPool.h"
+#include <math.h>
+#include <random>
+
+using namespace DirectX;
+
+// worst angle in degrees between normals put through the pool's inverse transpose and
+// through the general one, both normalized since the pool's is only right up to length
+static float WorstNormalError(TransformPool& pool, unsigned int slot, std::mt19937& random)
+{
+	XMFLOAT4X4 worldFloats = pool.GetWorldMatrix(slot);
+	XMFLOAT4X4 analyticFloats = pool.GetWorldInverseTransposeMatrix(slot);
+	XMMATRIX general = XMMatrixInverse(nullptr, XMMatrixTranspose(XMLoadFloat4x4(&worldFloats)));
+	XMMATRIX analytic = XMLoadFloat4x4(&analyticFloats);
+
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	float worst = 0.0f;
+	for(int i = 0; i < 64; i++) {
+		XMVECTOR normal = XMVector3Normalize(XMVectorSet(unit(random), unit(random), unit(random), 0.0f));
+		XMVECTOR expected = XMVector3Normalize(XMVector3TransformNormal(normal, general));
+		XMVECTOR actual = XMVector3Normalize(XMVector3TransformNormal(normal, analytic));
+		float cosine = fminf(fmaxf(XMVectorGetX(XMVector3Dot(expected, actual)), -1.0f), 1.0f);
+		worst = fmaxf(worst, acosf(cosine) * 57.2957795f);
+	}
+	return worst;
+}
+
+// --------------------------------------------------------
+// The pool builds the inverse transpose from the rotation
+// and scale instead of inverting. Normals through it have to
+// point the same way as through the general inverse, for
+// uniform, uneven and mirrored scale and through parents.
+// --------------------------------------------------------
+int main()
+{
+	std::mt19937 random(24);
+	const float tolerance = 0.05f; // degrees
+	XMFLOAT3 rotation(0.4f, -1.1f, 2.3f);
+	XMFLOAT3 scales[] = {
+		XMFLOAT3(1, 1, 1),
+		XMFLOAT3(3, 3, 3), // uniform
+		XMFLOAT3(0.25f, 0.25f, 0.25f),
+		XMFLOAT3(1, 3, 0.5f), // uneven
+		XMFLOAT3(4, 0.2f, 1),
+		XMFLOAT3(-2, -2, -2), // mirrored uniform
+		XMFLOAT3(-1, -1, -1),
+		XMFLOAT3(-1, 1, 1), // mirrored on one axis
+		XMFLOAT3(2, -3, 0.5f),
+		XMFLOAT3(-1, -2, -3),
+	};
+
+	// single transforms, through both the SIMD pass and the one slot path
+	for(const XMFLOAT3& scale : scales) {
+		TransformPool pool;
+		unsigned int batched = pool.Allocate();
+		unsigned int single = pool.Allocate();
+		for(unsigned int slot : { batched, single }) {
+			pool.SetPosition(slot, XMFLOAT3(3, -2, 8));
+			pool.SetPitchYawRoll(slot, rotation);
+			pool.SetScale(slot, scale);
+		}
+		pool.UpdateDirty(1);
+		CHECK(WorstNormalError(pool, batched, random) < tolerance);
+		pool.SetScale(single, scale);
+		CHECK(WorstNormalError(pool, single, random) < tolerance);
+	}
+
+	// a chain of three, every combination of scales on the links
+	for(const XMFLOAT3& rootScale : scales) {
+		for(const XMFLOAT3& childScale : scales) {
+			TransformPool pool;
+			unsigned int root = pool.Allocate();
+			unsigned int child = pool.Allocate();
+			unsigned int grandchild = pool.Allocate();
+			pool.SetPosition(root, XMFLOAT3(1, 2, 3));
+			pool.SetPitchYawRoll(root, XMFLOAT3(0.3f, 0.9f, -0.2f));
+			pool.SetScale(root, rootScale);
+			pool.SetPosition(child, XMFLOAT3(-4, 0, 1));
+			pool.SetPitchYawRoll(child, rotation);
+			pool.SetScale(child, childScale);
+			pool.SetPosition(grandchild, XMFLOAT3(0, 1, 0));
+			pool.SetPitchYawRoll(grandchild, XMFLOAT3(-0.7f, 0.1f, 1.5f));
+			pool.SetScale(grandchild, XMFLOAT3(-1.5f, -1.5f, -1.5f));
+			pool.SetParent(child, root, false);
+			pool.SetParent(grandchild, child, false);
+			pool.UpdateDirty(1);
+			CHECK(WorstNormalError(pool, child, random) < tolerance);
+			CHECK(WorstNormalError(pool, grandchild, random) < tolerance);
+		}
+	}
+
+	return CheckResult();
+}
@@ -0,0 +1,123 @@
+#include "TestCheck.h"
+#include "MeshData.h"
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+static std::vector<char> ReadFile(const std::string& path)
+{
+	std::ifstream in(path, std::ios::binary);
+	return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static void WriteFile(const std::string& path, const std::vector<char>& bytes)
+{
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	out.write(bytes.data(), bytes.size());
+}
+
+static bool SameMesh(MeshData& a, MeshData& b)
+{
+	return a.GetVertexCount() == b.GetVertexCount()
+		&& a.GetIndexCount() == b.GetIndexCount()
+		&& memcmp(a.GetVertices(), b.GetVertices(), a.GetVertexCount() * sizeof(Vertex)) == 0
+		&& memcmp(a.GetIndices(), b.GetIndices(), a.GetIndexCount() * sizeof(unsigned int)) == 0;
+}
+
+// --------------------------------------------------------
+// A cache that doesn't match its source exactly has to be
+// ignored, with the mesh parsed again and the cache rewritten
+// --------------------------------------------------------
+int main()
+{
+	std::string objPath = CopyAsset("Models/sphere.obj", "cache_sphere.obj");
+	std::string cachePath = objPath + ".meshcache";
+	remove(cachePath.c_str());
+
+	std::shared_ptr<MeshData> parsed = MeshData::Load(objPath.c_str());
+	CHECK(parsed->IsValid());
+	CHECK(strcmp(parsed->source, "obj") == 0);
+	std::vector<char> goodCache = ReadFile(cachePath);
+	CHECK(goodCache.size() > sizeof(MeshCacheHeader));
+
+	std::shared_ptr<MeshData> cached = MeshData::Load(objPath.c_str());
+	CHECK(strcmp(cached->source, "cache") == 0);
+	CHECK(SameMesh(*parsed, *cached));
+
+	// the optimizer's before and after come from the header, not a rerun over the cached order
+	CHECK(parsed->cacheStats.acmrAfter < parsed->cacheStats.acmrBefore);
+	CHECK(memcmp(&cached->cacheStats, &parsed->cacheStats, sizeof(CacheStats)) == 0);
+	cached.reset();
+
+	// cut short in the index data, and in the header
+	for(size_t keep : { goodCache.size() - 7, sizeof(MeshCacheHeader) - 4, (size_t)0 }) {
+		WriteFile(cachePath, std::vector<char>(goodCache.begin(), goodCache.begin() + keep));
+		std::shared_ptr<MeshData> truncated = MeshData::Load(objPath.c_str());
+		CHECK(strcmp(truncated->source, "obj") == 0);
+		CHECK(SameMesh(*parsed, *truncated));
+		CHECK(ReadFile(cachePath) == goodCache);
+	}
+
+	// an older format version
+	std::vector<char> oldVersion = goodCache;
+	((MeshCacheHeader*)oldVersion.data())->version = MeshCache::Version - 1;
+	WriteFile(cachePath, oldVersion);
+	std::shared_ptr<MeshData> versioned = MeshData::Load(objPath.c_str());
+	CHECK(strcmp(versioned->source, "obj") == 0);
+	CHECK(SameMesh(*parsed, *versioned));
+	versioned.reset();
+
+	// the source changed after the cache was written
+	{
+		std::ofstream obj(objPath, std::ios::binary | std::ios::app);
+		obj << "\nv 9 9 9\n";
+	}
+	std::shared_ptr<MeshData> stale = MeshData::Load(objPath.c_str());
+	CHECK(strcmp(stale->source, "obj") == 0);
+	CHECK(SameMesh(*parsed, *stale));
+	stale.reset();
+	std::shared_ptr<MeshData> rewritten = MeshData::Load(objPath.c_str());
+	CHECK(strcmp(rewritten->source, "cache") == 0);
+	CHECK(SameMesh(*parsed, *rewritten));
+	rewritten.reset();
+
+#ifndef _WIN32
+	// regenerated within the same second at the same size, only the fraction tells
+	{
+		struct timespec times[2] = { { 1700000000, 100000000 }, { 1700000000, 100000000 } };
+		CHECK(utimensat(AT_FDCWD, objPath.c_str(), times, 0) == 0);
+		std::shared_ptr<MeshData> stamped = MeshData::Load(objPath.c_str());
+		CHECK(strcmp(stamped->source, "obj") == 0);
+		stamped.reset();
+		CHECK(strcmp(MeshData::Load(objPath.c_str())->source, "cache") == 0);
+
+		std::vector<char> obj = ReadFile(objPath);
+		obj[obj.size() - 2] = '8'; // the "v 9 9 9" added above
+		WriteFile(objPath, obj);
+		times[0].tv_nsec = times[1].tv_nsec = 600000000;
+		CHECK(utimensat(AT_FDCWD, objPath.c_str(), times, 0) == 0);
+		std::shared_ptr<MeshData> sameSecond = MeshData::Load(objPath.c_str());
+		CHECK(strcmp(sameSecond->source, "obj") == 0);
+		CHECK(sameSecond->GetVertexCount() == parsed->GetVertexCount());
+	}
+#endif
+
+	// the cache holds the optimized order, so asking for the file order can't use it
+	std::shared_ptr<MeshData> unoptimized = MeshData::Load(objPath.c_str(), false);
+	CHECK(strcmp(unoptimized->source, "obj") == 0);
+	CHECK(!SameMesh(*parsed, *unoptimized));
+	std::shared_ptr<MeshData> unoptimizedCached = MeshData::Load(objPath.c_str(), false);
+	CHECK(strcmp(unoptimizedCached->source, "cache") == 0);
+	CHECK(SameMesh(*unoptimized, *unoptimizedCached));
+	unoptimizedCached.reset();
+	std::shared_ptr<MeshData> optimizedAgain = MeshData::Load(objPath.c_str(), true);
+	CHECK(strcmp(optimizedAgain->source, "obj") == 0);
+	CHECK(SameMesh(*parsed, *optimizedAgain));
+
+	return CheckResult();
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <math.h>
+#include <vector>
+#include "Vertex.h"
+
+// --------------------------------------------------------
+// A wavy, indexed size x size quad grid with normals and
+// uvs, for tests and benchmarks that need more triangles
+// than the models in Assets have. Vertices are shared, so
+// every inner vertex gets tangents from six triangles.
+// --------------------------------------------------------
+inline void MakeGrid(int size, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+	vertices.clear();
+	indices.clear();
+	vertices.reserve((size_t)(size + 1) * (size + 1));
+	indices.reserve((size_t)size * size * 6);
+
+	for(int y = 0; y <= size; y++) {
+		for(int x = 0; x <= size; x++) {
+			float u = (float)x / size;
+			float v = (float)y / size;
+			float height = 0.1f * sinf(u * 17.0f) * cosf(v * 11.0f);
+
+			Vertex vertex = {};
+			vertex.Position = DirectX::XMFLOAT3(u * 10.0f - 5.0f, height, v * 10.0f - 5.0f);
+			vertex.UV = DirectX::XMFLOAT2(u * 4.0f, v * 4.0f);
+
+			// slope of the height function, close enough to the real normal
+			float dx = 0.17f * cosf(u * 17.0f) * cosf(v * 11.0f);
+			float dz = -0.11f * sinf(u * 17.0f) * sinf(v * 11.0f);
+			float length = sqrtf(dx * dx + 1.0f + dz * dz);
+			vertex.Normal = DirectX::XMFLOAT3(-dx / length, 1.0f / length, -dz / length);
+			vertices.push_back(vertex);
+		}
+	}
+
+	for(int y = 0; y < size; y++) {
+		for(int x = 0; x < size; x++) {
+			unsigned int corner = y * (size + 1) + x;
+			unsigned int quad[] = { corner, corner + size + 1, corner + size + 2, corner, corner + size + 2, corner + 1 };
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	}
+}
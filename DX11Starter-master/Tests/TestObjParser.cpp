@@ -0,0 +1,196 @@
+#include "TestCheck.h"
+#include "ObjParser.h"
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <random>
+#include <string>
+#include <vector>
+
+// --------------------------------------------------------
+// ParseFloat against strtof. Each value becomes the x of a
+// position with a degenerate face on it, so it goes through
+// the public Parse() and comes out as vertex 3 * i.
+// --------------------------------------------------------
+static int CompareWithStrtof(const std::vector<std::string>& values)
+{
+	std::string obj;
+	for(const std::string& value : values) {
+		obj += "v " + value + " 0 0\nf -1 -1 -1\n";
+	}
+
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	ObjParser::Parse(obj.data(), obj.size(), vertices, indices);
+	CHECK(vertices.size() == values.size() * 3);
+	if(vertices.size() != values.size() * 3) {
+		return 1;
+	}
+
+	int mismatches = 0;
+	for(size_t i = 0; i < values.size(); i++) {
+		float expected = strtof(values[i].c_str(), nullptr);
+		float parsed = vertices[i * 3].Position.x;
+		if(memcmp(&expected, &parsed, sizeof(float)) != 0) {
+			if(mismatches < 10) {
+				printf("\"%s\": parsed %.9g, strtof %.9g\n", values[i].c_str(), parsed, expected);
+			}
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+static std::string Format(const char* format, double value)
+{
+	char text[128];
+	snprintf(text, sizeof(text), format, value);
+	return text;
+}
+
+// --------------------------------------------------------
+// A big random OBJ with everything the chunked parser has
+// to agree with the serial one on: n-gons (some past
+// MaxFaceCorners), relative and out of range indices, all
+// four corner forms, malformed and empty lines, CRLF, tabs,
+// and attributes declared between faces
+// --------------------------------------------------------
+static std::string GenerateObj(unsigned int seed, size_t targetSize)
+{
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	std::string obj;
+	int positions = 0;
+	int uvs = 0;
+	int normals = 0;
+
+	while(obj.size() < targetSize) {
+		for(int i = 0; i < 12; i++) {
+			obj += Format("v %f", unit(random) * 5) + Format(" %f", unit(random) * 5) + Format(" %f\n", unit(random) * 5);
+			positions++;
+			if(random() % 5 != 0) {
+				obj += Format("vt %f", unit(random)) + Format("\t%f\n", unit(random));
+				uvs++;
+			}
+			obj += Format("vn %f", unit(random)) + Format(" %f", unit(random)) + Format(" %f\r\n", unit(random));
+			normals++;
+		}
+
+		for(int i = 0; i < 16; i++) {
+			static const int cornerCounts[] = { 3, 3, 3, 4, 4, 5, 7, 12, 70 };
+			int cornerCount = cornerCounts[random() % 9];
+			std::string face = "f";
+			for(int c = 0; c < cornerCount; c++) {
+				int position = (random() % 4 == 0 ? -(int)(random() % (positions < 30 ? positions : 30)) - 1 : (int)(random() % positions) + 1);
+				int normal = (random() % 4 == 0 ? -(int)(random() % normals) - 1 : (int)(random() % normals) + 1);
+				int uv = (uvs > 0 ? (int)(random() % uvs) + 1 : 1);
+				switch(random() % 8) {
+				case 0: face += " " + std::to_string(position); break;
+				case 1: face += " " + std::to_string(position) + "//" + std::to_string(normal); break;
+				case 2: face += " " + std::to_string(position) + "/" + std::to_string(uv); break;
+				default: face += " " + std::to_string(position) + "/" + std::to_string(uv) + "/" + std::to_string(normal); break;
+				}
+			}
+			if(random() % 50 == 0) {
+				face += " " + std::to_string(positions + 40) + "/1/1"; // out of range, face is dropped
+			}
+			obj += face + (random() % 10 == 0 ? "\r\n" : "\n");
+		}
+
+		switch(random() % 12) {
+		case 0: obj += "# comment\n"; break;
+		case 1: obj += "\n\n"; break;
+		case 2: obj += "f\n"; break;
+		case 3: obj += "f \n"; break;
+		case 4: obj += "f 1/\n"; break;
+		case 5: obj += "f abc def ghi\n"; break;
+		case 6: obj += "f 0 1 2\n"; break;
+		case 7: obj += "v 1.5\n"; positions++; break;
+		case 8: obj += "vt\n"; break;
+		case 9: obj += "vn - - -\r\n"; normals++; break;
+		case 10: obj += "o part\ns off\nusemtl none\n"; break;
+		default: break;
+		}
+	}
+
+	obj += "f -1 -2 -3"; // no trailing newline
+	return obj;
+}
+
+static bool SameOutput(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<Vertex>& otherVertices, const std::vector<unsigned int>& otherIndices)
+{
+	return vertices.size() == otherVertices.size()
+		&& indices == otherIndices
+		&& memcmp(vertices.data(), otherVertices.data(), vertices.size() * sizeof(Vertex)) == 0;
+}
+
+int main()
+{
+	// hand picked: signs, ties, the float range edges, denormals, long mantissas
+	std::vector<std::string> edges = {
+		"0", "-0", "+0.0", "1", "-1", "0.1", "-0.923880", ".5", "5.", "+2.5", "1E5", "1e", "1e+", "2.5e-",
+		"16777216", "16777217", "16777219", "9007199254740993", "123456789012345678901234567890",
+		"1.000000059604644775390625", "1.0000000596046447753906249999", "1.00000005960464477539062500000000000000001",
+		"0.1000000000000000055511151231257827021181583404541015625",
+		"0.00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000001",
+		"3.4028234663852886e38", "3.4028235677973366e38", "3.4028236e38", "1e39", "-1e39",
+		"1.17549435e-38", "1.1754942e-38", "1e-38", "1.4e-45", "7.006492321624085e-46", "7e-46", "2.5e-45", "1e-50",
+		"1e99999999999", "1e-99999999999", "0.0e99999999999",
+		"1e22", "1e23", "1e-22", "1e-23", "4.7223665e21", "8.589973e9", "3.0000001192092896",
+	};
+	CHECK(CompareWithStrtof(edges) == 0);
+
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> magnitude(-8.0f, 8.0f);
+
+	// what exporters write: six decimals, and round tripping floats
+	std::vector<std::string> typical;
+	for(int i = 0; i < 20000; i++) {
+		float value = powf(10.0f, magnitude(random)) * (i % 2 ? -1.0f : 1.0f);
+		typical.push_back(Format("%.6f", value));
+		typical.push_back(Format("%.9g", value));
+		typical.push_back(Format("%.6e", value));
+	}
+	CHECK(CompareWithStrtof(typical) == 0);
+
+	// decimals next to the midpoint of two floats, which round to the
+	// midpoint itself in double. Rounding that to float again picks
+	// the even neighbour, which is the wrong one half of the time
+	std::vector<std::string> midpoints;
+	for(int i = 0; i < 20000; i++) {
+		float value = powf(10.0f, magnitude(random));
+		double midpoint = ((double)value + (double)nextafterf(value, INFINITY)) * 0.5;
+		midpoints.push_back(Format("%.17g", midpoint));
+		midpoints.push_back(Format("%.16g", midpoint));
+		midpoints.push_back(Format("%.40g", midpoint));
+		midpoints.push_back(Format("%.17g", nextafter(midpoint, 0.0)));
+		midpoints.push_back(Format("%.17g", nextafter(midpoint, INFINITY)));
+	}
+	CHECK(CompareWithStrtof(midpoints) == 0);
+
+	// indices that overflow an int are out of range, not wrapped around to valid ones
+	const char* overflow = "v 1 2 3\nf 1 1 1\nf 4294967297 1 1\nf 1 1 -4294967297\nf 99999999999999999999 1 1\n";
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	ObjParser::Parse(overflow, strlen(overflow), vertices, indices);
+	CHECK(vertices.size() == 3);
+
+	// ParseParallel has to match Parse exactly at any thread count, including
+	// counts that put chunk boundaries in odd places and more threads than chunks
+	for(unsigned int seed = 1; seed <= 4; seed++) {
+		std::string obj = GenerateObj(seed, 512 * 1024 + seed * 7919);
+		std::vector<Vertex> serialVertices;
+		std::vector<unsigned int> serialIndices;
+		CHECK(ObjParser::Parse(obj.data(), obj.size(), serialVertices, serialIndices));
+		CHECK(serialIndices.size() > 0);
+
+		for(unsigned int threads : { 2u, 3u, 4u, 7u, 16u, 64u }) {
+			std::vector<Vertex> parallelVertices;
+			std::vector<unsigned int> parallelIndices;
+			ObjParser::ParseParallel(obj.data(), obj.size(), parallelVertices, parallelIndices, threads);
+			CHECK(SameOutput(serialVertices, serialIndices, parallelVertices, parallelIndices));
+		}
+	}
+
+	return CheckResult();
+}
@@ -0,0 +1,164 @@
+#include "TestCheck.h"
+#include "PngDecoder.h"
+#include "MappedFile.h"
+#include <string.h>
+#include <string>
+#include <vector>
+
+// --------------------------------------------------------
+// Small PNGs covering what the assets don't: palettes, low
+// and 16 bit depths, color keys, every filter type, stored
+// and fixed Huffman blocks. Made with Python's zlib, with
+// the expected RGBA worked out next to them.
+// --------------------------------------------------------
+// 2 bit palette with tRNS, fixed Huffman codes
+static const unsigned char palette2Png[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x02, 0x02, 0x03, 0x00, 0x00, 0x00, 0xe0, 0x1a, 0x8e,
+	0x89, 0x00, 0x00, 0x00, 0x0c, 0x50, 0x4c, 0x54, 0x45, 0xff, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00,
+	0x00, 0xff, 0x0a, 0x14, 0x1e, 0x22, 0x88, 0x29, 0x04, 0x00, 0x00, 0x00, 0x03, 0x74, 0x52, 0x4e,
+	0x53, 0xff, 0x80, 0x00, 0x7f, 0x6d, 0x68, 0x78, 0x00, 0x00, 0x00, 0x0c, 0x49, 0x44, 0x41, 0x54,
+	0x78, 0xda, 0x63, 0x90, 0x60, 0x78, 0x02, 0x00, 0x01, 0x30, 0x00, 0xfd, 0x68, 0x30, 0xcf, 0xdf,
+	0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const unsigned char palette2Pixels[] = {
+	255, 0, 0, 255, 0, 255, 0, 128, 0, 0, 255, 0, 10, 20, 30, 255,
+	0, 0, 255, 0, 0, 255, 0, 128,
+};
+
+// 16 bit gray with a tRNS color key, stored (uncompressed) deflate blocks
+static const unsigned char gray16keyPng[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x02, 0x10, 0x00, 0x00, 0x00, 0x00, 0xe8, 0x8f, 0xe5,
+	0x85, 0x00, 0x00, 0x00, 0x02, 0x74, 0x52, 0x4e, 0x53, 0x12, 0x34, 0x2f, 0xd3, 0x49, 0x5e, 0x00,
+	0x00, 0x00, 0x19, 0x49, 0x44, 0x41, 0x54, 0x78, 0x01, 0x01, 0x0e, 0x00, 0xf1, 0xff, 0x00, 0x00,
+	0x00, 0x80, 0x00, 0xff, 0xff, 0x00, 0x12, 0x34, 0x00, 0xff, 0x80, 0x00, 0x1b, 0xea, 0x04, 0x44,
+	0x32, 0x8a, 0x45, 0x19, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const unsigned char gray16keyPixels[] = {
+	0, 0, 0, 255, 128, 128, 128, 255, 255, 255, 255, 255, 18, 18, 18, 0,
+	1, 1, 1, 255, 128, 128, 128, 255,
+};
+
+// 8 bit gray + alpha, one row per filter type
+static const unsigned char grayAlphaFilteredPng[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x05, 0x08, 0x04, 0x00, 0x00, 0x00, 0xc8, 0xa4, 0x85,
+	0x50, 0x00, 0x00, 0x00, 0x38, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0x2d, 0x00, 0xd2, 0xff,
+	0x00, 0x82, 0xb7, 0x0e, 0xee, 0x7f, 0x1a, 0x50, 0x39, 0x01, 0xbe, 0xf0, 0xc0, 0xd2, 0xb6, 0xbd,
+	0xd2, 0xef, 0x02, 0x12, 0x9f, 0xdf, 0x05, 0x1d, 0xa5, 0x41, 0x75, 0x03, 0xd8, 0xfc, 0xb2, 0x7d,
+	0x43, 0x5b, 0xfb, 0xad, 0x04, 0x54, 0x5d, 0x25, 0x25, 0xf2, 0xf6, 0x70, 0x43, 0xf0, 0xf3, 0x15,
+	0xc2, 0x32, 0xa5, 0x37, 0xf9, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60,
+	0x82,
+};
+static const unsigned char grayAlphaFilteredPixels[] = {
+	130, 130, 130, 183, 14, 14, 14, 238, 127, 127, 127, 26, 80, 80, 80, 57,
+	190, 190, 190, 240, 126, 126, 126, 194, 52, 52, 52, 127, 6, 6, 6, 110,
+	208, 208, 208, 143, 93, 93, 93, 199, 81, 81, 81, 36, 71, 71, 71, 227,
+	64, 64, 64, 67, 0, 0, 0, 2, 107, 107, 107, 110, 84, 84, 84, 85,
+	148, 148, 148, 160, 101, 101, 101, 104, 93, 93, 93, 100, 196, 196, 196, 152,
+};
+
+// 1 bit gray, a row that ends mid byte
+static const unsigned char gray1Png[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0xcf, 0x8e, 0x02,
+	0xd3, 0x00, 0x00, 0x00, 0x0b, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0xd8, 0x74, 0x00, 0x00,
+	0x02, 0x27, 0x01, 0x73, 0x8f, 0xd6, 0x3f, 0xad, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44,
+	0xae, 0x42, 0x60, 0x82,
+};
+static const unsigned char gray1Pixels[] = {
+	255, 255, 255, 255, 0, 0, 0, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	0, 0, 0, 255, 0, 0, 0, 255, 255, 255, 255, 255, 0, 0, 0, 255,
+	255, 255, 255, 255, 255, 255, 255, 255,
+};
+
+// FNV-1a, to compare whole decoded textures against a reference decode
+static uint32_t Hash(const std::vector<unsigned char>& bytes)
+{
+	uint32_t hash = 2166136261u;
+	for(unsigned char byte : bytes) {
+		hash = (hash ^ byte) * 16777619u;
+	}
+	return hash;
+}
+
+static bool DecodeAsset(const char* name, unsigned int& width, unsigned int& height, std::vector<unsigned char>& pixels)
+{
+	MappedFile file((std::string(ASSETS_DIR) + "Textures/" + name).c_str());
+	return file.IsOpen() && PngDecoder::Decode((const unsigned char*)file.GetData(), file.GetSize(), width, height, pixels);
+}
+
+static void CheckSynthetic(const unsigned char* png, size_t size, unsigned int expectedWidth, unsigned int expectedHeight, const unsigned char* expectedPixels)
+{
+	unsigned int width = 0;
+	unsigned int height = 0;
+	std::vector<unsigned char> pixels;
+	CHECK(PngDecoder::Decode(png, size, width, height, pixels));
+	CHECK(width == expectedWidth && height == expectedHeight);
+	CHECK(pixels.size() == expectedWidth * expectedHeight * 4 && memcmp(pixels.data(), expectedPixels, pixels.size()) == 0);
+}
+
+int main()
+{
+	// the 1x1 textures the game uses as defaults
+	struct { const char* name; unsigned char rgba[4]; } singlePixels[] = {
+		{ "pixel.png", { 255, 255, 255, 255 } },
+		{ "normal.png", { 128, 128, 255, 255 } },
+		{ "blackTexture.png", { 0, 0, 0, 255 } },
+	};
+	for(auto& expected : singlePixels) {
+		unsigned int width = 0;
+		unsigned int height = 0;
+		std::vector<unsigned char> pixels;
+		CHECK(DecodeAsset(expected.name, width, height, pixels));
+		CHECK(width == 1 && height == 1);
+		CHECK(pixels.size() == 4 && memcmp(pixels.data(), expected.rgba, 4) == 0);
+	}
+
+	// bigger ones against hashes of a separate zlib based decode: RGBA, RGB, and gray
+	struct { const char* name; unsigned int width; unsigned int height; uint32_t hash; } textures[] = {
+		{ "PBR/asteroid.png", 225, 225, 0x30a2e9ebu },
+		{ "PBR/cobblestone_metal.png", 128, 128, 0xf7b69dc5u },
+		{ "PBR/paint_roughness.png", 1024, 1024, 0xffe742d9u },
+		{ "PBR/wood_albedo.png", 1024, 1024, 0xd1c0036au },
+	};
+	for(auto& expected : textures) {
+		unsigned int width = 0;
+		unsigned int height = 0;
+		std::vector<unsigned char> pixels;
+		CHECK(DecodeAsset(expected.name, width, height, pixels));
+		CHECK(width == expected.width && height == expected.height);
+		CHECK(Hash(pixels) == expected.hash);
+	}
+
+	CheckSynthetic(palette2Png, sizeof(palette2Png), 3, 2, palette2Pixels);
+	CheckSynthetic(gray16keyPng, sizeof(gray16keyPng), 3, 2, gray16keyPixels);
+	CheckSynthetic(grayAlphaFilteredPng, sizeof(grayAlphaFilteredPng), 4, 5, grayAlphaFilteredPixels);
+	CheckSynthetic(gray1Png, sizeof(gray1Png), 10, 1, gray1Pixels);
+
+	// every truncation of a real file fails cleanly and leaves the outputs alone
+	MappedFile file((std::string(ASSETS_DIR) + "Textures/PBR/cobblestone_metal.png").c_str());
+	CHECK(file.IsOpen());
+	std::vector<unsigned char> bytes(file.GetData(), file.GetData() + file.GetSize());
+	for(size_t size = 0; size < bytes.size() - 12; size++) { // the last 12 bytes are IEND
+		std::vector<unsigned char> truncated(bytes.begin(), bytes.begin() + size);
+		unsigned int width = 7;
+		unsigned int height = 7;
+		std::vector<unsigned char> pixels(1, 42);
+		CHECK(!PngDecoder::Decode(truncated.data(), truncated.size(), width, height, pixels));
+		CHECK(width == 7 && height == 7 && pixels.size() == 1);
+	}
+
+	// a corrupt deflate stream fails instead of running off the end
+	std::vector<unsigned char> corrupt(grayAlphaFilteredPng, grayAlphaFilteredPng + sizeof(grayAlphaFilteredPng));
+	for(size_t i = 41; i < corrupt.size() - 16; i++) {
+		corrupt[i] ^= 0x5A;
+	}
+	unsigned int width;
+	unsigned int height;
+	std::vector<unsigned char> pixels;
+	PngDecoder::Decode(corrupt.data(), corrupt.size(), width, height, pixels); // either way, no crash
+
+	return CheckResult();
+}
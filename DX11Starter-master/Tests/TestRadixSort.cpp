@@ -0,0 +1,104 @@
+#include "TestCheck.h"
+#include "RadixSort.h"
+#include <algorithm>
+#include <random>
+
+// keys shaped like RenderQueue's: a few passes, shaders, materials and meshes
+// above random depths, so most high bytes repeat and many keys tie
+static uint64_t MakeKey(std::mt19937_64& random, int stateCount)
+{
+	uint64_t state = random() % stateCount;
+	uint64_t depth = random() & 0xFFFFFF;
+	return ((state * 0x9E3779B97F4A7C15ull) & 0xFFFFFFFFFF000000ull) | depth;
+}
+
+// items whose transform is their position before sorting, so ties can be checked for order
+static std::vector<RenderItem> MakeItems(const std::vector<uint64_t>& keys)
+{
+	std::vector<RenderItem> items(keys.size());
+	for(size_t i = 0; i < keys.size(); i++) {
+		items[i] = { keys[i], (Transform*)(i + 1), nullptr, nullptr, (unsigned int)i };
+	}
+	return items;
+}
+
+// RadixSort has to give the exact order std::stable_sort does, which means the
+// keys come out as std::sort orders them and ties keep their submission order
+static bool MatchesStdSort(const std::vector<uint64_t>& keys)
+{
+	std::vector<RenderItem> items = MakeItems(keys);
+	std::vector<RenderItem> scratch;
+	RadixSort::Sort(items, scratch);
+
+	std::vector<uint64_t> sortedKeys = keys;
+	std::sort(sortedKeys.begin(), sortedKeys.end());
+	std::vector<RenderItem> expected = MakeItems(keys);
+	std::stable_sort(expected.begin(), expected.end(), [](const RenderItem& a, const RenderItem& b) { return a.key < b.key; });
+
+	if(items.size() != keys.size()) {
+		return false;
+	}
+	for(size_t i = 0; i < items.size(); i++) {
+		if(items[i].key != sortedKeys[i] || items[i].transform != expected[i].transform) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int main()
+{
+	std::mt19937_64 random(16);
+
+	// nothing and one item are left alone
+	CHECK(MatchesStdSort({}));
+	CHECK(MatchesStdSort({ 42 }));
+	CHECK(MatchesStdSort({ 2, 1 }));
+
+	// every key the same, where every pass is skipped
+	CHECK(MatchesStdSort(std::vector<uint64_t>(1000, 0x0123456789ABCDEFull)));
+
+	// keys differing only in the top or the bottom byte
+	std::vector<uint64_t> top;
+	std::vector<uint64_t> bottom;
+	for(int i = 0; i < 1000; i++) {
+		top.push_back((random() & 0xFF00000000000000ull) | 0x5555);
+		bottom.push_back(0xAA00000000000000ull | (random() & 0xFF));
+	}
+	CHECK(MatchesStdSort(top));
+	CHECK(MatchesStdSort(bottom));
+
+	// full 64 bit random keys and render queue shaped ones
+	for(size_t count : { 3, 100, 10000, 100000 }) {
+		std::vector<uint64_t> uniform;
+		std::vector<uint64_t> shaped;
+		std::vector<uint64_t> fewStates;
+		for(size_t i = 0; i < count; i++) {
+			uniform.push_back(random());
+			shaped.push_back(MakeKey(random, 200));
+			fewStates.push_back(MakeKey(random, 3) & 0xFFFFFFFFFF0000FFull);
+		}
+		CHECK(MatchesStdSort(uniform));
+		CHECK(MatchesStdSort(shaped));
+		CHECK(MatchesStdSort(fewStates));
+	}
+
+	// the scratch vector can be reused between sorts of different sizes
+	std::vector<RenderItem> scratch;
+	for(size_t count : { 5000, 10, 20000 }) {
+		std::vector<uint64_t> keys;
+		for(size_t i = 0; i < count; i++) {
+			keys.push_back(MakeKey(random, 50));
+		}
+		std::vector<RenderItem> items = MakeItems(keys);
+		RadixSort::Sort(items, scratch);
+		std::sort(keys.begin(), keys.end());
+		bool same = items.size() == keys.size();
+		for(size_t i = 0; same && i < keys.size(); i++) {
+			same = items[i].key == keys[i];
+		}
+		CHECK(same);
+	}
+
+	return CheckResult();
+}
@@ -0,0 +1,76 @@
+#include "TestCheck.h"
+#include "TestMeshes.h"
+#include "ObjParser.h"
+#include "VertexWelder.h"
+#include "TangentGenerator.h"
+#include <math.h>
+#include <string.h>
+#include <string>
+
+static float MaxTangentDifference(const std::vector<Vertex>& a, const std::vector<Vertex>& b)
+{
+	float worst = 0.0f;
+	for(size_t i = 0; i < a.size(); i++) {
+		worst = fmaxf(worst, fabsf(a[i].Tangent.x - b[i].Tangent.x));
+		worst = fmaxf(worst, fabsf(a[i].Tangent.y - b[i].Tangent.y));
+		worst = fmaxf(worst, fabsf(a[i].Tangent.z - b[i].Tangent.z));
+	}
+	return worst;
+}
+
+// --------------------------------------------------------
+// Generate() against the scalar GenerateReference(), on
+// the models and on a grid big enough to really use 8
+// threads. One thread adds in the reference's order, more
+// threads only reorder the sums, so both stay close to it
+// and a rerun gives bit-identical results.
+// --------------------------------------------------------
+static void CompareWithReference(const char* name, const std::vector<Vertex>& source, const std::vector<unsigned int>& indices)
+{
+	std::vector<Vertex> reference = source;
+	TangentGenerator::GenerateReference(reference.data(), (int)reference.size(), indices.data(), (int)indices.size());
+
+	for(unsigned int threads : { 1u, 2u, 3u, 4u, 8u }) {
+		std::vector<Vertex> generated = source;
+		TangentGenerator::Generate(generated.data(), (int)generated.size(), indices.data(), (int)indices.size(), threads);
+		float difference = MaxTangentDifference(generated, reference);
+		printf("%-12s %u thread(s): max difference %g\n", name, threads, difference);
+		CHECK(difference <= (threads == 1 ? 1e-5f : 1e-4f));
+
+		std::vector<Vertex> again = source;
+		TangentGenerator::Generate(again.data(), (int)again.size(), indices.data(), (int)indices.size(), threads);
+		CHECK(memcmp(again.data(), generated.data(), again.size() * sizeof(Vertex)) == 0);
+	}
+}
+
+int main()
+{
+	for(const char* model : { "cube.obj", "sphere.obj", "torus.obj", "helix.obj", "cylinder.obj" }) {
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+		CHECK(ObjParser::Load((std::string(ASSETS_DIR) + "Models/" + model).c_str(), vertices, indices));
+		VertexWelder::Weld(vertices, indices);
+		CompareWithReference(model, vertices, indices);
+	}
+
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	MakeGrid(300, vertices, indices); // 180k triangles, over TrianglesPerThread * 8
+	CompareWithReference("grid", vertices, indices);
+
+	// a triangle with no uv area has no tangent direction, which has to come out as zero
+	Vertex flat[3] = {};
+	flat[0].Position = DirectX::XMFLOAT3(0, 0, 0);
+	flat[1].Position = DirectX::XMFLOAT3(1, 0, 0);
+	flat[2].Position = DirectX::XMFLOAT3(0, 1, 0);
+	for(Vertex& vertex : flat) {
+		vertex.Normal = DirectX::XMFLOAT3(0, 0, -1);
+	}
+	unsigned int flatIndices[] = { 0, 1, 2 };
+	TangentGenerator::Generate(flat, 3, flatIndices, 3, 1);
+	for(Vertex& vertex : flat) {
+		CHECK(!(fabsf(vertex.Tangent.x) > 0.0f) && !(fabsf(vertex.Tangent.y) > 0.0f) && !(fabsf(vertex.Tangent.z) > 0.0f));
+	}
+
+	return CheckResult();
+}
@@ -0,0 +1,231 @@
+#include "TestCheck.h"
+#include "TransformPool.h"
+#include <math.h>
+#include <random>
+
+using namespace DirectX;
+
+static float MaxDifference(const XMFLOAT4X4& a, const XMFLOAT4X4& b)
+{
+	float worst = 0.0f;
+	for(int i = 0; i < 16; i++) {
+		worst = fmaxf(worst, fabsf(a.m[i / 4][i % 4] - b.m[i / 4][i % 4]));
+	}
+	return worst;
+}
+
+// the matrix a transform with these components should have, built the plain way
+static XMMATRIX Compose(XMFLOAT3 position, XMFLOAT3 pitchYawRoll, XMFLOAT3 scale)
+{
+	return XMMatrixScaling(scale.x, scale.y, scale.z) *
+		XMMatrixRotationRollPitchYaw(pitchYawRoll.x, pitchYawRoll.y, pitchYawRoll.z) *
+		XMMatrixTranslation(position.x, position.y, position.z);
+}
+
+static float MaxDifference(const XMFLOAT4X4& a, XMMATRIX b)
+{
+	XMFLOAT4X4 floats;
+	XMStoreFloat4x4(&floats, b);
+	return MaxDifference(a, floats);
+}
+
+static unsigned int Place(TransformPool& pool, XMFLOAT3 position, XMFLOAT3 pitchYawRoll, XMFLOAT3 scale)
+{
+	unsigned int slot = pool.Allocate();
+	pool.SetPosition(slot, position);
+	pool.SetPitchYawRoll(slot, pitchYawRoll);
+	pool.SetScale(slot, scale);
+	return slot;
+}
+
+// --------------------------------------------------------
+// UpdateDirty() builds four matrices at a time in SIMD lanes
+// and splits the slots across threads. Whatever the slot
+// count and thread count, every matrix has to come out as
+// scale * rotation * translation built one at a time.
+// --------------------------------------------------------
+static void TestUpdateReference()
+{
+	std::mt19937 random(21);
+	std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> angle(-3.2f, 3.2f);
+	std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+	float worst = 0.0f;
+
+	// odd counts leave partial SIMD groups and dirty words, the big one gets several threads
+	for(unsigned int count : { 1u, 3u, 7u, 61u, 65u, 130u, 4097u, 20003u }) {
+		for(unsigned int threads : { 1u, 2u, 4u, 0u }) {
+			TransformPool pool;
+			std::vector<unsigned int> slots;
+			std::vector<XMFLOAT3> positions, angles, scales;
+			for(unsigned int i = 0; i < count; i++) {
+				positions.push_back(XMFLOAT3(value(random), value(random), value(random)));
+				angles.push_back(XMFLOAT3(angle(random), angle(random), angle(random)));
+				scales.push_back(XMFLOAT3(scale(random), scale(random), -scale(random)));
+				slots.push_back(Place(pool, positions[i], angles[i], scales[i]));
+			}
+
+			// then again with only some of them moved
+			for(int pass = 0; pass < 2; pass++) {
+				pool.UpdateDirty(threads);
+				CHECK(pool.GetDirtyCount() == 0); // so the reads below don't rebuild anything
+				bool matches = true;
+				for(unsigned int i = 0; i < count; i++) {
+					float difference = MaxDifference(pool.GetWorldMatrix(slots[i]), Compose(positions[i], angles[i], scales[i]));
+					worst = fmaxf(worst, difference);
+					matches = matches && difference < 1e-5f;
+				}
+				CHECK(matches);
+
+				for(unsigned int i = 0; i < count; i += 3) {
+					positions[i] = XMFLOAT3(value(random), value(random), value(random));
+					angles[i] = XMFLOAT3(angle(random), angle(random), angle(random));
+					pool.SetPosition(slots[i], positions[i]);
+					pool.SetPitchYawRoll(slots[i], angles[i]);
+				}
+			}
+		}
+	}
+	printf("UpdateDirty against the reference: max difference %g\n", worst);
+}
+
+// children multiply in their parent's world matrix, and keep doing so when it moves
+static void TestFollowParent()
+{
+	XMFLOAT3 parentPosition(3, -1, 4), parentAngles(0.3f, 1.2f, -0.4f), parentScale(2, 2, 2);
+	XMFLOAT3 childPosition(1, 2, 3), childAngles(-0.7f, 0.1f, 0.9f), childScale(1, 0.5f, 3);
+	XMFLOAT3 grandchildPosition(0, 1, -2), grandchildAngles(0, 0, 0.5f), grandchildScale(-1, 1, 1);
+
+	TransformPool pool;
+	unsigned int parentSlot = Place(pool, parentPosition, parentAngles, parentScale);
+	unsigned int child = Place(pool, childPosition, childAngles, childScale);
+	unsigned int grandchild = Place(pool, grandchildPosition, grandchildAngles, grandchildScale);
+	CHECK(pool.SetParent(grandchild, child, false));
+	CHECK(pool.SetParent(child, parentSlot, false));
+	pool.UpdateDirty();
+
+	XMMATRIX childWorld = Compose(childPosition, childAngles, childScale) * Compose(parentPosition, parentAngles, parentScale);
+	CHECK(MaxDifference(pool.GetWorldMatrix(child), childWorld) < 1e-5f);
+	CHECK(MaxDifference(pool.GetWorldMatrix(grandchild), Compose(grandchildPosition, grandchildAngles, grandchildScale) * childWorld) < 1e-5f);
+
+	// only the parent changes, the rest is dirty through it
+	parentPosition = XMFLOAT3(-6, 8, 0.5f);
+	parentAngles = XMFLOAT3(1.1f, -0.2f, 2.0f);
+	parentScale = XMFLOAT3(-0.5f, -0.5f, -0.5f);
+	pool.SetPosition(parentSlot, parentPosition);
+	pool.SetPitchYawRoll(parentSlot, parentAngles);
+	pool.SetScale(parentSlot, parentScale);
+	pool.UpdateDirty();
+
+	childWorld = Compose(childPosition, childAngles, childScale) * Compose(parentPosition, parentAngles, parentScale);
+	CHECK(MaxDifference(pool.GetWorldMatrix(child), childWorld) < 1e-5f);
+	CHECK(MaxDifference(pool.GetWorldMatrix(grandchild), Compose(grandchildPosition, grandchildAngles, grandchildScale) * childWorld) < 1e-5f);
+	CHECK(!pool.SetParent(parentSlot, grandchild));
+}
+
+// keepWorld leaves the world matrix alone going under a parent, between parents
+// and back out to a root, mirrored or not
+static void TestKeepWorld()
+{
+	struct Case
+	{
+		XMFLOAT3 childScale;
+		XMFLOAT3 parentScale;
+	};
+	Case cases[] = {
+		{ XMFLOAT3(1, 1, 1), XMFLOAT3(1, 1, 1) },
+		{ XMFLOAT3(0.5f, 2, 3), XMFLOAT3(2, 2, 2) },
+		{ XMFLOAT3(-1, 1, 1), XMFLOAT3(1, 1, 1) },
+		{ XMFLOAT3(1, -2, 0.5f), XMFLOAT3(3, 3, 3) },
+		{ XMFLOAT3(1, 1, 1), XMFLOAT3(-2, -2, -2) },
+		{ XMFLOAT3(-1, 1, 1), XMFLOAT3(-2, -2, -2) },
+		{ XMFLOAT3(-1, -1, -1), XMFLOAT3(0.5f, 0.5f, 0.5f) },
+	};
+	for(Case& test : cases) {
+		TransformPool pool;
+		unsigned int first = Place(pool, XMFLOAT3(5, 0, -3), XMFLOAT3(0.4f, 1.0f, 0.2f), test.parentScale);
+		unsigned int second = Place(pool, XMFLOAT3(-2, 7, 1), XMFLOAT3(-1.3f, 0.6f, 2.2f), test.parentScale);
+		unsigned int child = Place(pool, XMFLOAT3(1, 2, 3), XMFLOAT3(0.8f, -0.5f, 0.3f), test.childScale);
+		XMFLOAT4X4 start = pool.GetWorldMatrix(child);
+
+		CHECK(pool.SetParent(child, first));
+		CHECK(MaxDifference(pool.GetWorldMatrix(child), start) < 1e-4f);
+		CHECK(pool.SetParent(child, second));
+		CHECK(MaxDifference(pool.GetWorldMatrix(child), start) < 1e-4f);
+		CHECK(pool.SetParent(child, TransformPool::NoParent));
+		CHECK(MaxDifference(pool.GetWorldMatrix(child), start) < 1e-4f);
+
+		// releasing the parent goes through the same path
+		CHECK(pool.SetParent(child, first));
+		pool.Release(first);
+		CHECK(MaxDifference(pool.GetWorldMatrix(child), start) < 1e-4f);
+	}
+}
+
+// --------------------------------------------------------
+// Releasing a parent turns its children into roots where
+// they stand, including children parented since the pool
+// last sorted its hierarchy
+// --------------------------------------------------------
+static void TestReleaseUnsorted()
+{
+	TransformPool pool;
+	unsigned int parentSlot = pool.Allocate();
+	unsigned int child = pool.Allocate();
+	unsigned int grandchild = pool.Allocate();
+	pool.SetPosition(parentSlot, XMFLOAT3(10, 0, 0));
+	pool.SetPitchYawRoll(parentSlot, XMFLOAT3(0, 1.0f, 0));
+	pool.SetScale(parentSlot, XMFLOAT3(2, 2, 2));
+	pool.SetPosition(child, XMFLOAT3(1, 2, 3));
+	pool.SetPosition(grandchild, XMFLOAT3(0, 1, 0));
+	pool.UpdateDirty();
+
+	// parented, then the parent released before any update or read sorts the hierarchy
+	CHECK(pool.SetParent(child, parentSlot, false));
+	CHECK(pool.SetParent(grandchild, child, false));
+	pool.Release(parentSlot);
+	CHECK(pool.GetParent(child) == TransformPool::NoParent);
+	CHECK(pool.GetParent(grandchild) == child);
+
+	// the child keeps the world matrix it had under the parent
+	TransformPool reference;
+	unsigned int referenceParent = reference.Allocate();
+	unsigned int referenceChild = reference.Allocate();
+	reference.SetPosition(referenceParent, XMFLOAT3(10, 0, 0));
+	reference.SetPitchYawRoll(referenceParent, XMFLOAT3(0, 1.0f, 0));
+	reference.SetScale(referenceParent, XMFLOAT3(2, 2, 2));
+	reference.SetPosition(referenceChild, XMFLOAT3(1, 2, 3));
+	reference.SetParent(referenceChild, referenceParent, false);
+	XMFLOAT4X4 expected = reference.GetWorldMatrix(referenceChild);
+	CHECK(MaxDifference(pool.GetWorldMatrix(child), expected) < 1e-4f);
+
+	// the released slot gets reused, and moving it mustn't drag the old children along
+	XMFLOAT4X4 childBefore = pool.GetWorldMatrix(child);
+	XMFLOAT4X4 grandchildBefore = pool.GetWorldMatrix(grandchild);
+	unsigned int reused = pool.Allocate();
+	CHECK(reused == parentSlot);
+	pool.SetPosition(reused, XMFLOAT3(-50, 20, 7));
+	pool.UpdateDirty();
+	CHECK(MaxDifference(pool.GetWorldMatrix(child), childBefore) == 0.0f);
+	CHECK(MaxDifference(pool.GetWorldMatrix(grandchild), grandchildBefore) == 0.0f);
+
+	// the same with the hierarchy already sorted, the path that always worked
+	unsigned int sortedParent = pool.Allocate();
+	unsigned int sortedChild = pool.Allocate();
+	pool.SetPosition(sortedParent, XMFLOAT3(0, 5, 0));
+	CHECK(pool.SetParent(sortedChild, sortedParent, false));
+	pool.UpdateDirty();
+	XMFLOAT4X4 sortedBefore = pool.GetWorldMatrix(sortedChild);
+	pool.Release(sortedParent);
+	CHECK(pool.GetParent(sortedChild) == TransformPool::NoParent);
+	CHECK(MaxDifference(pool.GetWorldMatrix(sortedChild), sortedBefore) < 1e-5f);
+}
+
+int main()
+{
+	TestUpdateReference();
+	TestFollowParent();
+	TestKeepWorld();
+	TestReleaseUnsorted();
+	return CheckResult();
+}
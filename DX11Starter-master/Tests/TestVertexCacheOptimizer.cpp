@@ -0,0 +1,78 @@
+#include "TestCheck.h"
+#include "TestMeshes.h"
+#include "ObjParser.h"
+#include "VertexWelder.h"
+#include "VertexCacheOptimizer.h"
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+
+// every triangle as the bytes of its three corners, started at the smallest
+// corner so the winding is kept but where it starts isn't, then sorted
+static std::vector<std::string> Triangles(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
+{
+	std::vector<std::string> triangles;
+	for(size_t i = 0; i + 2 < indices.size(); i += 3) {
+		std::string corners[3];
+		for(int c = 0; c < 3; c++) {
+			corners[c] = std::string((const char*)&vertices[indices[i + c]], sizeof(Vertex));
+		}
+		int first = (int)(std::min_element(corners, corners + 3) - corners);
+		triangles.push_back(corners[first] + corners[(first + 1) % 3] + corners[(first + 2) % 3]);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+// --------------------------------------------------------
+// Optimize() only reorders: the same triangles with the
+// same winding, vertices renumbered in first use order, and
+// fewer simulated cache misses than the file order had
+// --------------------------------------------------------
+static void CheckOptimize(const char* name, std::vector<Vertex> vertices, std::vector<unsigned int> indices)
+{
+	std::vector<std::string> before = Triangles(vertices, indices);
+	CacheStats stats = VertexCacheOptimizer::Optimize(vertices.data(), (int)vertices.size(), indices.data(), (int)indices.size());
+	printf("%-12s acmr %.3f -> %.3f  atvr %.3f -> %.3f\n", name, stats.acmrBefore, stats.acmrAfter, stats.atvrBefore, stats.atvrAfter);
+
+	CHECK(Triangles(vertices, indices) == before);
+	CHECK(stats.acmrAfter < stats.acmrBefore);
+	CHECK(stats.atvrAfter < stats.atvrBefore);
+	CHECK(stats.acmrAfter == VertexCacheOptimizer::ComputeACMR(indices.data(), (int)indices.size(), (int)vertices.size()));
+	CHECK(stats.atvrAfter == VertexCacheOptimizer::ComputeATVR(indices.data(), (int)indices.size(), (int)vertices.size()));
+
+	unsigned int nextNew = 0;
+	bool firstUseOrder = true;
+	for(unsigned int index : indices) {
+		firstUseOrder = firstUseOrder && index <= nextNew;
+		if(index == nextNew) {
+			nextNew++;
+		}
+	}
+	CHECK(firstUseOrder && nextNew == vertices.size());
+}
+
+int main()
+{
+	for(const char* model : { "sphere.obj", "torus.obj", "helix.obj" }) {
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+		CHECK(ObjParser::Load((std::string(ASSETS_DIR) + "Models/" + model).c_str(), vertices, indices));
+		VertexWelder::Weld(vertices, indices);
+		CheckOptimize(model, vertices, indices);
+	}
+
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	MakeGrid(100, vertices, indices);
+	CheckOptimize("grid", vertices, indices);
+
+	// the simulated FIFO: a lone triangle misses on every corner, and a
+	// second one sharing an edge only on its new corner
+	unsigned int pair[] = { 0, 1, 2, 2, 1, 3 };
+	CHECK(VertexCacheOptimizer::ComputeACMR(pair, 3, 4) == 3.0f);
+	CHECK(VertexCacheOptimizer::ComputeACMR(pair, 6, 4) == 2.0f);
+	CHECK(VertexCacheOptimizer::ComputeATVR(pair, 6, 4) == 1.0f);
+
+	return CheckResult();
+}
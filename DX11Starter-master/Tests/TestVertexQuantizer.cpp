@@ -0,0 +1,158 @@
+#include "TestCheck.h"
+#include "VertexQuantizer.h"
+#include <math.h>
+#include <float.h>
+#include <random>
+#include <vector>
+using namespace DirectX;
+
+// angle between two directions in degrees, atan2 stays accurate for tiny angles where acos doesn't
+static float AngleDegrees(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	float crossX = a.y * b.z - a.z * b.y;
+	float crossY = a.z * b.x - a.x * b.z;
+	float crossZ = a.x * b.y - a.y * b.x;
+	float dot = a.x * b.x + a.y * b.y + a.z * b.z;
+	return atan2f(sqrtf(crossX * crossX + crossY * crossY + crossZ * crossZ), dot) * 57.2957795f;
+}
+
+static XMFLOAT3 Normalized(float x, float y, float z)
+{
+	float length = sqrtf(x * x + y * y + z * z);
+	return XMFLOAT3(x / length, y / length, z / length);
+}
+
+static float RoundTripAngle(const XMFLOAT3& direction)
+{
+	int16_t encoded[2];
+	VertexQuantizer::EncodeOctahedral(direction, encoded);
+	return AngleDegrees(direction, VertexQuantizer::DecodeOctahedral(encoded));
+}
+
+// --------------------------------------------------------
+// Checks the worst case errors VertexQuantizer.h documents
+// --------------------------------------------------------
+int main()
+{
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+	// positions: half a step of the bounds, plus the float rounding of decoding at that magnitude
+	XMFLOAT3 boundsList[][2] = {
+		{ XMFLOAT3(-1, -1, -1), XMFLOAT3(1, 1, 1) },
+		{ XMFLOAT3(-0.001f, 0, 5), XMFLOAT3(0.001f, 200, 5.5f) },
+		{ XMFLOAT3(1000, -3000, 0), XMFLOAT3(1010, 3000, 0) }, // far from the origin, and one flat axis
+	};
+	for(auto& bounds : boundsList) {
+		const XMFLOAT3& boundsMin = bounds[0];
+		const XMFLOAT3& boundsMax = bounds[1];
+		float minimum[3] = { boundsMin.x, boundsMin.y, boundsMin.z };
+		float maximum[3] = { boundsMax.x, boundsMax.y, boundsMax.z };
+
+		float worst[3] = {};
+		float allowed[3];
+		for(int axis = 0; axis < 3; axis++) {
+			float magnitude = fmaxf(fabsf(minimum[axis]), fabsf(maximum[axis]));
+			allowed[axis] = (maximum[axis] - minimum[axis]) / 131070.0f + 2.0f * magnitude * FLT_EPSILON;
+		}
+
+		for(int i = 0; i < 100000; i++) {
+			Vertex vertex = {};
+			float* position = &vertex.Position.x;
+			for(int axis = 0; axis < 3; axis++) {
+				float t = (i < 2 ? (float)i : (unit(random) + 1.0f) * 0.5f); // both corners first
+				position[axis] = minimum[axis] + t * (maximum[axis] - minimum[axis]);
+			}
+			Vertex decoded = VertexQuantizer::Decode(VertexQuantizer::Encode(vertex, boundsMin, boundsMax), boundsMin, boundsMax);
+			float* decodedPosition = &decoded.Position.x;
+			for(int axis = 0; axis < 3; axis++) {
+				worst[axis] = fmaxf(worst[axis], fabsf(decodedPosition[axis] - position[axis]));
+			}
+		}
+		for(int axis = 0; axis < 3; axis++) {
+			CHECK(worst[axis] <= allowed[axis]);
+		}
+	}
+
+	// directions: random, then the poles and axes, then the z = 0 seam where the
+	// lower half folds over, approached from both sides
+	float worstAngle = 0.0f;
+	for(int i = 0; i < 1000000; i++) {
+		float x = unit(random);
+		float y = unit(random);
+		float z = unit(random);
+		if(x * x + y * y + z * z > 1e-6f) {
+			worstAngle = fmaxf(worstAngle, RoundTripAngle(Normalized(x, y, z)));
+		}
+	}
+	XMFLOAT3 special[] = {
+		XMFLOAT3(0, 0, 1), XMFLOAT3(0, 0, -1), XMFLOAT3(1, 0, 0), XMFLOAT3(-1, 0, 0), XMFLOAT3(0, 1, 0), XMFLOAT3(0, -1, 0),
+		XMFLOAT3(0, 0, -0.0f), Normalized(1, 1, 1), Normalized(-1, -1, -1), Normalized(1, -1, -1), Normalized(-1, 1, -1),
+		Normalized(1e-7f, 0, -1), Normalized(-1e-7f, 1e-7f, -1), Normalized(0, 0.001f, -1),
+	};
+	for(XMFLOAT3& direction : special) {
+		float length = sqrtf(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+		if(length > 0.0f) {
+			worstAngle = fmaxf(worstAngle, RoundTripAngle(direction));
+		}
+	}
+	for(int i = 0; i < 100000; i++) {
+		float angle = unit(random) * 3.14159265f;
+		float z = (i % 2 ? 1.0f : -1.0f) * ldexpf(1.0f, -(int)(random() % 30)) * (i % 4 < 2 ? 0.0f : 1.0f);
+		worstAngle = fmaxf(worstAngle, RoundTripAngle(Normalized(cosf(angle), sinf(angle), z)));
+	}
+	printf("worst direction error %g degrees\n", worstAngle);
+	CHECK(worstAngle < 0.005f);
+
+	// the poles come back exact, and a zero vector comes back as +Z
+	for(XMFLOAT3 pole : { XMFLOAT3(0, 0, 1), XMFLOAT3(0, 0, -1) }) {
+		int16_t encoded[2];
+		VertexQuantizer::EncodeOctahedral(pole, encoded);
+		XMFLOAT3 decoded = VertexQuantizer::DecodeOctahedral(encoded);
+		CHECK(decoded.x == 0.0f && decoded.y == 0.0f && decoded.z == pole.z);
+	}
+	int16_t zeroEncoded[2];
+	VertexQuantizer::EncodeOctahedral(XMFLOAT3(0, 0, 0), zeroEncoded);
+	XMFLOAT3 zeroDecoded = VertexQuantizer::DecodeOctahedral(zeroEncoded);
+	CHECK(zeroDecoded.x == 0.0f && zeroDecoded.y == 0.0f && zeroDecoded.z == 1.0f);
+
+	// normals and tangents share the encoding, check them through a whole vertex
+	float worstNormal = 0.0f;
+	float worstTangent = 0.0f;
+	XMFLOAT3 boundsMin(-1, -1, -1);
+	XMFLOAT3 boundsMax(1, 1, 1);
+	for(int i = 0; i < 100000; i++) {
+		Vertex vertex = {};
+		vertex.Normal = Normalized(unit(random), unit(random), unit(random) + 1e-3f);
+		vertex.Tangent = Normalized(unit(random), unit(random), unit(random) - 1e-3f);
+		Vertex decoded = VertexQuantizer::Decode(VertexQuantizer::Encode(vertex, boundsMin, boundsMax), boundsMin, boundsMax);
+		worstNormal = fmaxf(worstNormal, AngleDegrees(vertex.Normal, decoded.Normal));
+		worstTangent = fmaxf(worstTangent, AngleDegrees(vertex.Tangent, decoded.Tangent));
+	}
+	CHECK(worstNormal < 0.005f);
+	CHECK(worstTangent < 0.005f);
+
+	// uvs: 2^-11 relative in the normal half range, and subnormal halves
+	// (below 2^-14) are 2^-24 apart so they are off by at most 2^-25
+	float worstRelative = 0.0f;
+	float worstSubnormal = 0.0f;
+	std::vector<float> uvs = { 0.0f, -0.0f, 1.0f, 0.5f, 0.25f, 0.1f, 1.0f / 3.0f, 2048.0f, 65504.0f, -65504.0f, 6.1035156e-5f, 3e-5f, 1e-7f };
+	for(int i = 0; i < 200000; i++) {
+		uvs.push_back(unit(random) * ldexpf(1.0f, (int)(random() % 40) - 24));
+	}
+	for(float value : uvs) {
+		Vertex vertex = {};
+		vertex.UV = XMFLOAT2(value, -value);
+		Vertex decoded = VertexQuantizer::Decode(VertexQuantizer::Encode(vertex, boundsMin, boundsMax), boundsMin, boundsMax);
+		float error = fmaxf(fabsf(decoded.UV.x - value), fabsf(decoded.UV.y + value));
+		if(fabsf(value) >= 6.1035156e-5f) {
+			worstRelative = fmaxf(worstRelative, error / fabsf(value));
+		} else {
+			worstSubnormal = fmaxf(worstSubnormal, error);
+		}
+	}
+	CHECK(worstRelative <= ldexpf(1.0f, -11));
+	CHECK(worstSubnormal <= ldexpf(1.0f, -25));
+
+	return CheckResult();
+}
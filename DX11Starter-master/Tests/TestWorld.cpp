@@ -0,0 +1,175 @@
+#include "TestCheck.h"
+#include "StubMesh.h"
+#include "World.h"
+#include <math.h>
+
+using namespace DirectX;
+
+// which entity sits in each row of the archetype with this mask
+static std::vector<unsigned int> Rows(World& world, ComponentMask mask)
+{
+	std::vector<unsigned int> indices;
+	for(Archetype& archetype : world.GetArchetypes()) {
+		if(archetype.mask == mask) {
+			for(EntityId id : archetype.entities) {
+				indices.push_back(id.index);
+			}
+		}
+	}
+	return indices;
+}
+
+static bool Near(XMFLOAT3 a, XMFLOAT3 b)
+{
+	return fabsf(a.x - b.x) < 1e-4f && fabsf(a.y - b.y) < 1e-4f && fabsf(a.z - b.z) < 1e-4f;
+}
+
+// --------------------------------------------------------
+// World space bounds are the mesh's local ones moved by the
+// entity's world matrix, and there are none without both a
+// transform and a mesh
+// --------------------------------------------------------
+static void TestBounds()
+{
+	World world;
+	std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+	mesh->box = BoundingBox(XMFLOAT3(1, 0, 0), XMFLOAT3(1, 2, 3));
+	mesh->sphere = BoundingSphere(XMFLOAT3(1, 0, 0), 2.0f);
+
+	// a quarter turn about y takes local x to -z and swaps the x and z extents
+	EntityId id = world.Create(HasTransform | HasRender);
+	world.GetRender(id)->mesh = mesh;
+	Transform* transform = world.GetTransform(id);
+	transform->SetPosition(10, 0, 0);
+	transform->SetPitchYawRoll(0, XM_PIDIV2, 0);
+	transform->SetScale(2, 2, 2);
+
+	BoundingBox box;
+	BoundingSphere sphere;
+	CHECK(world.GetWorldBoundingBox(id, box));
+	CHECK(Near(box.Center, XMFLOAT3(10, 0, -2)));
+	CHECK(Near(box.Extents, XMFLOAT3(6, 4, 2)));
+	CHECK(world.GetWorldBoundingSphere(id, sphere));
+	CHECK(Near(sphere.Center, XMFLOAT3(10, 0, -2)));
+	CHECK(fabsf(sphere.Radius - 4.0f) < 1e-4f);
+
+	// the row versions RenderQueue::Submit uses give the same
+	BoundingSphere rowSphere = World::GetWorldBoundingSphere(*world.GetRender(id), transform->GetWorldMatrix());
+	CHECK(Near(rowSphere.Center, sphere.Center) && rowSphere.Radius == sphere.Radius);
+	BoundingBox rowBox = World::GetWorldBoundingBox(*world.GetRender(id), transform->GetWorldMatrix());
+	CHECK(Near(rowBox.Center, box.Center) && Near(rowBox.Extents, box.Extents));
+
+	// uneven scale grows the sphere by the largest axis, and the bounds follow a parent
+	transform->SetPitchYawRoll(0, 0, 0);
+	transform->SetScale(1, 3, 1);
+	EntityId parent = world.Create(HasTransform);
+	world.GetTransform(parent)->SetPosition(0, 5, 0);
+	world.GetTransform(id)->SetParent(world.GetTransform(parent), false);
+	CHECK(world.GetWorldBoundingSphere(id, sphere));
+	CHECK(Near(sphere.Center, XMFLOAT3(11, 5, 0)));
+	CHECK(fabsf(sphere.Radius - 6.0f) < 1e-4f);
+	CHECK(world.GetWorldBoundingBox(id, box));
+	CHECK(Near(box.Center, XMFLOAT3(11, 5, 0)));
+	CHECK(Near(box.Extents, XMFLOAT3(1, 6, 3)));
+
+	// nothing to bound
+	EntityId noMesh = world.Create(HasTransform | HasRender);
+	EntityId noRender = world.Create(HasTransform);
+	for(EntityId none : { noMesh, noRender, parent, NoEntity }) {
+		CHECK(!world.GetWorldBoundingBox(none, box));
+		CHECK(!world.GetWorldBoundingSphere(none, sphere));
+	}
+	world.Destroy(id);
+	CHECK(!world.GetWorldBoundingSphere(id, sphere));
+}
+
+// --------------------------------------------------------
+// Destroy() fills the hole with the archetype's last row and
+// bumps the generation, so old ids stop resolving even once
+// their index is handed out again
+// --------------------------------------------------------
+static void TestDestroy()
+{
+	World world;
+	TransformPool& pool = TransformPool::Default();
+	unsigned int poolBefore = pool.GetCount();
+	const ComponentMask ballMask = HasTransform | HasRender | HasBall;
+
+	EntityId balls[4];
+	for(int i = 0; i < 4; i++) {
+		balls[i] = world.Create(ballMask);
+		world.GetTransform(balls[i])->SetPosition((float)i, 0, 0);
+		world.GetBall(balls[i])->velocity = Vector3((float)i * 10, 0, 0);
+	}
+	EntityId enemy = world.Create(HasTransform | HasEnemy);
+	world.GetEnemy(enemy)->speed = 3.0f;
+	CHECK(world.GetCount() == 5);
+	CHECK(world.GetArchetypes().size() == 2);
+	CHECK(world.GetBall(enemy) == nullptr);
+	CHECK(world.GetPlayer(balls[0]) == nullptr);
+	CHECK(pool.GetCount() == poolBefore + 5);
+
+	// destroying a middle row moves the last one into it, components and transform included
+	world.Destroy(balls[1]);
+	CHECK(Rows(world, ballMask) == std::vector<unsigned int>({ balls[0].index, balls[3].index, balls[2].index }));
+	CHECK(world.GetTransform(balls[3])->GetPosition().x == 3.0f);
+	CHECK(world.GetBall(balls[3])->velocity.x == 30.0f);
+	CHECK(world.GetTransform(balls[2])->GetPosition().x == 2.0f);
+	CHECK(world.GetBall(balls[2])->velocity.x == 20.0f);
+	CHECK(world.GetCount() == 4);
+	CHECK(pool.GetCount() == poolBefore + 4);
+
+	// destroying the last row just drops it
+	world.Destroy(balls[2]);
+	CHECK(Rows(world, ballMask) == std::vector<unsigned int>({ balls[0].index, balls[3].index }));
+	CHECK(world.GetBall(balls[3])->velocity.x == 30.0f);
+	CHECK(pool.GetCount() == poolBefore + 3);
+
+	// other archetypes aren't touched
+	CHECK(world.GetEnemy(enemy)->speed == 3.0f);
+
+	// destroyed ids stop resolving, and destroying again does nothing
+	for(EntityId dead : { balls[1], balls[2] }) {
+		CHECK(!world.IsAlive(dead));
+		CHECK(world.GetTransform(dead) == nullptr);
+		CHECK(world.GetRender(dead) == nullptr);
+		CHECK(world.GetBall(dead) == nullptr);
+	}
+	world.Destroy(balls[1]);
+	CHECK(world.GetCount() == 3);
+	CHECK(!world.IsAlive(NoEntity));
+	world.Destroy(NoEntity);
+	CHECK(world.GetCount() == 3);
+
+	// a reused index comes back with a new generation, and the old id still doesn't resolve to it
+	EntityId reused = world.Create(HasTransform | HasPlayer);
+	CHECK(reused.index == balls[2].index || reused.index == balls[1].index);
+	EntityId previous = reused.index == balls[2].index ? balls[2] : balls[1];
+	CHECK(reused.generation == previous.generation + 1);
+	CHECK(world.IsAlive(reused));
+	CHECK(!world.IsAlive(previous));
+	CHECK(world.GetPlayer(previous) == nullptr);
+	CHECK(world.GetPlayer(reused) != nullptr);
+
+	// after another round the generation keeps counting
+	world.Destroy(reused);
+	EntityId again = world.Create(HasTransform);
+	CHECK(again.index == reused.index);
+	CHECK(again.generation == reused.generation + 1);
+	CHECK(!world.IsAlive(reused));
+	CHECK(world.IsAlive(again));
+
+	// emptying the world gives every pool slot back
+	for(EntityId id : { balls[0], balls[3], enemy, again }) {
+		world.Destroy(id);
+	}
+	CHECK(world.GetCount() == 0);
+	CHECK(pool.GetCount() == poolBefore);
+}
+
+int main()
+{
+	TestDestroy();
+	TestBounds();
+	return CheckResult();
+}
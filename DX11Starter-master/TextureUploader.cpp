@@ -0,0 +1,64 @@
+#include "TextureUploader.h"
+
+// --------------------------------------------------------
+// Uploads a decoded image with a full mip chain, generated
+// on the GPU like CreateWICTextureFromFile does when it is
+// given a context.
+// --------------------------------------------------------
+Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> TextureUploader::CreateTexture(Microsoft::WRL::ComPtr<ID3D11Device> device, Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, const ImageData& image)
+{
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv;
+	if(image.pixels.empty()) {
+		return srv;
+	}
+
+	D3D11_TEXTURE2D_DESC desc = {};
+	desc.Width = image.width;
+	desc.Height = image.height;
+	desc.MipLevels = 0; // full chain
+	desc.ArraySize = 1;
+	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	desc.SampleDesc.Count = 1;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+	desc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
+	if(FAILED(device->CreateTexture2D(&desc, nullptr, texture.GetAddressOf()))) {
+		return srv;
+	}
+	context->UpdateSubresource(texture.Get(), 0, nullptr, image.pixels.data(), image.width * 4, 0);
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+	srvDesc.Format = desc.Format;
+	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MipLevels = (UINT)-1;
+	device->CreateShaderResourceView(texture.Get(), &srvDesc, srv.GetAddressOf());
+	context->GenerateMips(srv.Get());
+	return srv;
+}
+
+// single mip, no view, for copying into other resources (cube map faces)
+Microsoft::WRL::ComPtr<ID3D11Texture2D> TextureUploader::CreateTexture2D(Microsoft::WRL::ComPtr<ID3D11Device> device, const ImageData& image)
+{
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
+	if(image.pixels.empty()) {
+		return texture;
+	}
+
+	D3D11_TEXTURE2D_DESC desc = {};
+	desc.Width = image.width;
+	desc.Height = image.height;
+	desc.MipLevels = 1;
+	desc.ArraySize = 1;
+	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	desc.SampleDesc.Count = 1;
+	desc.Usage = D3D11_USAGE_IMMUTABLE;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+	D3D11_SUBRESOURCE_DATA initialData = {};
+	initialData.pSysMem = image.pixels.data();
+	initialData.SysMemPitch = image.width * 4;
+	device->CreateTexture2D(&desc, &initialData, texture.GetAddressOf());
+	return texture;
+}
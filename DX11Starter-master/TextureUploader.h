@@ -0,0 +1,16 @@
+#pragma once
+#include <d3d11.h>
+#include <wrl/client.h>
+#include "AssetLoader.h"
+
+// --------------------------------------------------------
+// The device half of image loading: turns what AssetLoader
+// decoded into textures. Main thread only.
+// --------------------------------------------------------
+class TextureUploader
+{
+public:
+	// with a full mip chain, for sampling
+	static Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> CreateTexture(Microsoft::WRL::ComPtr<ID3D11Device> device, Microsoft::WRL::ComPtr<ID3D11DeviceContext> context, const ImageData& image);
+	static Microsoft::WRL::ComPtr<ID3D11Texture2D> CreateTexture2D(Microsoft::WRL::ComPtr<ID3D11Device> device, const ImageData& image);
+};
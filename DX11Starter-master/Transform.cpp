@@ -4,134 +4,215 @@ using namespace DirectX;
 
 Transform::Transform()
 {
-	position = XMFLOAT3(0.0f, 0.0f, 0.0f);
-	scale = XMFLOAT3(1.0f, 1.0f, 1.0f);
-	pitchYawRoll = XMFLOAT3(0.0f, 0.0f, 0.0f);
+	slot = TransformPool::Default().Allocate();
+	frozen = false;
+}
+
+Transform::Transform(const Transform& other)
+{
+	slot = TransformPool::Default().Allocate();
+	frozen = false;
+	*this = other;
+}
+
+Transform& Transform::operator=(const Transform& other)
+{
+	if(this != &other) {
+		TransformPool& pool = TransformPool::Default();
+		if(slot == TransformPool::NoSlot) {
+			slot = pool.Allocate();
+		}
+		pool.SetPosition(slot, pool.GetPosition(other.slot));
+		pool.SetRotation(slot, pool.GetRotation(other.slot));
+		pool.SetScale(slot, pool.GetScale(other.slot));
+		frozen = other.frozen;
+	}
+	return *this;
+}
+
+Transform::Transform(Transform&& other) noexcept
+{
+	slot = other.slot;
+	frozen = other.frozen;
+	other.slot = TransformPool::NoSlot;
+}
 
-	XMStoreFloat4x4(&worldMatrix, XMMatrixIdentity());
-	XMStoreFloat4x4(&worldInverseTranspose, XMMatrixIdentity());
+Transform& Transform::operator=(Transform&& other) noexcept
+{
+	if(this != &other) {
+		if(slot != TransformPool::NoSlot) {
+			TransformPool::Default().Release(slot);
+		}
+		slot = other.slot;
+		frozen = other.frozen;
+		other.slot = TransformPool::NoSlot;
+	}
+	return *this;
+}
 
-	needsUpdate = false;
+Transform::~Transform()
+{
+	if(slot != TransformPool::NoSlot) {
+		TransformPool::Default().Release(slot);
+	}
 }
 
 void Transform::SetPosition(float x, float y, float z)
 {
-	position = XMFLOAT3(x, y, z);
-	needsUpdate = true;
+	if(frozen) {
+		return;
+	}
+
+	TransformPool::Default().SetPosition(slot, XMFLOAT3(x, y, z));
 }
 
 void Transform::SetScale(float x, float y, float z)
 {
-	scale = XMFLOAT3(x, y, z);
-	needsUpdate = true;
+	if(frozen) {
+		return;
+	}
+
+	TransformPool::Default().SetScale(slot, XMFLOAT3(x, y, z));
 }
 
 void Transform::SetPitchYawRoll(float pitch, float yaw, float roll)
 {
-	pitchYawRoll = XMFLOAT3(pitch, yaw, roll);
-	needsUpdate = true;
+	if(frozen) {
+		return;
+	}
+
+	TransformPool::Default().SetPitchYawRoll(slot, XMFLOAT3(pitch, yaw, roll));
+}
+
+void Transform::SetRotation(DirectX::XMFLOAT4 quaternion)
+{
+	if(frozen) {
+		return;
+	}
+
+	TransformPool::Default().SetRotation(slot, quaternion);
 }
 
 void Transform::MoveAbsolute(float x, float y, float z)
 {
+	if(frozen) {
+		return;
+	}
+
+	XMFLOAT3 position = GetPosition();
 	XMVECTOR shift = XMVectorSet(x, y, z, 0);
 	XMVECTOR mathPos = XMLoadFloat3(&position);
 	XMStoreFloat3(&position, mathPos + shift);
 
-	needsUpdate = true;
+	TransformPool::Default().SetPosition(slot, position);
 }
 
 void Transform::MoveRelative(float x, float y, float z)
 {
+	if(frozen) {
+		return;
+	}
+
+	XMFLOAT3 position = GetPosition();
+	XMFLOAT4 rotation = GetRotation();
 	XMVECTOR mathPos = XMLoadFloat3(&position);
-	XMVECTOR shift = XMVector3Rotate(XMVectorSet(x, y, z, 0), XMQuaternionRotationRollPitchYawFromVector(XMLoadFloat3(&pitchYawRoll)));
+	XMVECTOR shift = XMVector3Rotate(XMVectorSet(x, y, z, 0), XMLoadFloat4(&rotation));
 	XMStoreFloat3(&position, mathPos + shift);
 
-	needsUpdate = true;
+	TransformPool::Default().SetPosition(slot, position);
 }
 
 void Transform::Rotate(float pitch, float yaw, float roll)
 {
-	XMVECTOR spin = XMVectorSet(pitch, yaw, roll, 0);
-	XMVECTOR mathPYR = XMLoadFloat3(&pitchYawRoll);
-	XMStoreFloat3(&pitchYawRoll, spin + mathPYR);
+	if(frozen) {
+		return;
+	}
+
+	// spin first, then the rotation it already had. Renormalized so repeated small turns don't drift
+	XMFLOAT4 rotation = GetRotation();
+	XMVECTOR spin = XMQuaternionRotationRollPitchYaw(pitch, yaw, roll);
+	XMStoreFloat4(&rotation, XMQuaternionNormalize(XMQuaternionMultiply(spin, XMLoadFloat4(&rotation))));
 
-	needsUpdate = true;
+	TransformPool::Default().SetRotation(slot, rotation);
 }
 
 void Transform::Scale(float x, float y, float z)
 {
+	if(frozen) {
+		return;
+	}
+
+	XMFLOAT3 scale = GetScale();
 	XMVECTOR growth = XMVectorSet(x, y, z, 0);
 	XMVECTOR mathScale = XMLoadFloat3(&scale);
 	XMStoreFloat3(&scale, growth * mathScale);
 
-	needsUpdate = true;
+	TransformPool::Default().SetScale(slot, scale);
 }
 
 DirectX::XMFLOAT3 Transform::GetPosition()
 {
-	return position;
+	return TransformPool::Default().GetPosition(slot);
 }
 
 DirectX::XMFLOAT3 Transform::GetPitchYawRoll()
 {
-	return pitchYawRoll;
+	return TransformPool::Default().GetPitchYawRoll(slot);
+}
+
+DirectX::XMFLOAT4 Transform::GetRotation()
+{
+	return TransformPool::Default().GetRotation(slot);
 }
 
 DirectX::XMFLOAT3 Transform::GetScale()
 {
-	return scale;
+	return TransformPool::Default().GetScale(slot);
 }
 
 DirectX::XMFLOAT4X4 Transform::GetWorldMatrix()
 {
-	if(needsUpdate) {
-		UpdateMatrices();
-	}
-
-	return worldMatrix;
+	return TransformPool::Default().GetWorldMatrix(slot);
 }
 
 DirectX::XMFLOAT4X4 Transform::GetWorldInverseTransposeMatrix()
 {
-	if(needsUpdate) {
-		UpdateMatrices();
-	}
-
-	return worldInverseTranspose;
+	return TransformPool::Default().GetWorldInverseTransposeMatrix(slot);
 }
 
+// the axes are cached with the matrices, so these don't rebuild the rotation each call
 DirectX::XMFLOAT3 Transform::GetRight()
 {
-	XMFLOAT3 result;
-	XMStoreFloat3(&result, XMVector3Rotate(XMVectorSet(1, 0, 0, 0), XMQuaternionRotationRollPitchYawFromVector(XMLoadFloat3(&pitchYawRoll))));
-	return result;
+	return TransformPool::Default().GetRight(slot);
 }
 
 DirectX::XMFLOAT3 Transform::GetUp()
 {
-	XMFLOAT3 result;
-	XMStoreFloat3(&result, XMVector3Rotate(XMVectorSet(0, 1, 0, 0), XMQuaternionRotationRollPitchYawFromVector(XMLoadFloat3(&pitchYawRoll))));
-	return result;
+	return TransformPool::Default().GetUp(slot);
 }
 
 DirectX::XMFLOAT3 Transform::GetForward()
 {
-	XMFLOAT3 result;
-	XMStoreFloat3(&result, XMVector3Rotate(XMVectorSet(0, 0, 1, 0), XMQuaternionRotationRollPitchYawFromVector(XMLoadFloat3(&pitchYawRoll))));
-	return result;
+	return TransformPool::Default().GetForward(slot);
 }
 
-void Transform::UpdateMatrices()
+bool Transform::SetParent(Transform* parent, bool keepWorld)
 {
-	XMMATRIX translMat = XMMatrixTranslationFromVector(XMLoadFloat3(&position));
-	XMMATRIX rotMat = XMMatrixRotationRollPitchYawFromVector(XMLoadFloat3(&pitchYawRoll));
-	XMMATRIX scaleMat = XMMatrixScalingFromVector(XMLoadFloat3(&scale));
+	if(frozen) {
+		return false;
+	}
 
-	XMMATRIX world = scaleMat * rotMat * translMat;
+	return TransformPool::Default().SetParent(slot, parent ? parent->slot : TransformPool::NoParent, keepWorld);
+}
 
-	XMStoreFloat4x4(&worldMatrix, world);
-	XMStoreFloat4x4(&worldInverseTranspose, XMMatrixInverse(0, XMMatrixTranspose(world)));
+// bakes the matrices and ignores every change after this, for geometry that never moves
+void Transform::Freeze()
+{
+	TransformPool::Default().GetWorldMatrix(slot);
+	frozen = true;
+}
 
-	needsUpdate = false;
+bool Transform::IsFrozen()
+{
+	return frozen;
 }
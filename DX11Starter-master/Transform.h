@@ -1,22 +1,40 @@
 #pragma once
 #include <DirectXMath.h>
-
+#include "TransformPool.h"
+
+// --------------------------------------------------------
+// A handle to one slot of TransformPool::Default(). Copies
+// get their own slot holding the same position, rotation
+// and scale, but no parent. Moves hand the slot over, so
+// Transforms can sit in arrays that get reordered, parents
+// and children included. With a parent, position,
+// rotation and scale are relative to it and only the world
+// matrices take it into account. Orientation is stored as
+// a quaternion; pitch/yaw/roll are only a way to set it.
+// --------------------------------------------------------
 class Transform
 {
 public:
 	Transform();
+	Transform(const Transform& other);
+	Transform& operator=(const Transform& other);
+	Transform(Transform&& other) noexcept;
+	Transform& operator=(Transform&& other) noexcept;
+	~Transform();
 
 	void SetPosition(float x, float y, float z);
 	void SetScale(float x, float y, float z);
 	void SetPitchYawRoll(float pitch, float yaw, float roll);
+	void SetRotation(DirectX::XMFLOAT4 quaternion);
 
 	void MoveAbsolute(float x, float y, float z);
 	void MoveRelative(float x, float y, float z);
-	void Rotate(float pitch, float yaw, float roll);
+	void Rotate(float pitch, float yaw, float roll); // about the local axes
 	void Scale(float x, float y, float z);
 
 	DirectX::XMFLOAT3 GetPosition();
 	DirectX::XMFLOAT3 GetPitchYawRoll();
+	DirectX::XMFLOAT4 GetRotation();
 	DirectX::XMFLOAT3 GetScale();
 	DirectX::XMFLOAT4X4 GetWorldMatrix();
 	DirectX::XMFLOAT4X4 GetWorldInverseTransposeMatrix();
@@ -24,16 +42,14 @@ public:
 	DirectX::XMFLOAT3 GetUp();
 	DirectX::XMFLOAT3 GetForward();
 
-private:
-	void UpdateMatrices();
-
-	DirectX::XMFLOAT4X4 worldMatrix;
-	DirectX::XMFLOAT4X4 worldInverseTranspose;
+	// null makes this a root again. keepWorld leaves it where it is in the world
+	bool SetParent(Transform* parent, bool keepWorld = true);
 
-	DirectX::XMFLOAT3 position;
-	DirectX::XMFLOAT3 scale;
-	DirectX::XMFLOAT3 pitchYawRoll;
+	void Freeze();
+	bool IsFrozen();
 
-	bool needsUpdate; // whether or not the world matrix needs to be updated
+private:
+	unsigned int slot;
+	bool frozen; // static, setters do nothing
 };
 
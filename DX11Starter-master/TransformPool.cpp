@@ -0,0 +1,457 @@
+#include "TransformPool.h"
+#include <algorithm>
+#include <bitset>
+#include <math.h>
+#include <thread>
+
+using namespace DirectX;
+
+const unsigned int TransformPool::NoParent;
+const unsigned int TransformPool::NoSlot;
+const unsigned int TransformPool::StaleVersion;
+
+TransformPool& TransformPool::Default() {
+	static TransformPool pool;
+	return pool;
+}
+
+TransformPool::TransformPool() {
+	capacity = 0;
+	highWater = 0;
+	orderDirty = false;
+}
+
+unsigned int TransformPool::Allocate() {
+	unsigned int slot;
+	if(!freeSlots.empty()) {
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else {
+		if(highWater == capacity) {
+			Grow();
+		}
+		slot = highWater++;
+	}
+
+	positionX[slot] = positionY[slot] = positionZ[slot] = 0.0f;
+	rotationX[slot] = rotationY[slot] = rotationZ[slot] = 0.0f;
+	rotationW[slot] = 1.0f;
+	right[slot] = XMFLOAT3(1, 0, 0);
+	up[slot] = XMFLOAT3(0, 1, 0);
+	forward[slot] = XMFLOAT3(0, 0, 1);
+	scaleX[slot] = scaleY[slot] = scaleZ[slot] = 1.0f;
+	XMStoreFloat4x4(&local[slot], XMMatrixIdentity());
+	XMStoreFloat4x4(&world[slot], XMMatrixIdentity());
+	XMStoreFloat4x4(&worldInverseTranspose[slot], XMMatrixIdentity());
+	parent[slot] = NoParent;
+	worldVersion[slot] = 0;
+	parentVersionSeen[slot] = StaleVersion;
+	dirty[slot / SlotsPerWord] &= ~(1ull << (slot % SlotsPerWord));
+	return slot;
+}
+
+void TransformPool::Release(unsigned int slot) {
+	// children are left where they are in the world, as roots. Ones parented
+	// since the last sort aren't in order yet
+	if(orderDirty) {
+		SortOrder();
+	}
+	for(unsigned int child : std::vector<unsigned int>(order)) {
+		if(parent[child] == slot) {
+			SetParent(child, NoParent, true);
+		}
+	}
+	if(parent[slot] != NoParent) {
+		parent[slot] = NoParent;
+		orderDirty = true;
+	}
+	dirty[slot / SlotsPerWord] &= ~(1ull << (slot % SlotsPerWord));
+	freeSlots.push_back(slot);
+}
+
+bool TransformPool::SetParent(unsigned int slot, unsigned int parentSlot, bool keepWorld) {
+	for(unsigned int ancestor = parentSlot; ancestor != NoParent; ancestor = parent[ancestor]) {
+		if(ancestor == slot) {
+			return false;
+		}
+	}
+
+	if(keepWorld) {
+		XMFLOAT4X4 worldFloats = GetWorldMatrix(slot);
+		XMMATRIX matrix = XMLoadFloat4x4(&worldFloats);
+		if(parentSlot != NoParent) {
+			XMFLOAT4X4 parentFloats = GetWorldMatrix(parentSlot);
+			matrix = XMMatrixMultiply(matrix, XMMatrixInverse(0, XMLoadFloat4x4(&parentFloats)));
+		}
+		XMFLOAT4X4 localFloats;
+		XMStoreFloat4x4(&localFloats, matrix);
+		XMFLOAT3 position, scale;
+		XMFLOAT4 rotation;
+		Decompose(localFloats, position, rotation, scale);
+		SetPosition(slot, position);
+		SetRotation(slot, rotation);
+		SetScale(slot, scale);
+	}
+
+	parent[slot] = parentSlot;
+	parentVersionSeen[slot] = StaleVersion;
+	MarkDirty(slot);
+	orderDirty = true;
+	return true;
+}
+
+unsigned int TransformPool::GetParent(unsigned int slot) {
+	return parent[slot];
+}
+
+// rare enough to just redo: every slot with a parent, sorted by depth
+void TransformPool::SortOrder() {
+	std::vector<std::pair<unsigned int, unsigned int>> byDepth;
+	for(unsigned int slot = 0; slot < highWater; slot++) {
+		if(parent[slot] == NoParent) {
+			continue;
+		}
+		unsigned int depth = 0;
+		for(unsigned int ancestor = parent[slot]; ancestor != NoParent; ancestor = parent[ancestor]) {
+			depth++;
+		}
+		byDepth.push_back({ depth, slot });
+	}
+	std::sort(byDepth.begin(), byDepth.end());
+
+	order.clear();
+	for(auto& entry : byDepth) {
+		order.push_back(entry.second);
+	}
+	orderDirty = false;
+}
+
+// scale is the length of each row and the rotation is what's left, so this
+// assumes no shear, which holds unless a parent is scaled unevenly under a
+// rotation that isn't a multiple of 90 degrees. A mirrored matrix keeps the
+// flip in scale x, since what's left has to be a proper rotation
+void TransformPool::Decompose(const XMFLOAT4X4& matrix, XMFLOAT3& position, XMFLOAT4& rotation, XMFLOAT3& scale) {
+	position = XMFLOAT3(matrix._41, matrix._42, matrix._43);
+
+	XMMATRIX rows = XMMatrixIdentity();
+	float lengths[3];
+	for(int r = 0; r < 3; r++) {
+		XMVECTOR row = XMVectorSet(matrix.m[r][0], matrix.m[r][1], matrix.m[r][2], 0.0f);
+		lengths[r] = XMVectorGetX(XMVector3Length(row));
+		if(lengths[r] > 0.0f) {
+			rows.r[r] = row / XMVectorReplicate(lengths[r]);
+		}
+	}
+	if(XMVectorGetX(XMVector3Dot(XMVector3Cross(rows.r[0], rows.r[1]), rows.r[2])) < 0.0f) {
+		lengths[0] = -lengths[0];
+		rows.r[0] = XMVectorNegate(rows.r[0]);
+	}
+	scale = XMFLOAT3(lengths[0], lengths[1], lengths[2]);
+	XMStoreFloat4(&rotation, XMQuaternionNormalize(XMQuaternionRotationMatrix(rows)));
+}
+
+// the inverse of XMMatrixRotationRollPitchYaw, where row 2 is (cp * sy, -sp, cp * cy)
+XMFLOAT3 TransformPool::ToPitchYawRoll(const XMFLOAT4& rotation) {
+	XMFLOAT4X4 rows;
+	XMStoreFloat4x4(&rows, XMMatrixRotationQuaternion(XMLoadFloat4(&rotation)));
+
+	float cosPitch = sqrtf(rows._31 * rows._31 + rows._33 * rows._33);
+	float pitch = atan2f(-rows._32, cosPitch);
+	if(cosPitch < 1e-4f) {
+		// straight up or down only fixes roll - yaw, so all of it goes to roll
+		return XMFLOAT3(pitch, 0.0f, atan2f(-rows._32 * rows._13, rows._11));
+	}
+	return XMFLOAT3(pitch, atan2f(rows._31, rows._33), atan2f(rows._12, rows._22));
+}
+
+void TransformPool::Grow() {
+	capacity = capacity == 0 ? SlotsPerWord : capacity * 2;
+	for(std::vector<float>* component : { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &rotationW, &scaleX, &scaleY, &scaleZ }) {
+		component->resize(capacity, 0.0f);
+	}
+	right.resize(capacity);
+	up.resize(capacity);
+	forward.resize(capacity);
+	local.resize(capacity);
+	world.resize(capacity);
+	worldInverseTranspose.resize(capacity);
+	parent.resize(capacity, NoParent);
+	worldVersion.resize(capacity, 0);
+	parentVersionSeen.resize(capacity, StaleVersion);
+	dirty.resize(capacity / SlotsPerWord, 0);
+}
+
+XMFLOAT3 TransformPool::GetPosition(unsigned int slot) {
+	return XMFLOAT3(positionX[slot], positionY[slot], positionZ[slot]);
+}
+
+XMFLOAT4 TransformPool::GetRotation(unsigned int slot) {
+	return XMFLOAT4(rotationX[slot], rotationY[slot], rotationZ[slot], rotationW[slot]);
+}
+
+XMFLOAT3 TransformPool::GetPitchYawRoll(unsigned int slot) {
+	return ToPitchYawRoll(GetRotation(slot));
+}
+
+XMFLOAT3 TransformPool::GetScale(unsigned int slot) {
+	return XMFLOAT3(scaleX[slot], scaleY[slot], scaleZ[slot]);
+}
+
+void TransformPool::SetPosition(unsigned int slot, XMFLOAT3 position) {
+	positionX[slot] = position.x;
+	positionY[slot] = position.y;
+	positionZ[slot] = position.z;
+	MarkDirty(slot);
+}
+
+void TransformPool::SetRotation(unsigned int slot, XMFLOAT4 rotation) {
+	rotationX[slot] = rotation.x;
+	rotationY[slot] = rotation.y;
+	rotationZ[slot] = rotation.z;
+	rotationW[slot] = rotation.w;
+	MarkDirty(slot);
+}
+
+void TransformPool::SetPitchYawRoll(unsigned int slot, XMFLOAT3 pitchYawRoll) {
+	XMFLOAT4 rotation;
+	XMStoreFloat4(&rotation, XMQuaternionRotationRollPitchYaw(pitchYawRoll.x, pitchYawRoll.y, pitchYawRoll.z));
+	SetRotation(slot, rotation);
+}
+
+void TransformPool::SetScale(unsigned int slot, XMFLOAT3 scale) {
+	scaleX[slot] = scale.x;
+	scaleY[slot] = scale.y;
+	scaleZ[slot] = scale.z;
+	MarkDirty(slot);
+}
+
+XMFLOAT3 TransformPool::GetRight(unsigned int slot) {
+	if(IsDirty(slot)) {
+		UpdateSlot(slot);
+	}
+	return right[slot];
+}
+
+XMFLOAT3 TransformPool::GetUp(unsigned int slot) {
+	if(IsDirty(slot)) {
+		UpdateSlot(slot);
+	}
+	return up[slot];
+}
+
+XMFLOAT3 TransformPool::GetForward(unsigned int slot) {
+	if(IsDirty(slot)) {
+		UpdateSlot(slot);
+	}
+	return forward[slot];
+}
+
+XMFLOAT4X4 TransformPool::GetLocalMatrix(unsigned int slot) {
+	if(IsDirty(slot)) {
+		UpdateSlot(slot);
+	}
+	return local[slot];
+}
+
+XMFLOAT4X4 TransformPool::GetWorldMatrix(unsigned int slot) {
+	Resolve(slot);
+	return world[slot];
+}
+
+XMFLOAT4X4 TransformPool::GetWorldInverseTransposeMatrix(unsigned int slot) {
+	Resolve(slot);
+	return worldInverseTranspose[slot];
+}
+
+// brings one slot up to date, along with whatever it hangs off
+void TransformPool::Resolve(unsigned int slot) {
+	if(IsDirty(slot)) {
+		UpdateSlot(slot);
+	}
+	if(parent[slot] != NoParent) {
+		Resolve(parent[slot]);
+		if(parentVersionSeen[slot] != worldVersion[parent[slot]]) {
+			Compose(slot);
+		}
+	}
+}
+
+void TransformPool::Compose(unsigned int slot) {
+	unsigned int parentSlot = parent[slot];
+	XMMATRIX matrix = XMMatrixMultiply(XMLoadFloat4x4(&local[slot]), XMLoadFloat4x4(&world[parentSlot]));
+	XMStoreFloat4x4(&world[slot], matrix);
+
+	// the inverse transpose of a product is the product of the inverse transposes, in the same order
+	XMMATRIX inverseTranspose = XMMatrixMultiply(LocalInverseTranspose(slot), XMLoadFloat4x4(&worldInverseTranspose[parentSlot]));
+	XMStoreFloat4x4(&worldInverseTranspose[slot], inverseTranspose);
+	parentVersionSeen[slot] = worldVersion[parentSlot];
+	if(++worldVersion[slot] == StaleVersion) {
+		worldVersion[slot] = 0;
+	}
+}
+
+// the basis vectors scaled make up the local matrix. Roots take that as their
+// world matrix, children get recomposed later
+void TransformPool::StoreLocal(unsigned int slot, FXMVECTOR rightAxis, FXMVECTOR upAxis, FXMVECTOR forwardAxis) {
+	XMStoreFloat3(&right[slot], rightAxis);
+	XMStoreFloat3(&up[slot], upAxis);
+	XMStoreFloat3(&forward[slot], forwardAxis);
+
+	XMMATRIX matrix(
+		XMVectorScale(rightAxis, scaleX[slot]),
+		XMVectorScale(upAxis, scaleY[slot]),
+		XMVectorScale(forwardAxis, scaleZ[slot]),
+		XMVectorSet(positionX[slot], positionY[slot], positionZ[slot], 1.0f));
+	XMStoreFloat4x4(&local[slot], matrix);
+	if(parent[slot] != NoParent) {
+		parentVersionSeen[slot] = StaleVersion;
+		return;
+	}
+	XMStoreFloat4x4(&world[slot], matrix);
+	XMStoreFloat4x4(&worldInverseTranspose[slot], LocalInverseTranspose(slot));
+	if(++worldVersion[slot] == StaleVersion) {
+		worldVersion[slot] = 0;
+	}
+}
+
+// for scale then rotation the inverse transpose is each rotation row over its scale,
+// so no general inverse is needed. Only the 3x3 part is kept, which is all normals use.
+// With even scale it's just the rotation, negated when the scale is: the length
+// comes out wrong, but every normal gets renormalized in the pixel shader anyway
+XMMATRIX TransformPool::LocalInverseTranspose(unsigned int slot) {
+	XMVECTOR rightAxis = XMLoadFloat3(&right[slot]);
+	XMVECTOR upAxis = XMLoadFloat3(&up[slot]);
+	XMVECTOR forwardAxis = XMLoadFloat3(&forward[slot]);
+	float x = scaleX[slot], y = scaleY[slot], z = scaleZ[slot];
+	if(x != y || y != z) {
+		// a flattened axis has no inverse, so it's left out rather than blowing up
+		rightAxis = XMVectorScale(rightAxis, x != 0.0f ? 1.0f / x : 0.0f);
+		upAxis = XMVectorScale(upAxis, y != 0.0f ? 1.0f / y : 0.0f);
+		forwardAxis = XMVectorScale(forwardAxis, z != 0.0f ? 1.0f / z : 0.0f);
+	}
+	else if(x < 0.0f) {
+		rightAxis = XMVectorNegate(rightAxis);
+		upAxis = XMVectorNegate(upAxis);
+		forwardAxis = XMVectorNegate(forwardAxis);
+	}
+	return XMMATRIX(rightAxis, upAxis, forwardAxis, XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+}
+
+bool TransformPool::IsDirty(unsigned int slot) {
+	return (dirty[slot / SlotsPerWord] >> (slot % SlotsPerWord)) & 1;
+}
+
+void TransformPool::MarkDirty(unsigned int slot) {
+	dirty[slot / SlotsPerWord] |= 1ull << (slot % SlotsPerWord);
+}
+
+unsigned int TransformPool::GetCount() {
+	return highWater - (unsigned int)freeSlots.size();
+}
+
+unsigned int TransformPool::GetDirtyCount() {
+	size_t total = 0;
+	for(uint64_t word : dirty) {
+		total += std::bitset<64>(word).count();
+	}
+	return (unsigned int)total;
+}
+
+void TransformPool::UpdateDirty(unsigned int threadCount) {
+	size_t words = (highWater + SlotsPerWord - 1) / SlotsPerWord;
+	unsigned int usefulThreads = GetDirtyCount() / SlotsPerThread;
+	if(threadCount == 0) {
+		threadCount = std::thread::hardware_concurrency();
+	}
+	if(threadCount > usefulThreads) {
+		threadCount = usefulThreads;
+	}
+	if(threadCount > words) {
+		threadCount = (unsigned int)words;
+	}
+	if(threadCount <= 1) {
+		UpdateWords(0, words);
+	}
+	else {
+		// whole dirty words per thread, so no two threads touch the same bits or matrices
+		std::vector<std::thread> workers;
+		for(unsigned int t = 0; t + 1 < threadCount; t++) {
+			workers.push_back(std::thread(&TransformPool::UpdateWords, this, words * t / threadCount, words * (t + 1) / threadCount));
+		}
+		UpdateWords(words * (threadCount - 1) / threadCount, words);
+		for(std::thread& worker : workers) {
+			worker.join();
+		}
+	}
+
+	// parents come first, so each child sees its parent's final world matrix
+	if(orderDirty) {
+		SortOrder();
+	}
+	for(unsigned int slot : order) {
+		if(parentVersionSeen[slot] != worldVersion[parent[slot]]) {
+			Compose(slot);
+		}
+	}
+}
+
+void TransformPool::UpdateEachDirty() {
+	for(unsigned int slot = 0; slot < highWater; slot++) {
+		if(IsDirty(slot)) {
+			Resolve(slot);
+		}
+	}
+}
+
+void TransformPool::UpdateWords(size_t firstWord, size_t lastWord) {
+	for(size_t w = firstWord; w < lastWord; w++) {
+		uint64_t bits = dirty[w];
+		if(bits == 0) {
+			continue;
+		}
+		for(unsigned int group = 0; group < SlotsPerWord; group += 4) {
+			unsigned int lanes = (unsigned int)(bits >> group) & 0xF;
+			if(lanes) {
+				UpdateGroup((unsigned int)(w * SlotsPerWord) + group, lanes);
+			}
+		}
+		dirty[w] = 0;
+	}
+}
+
+// four slots at once, one per SIMD lane. The rotation rows are written out from
+// the quaternions the way XMMatrixRotationQuaternion does it, so there's no trig
+void TransformPool::UpdateGroup(unsigned int first, unsigned int lanes) {
+	XMVECTOR x = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&rotationX[first]));
+	XMVECTOR y = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&rotationY[first]));
+	XMVECTOR z = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&rotationZ[first]));
+	XMVECTOR w = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&rotationW[first]));
+
+	XMVECTOR one = XMVectorSplatOne();
+	XMVECTOR two = one + one;
+	XMVECTOR xx = x * x * two, yy = y * y * two, zz = z * z * two;
+	XMVECTOR xy = x * y * two, xz = x * z * two, yz = y * z * two;
+	XMVECTOR wx = w * x * two, wy = w * y * two, wz = w * z * two;
+	XMVECTOR zero = XMVectorZero();
+
+	// each matrix holds one basis vector for all four slots, lane by lane.
+	// Transposing turns that into one vector per slot
+	XMMATRIX rights = XMMatrixTranspose(XMMATRIX(one - yy - zz, xy + wz, xz - wy, zero));
+	XMMATRIX ups = XMMatrixTranspose(XMMATRIX(xy - wz, one - xx - zz, yz + wx, zero));
+	XMMATRIX forwards = XMMatrixTranspose(XMMATRIX(xz + wy, yz - wx, one - xx - yy, zero));
+
+	// clean lanes keep what they had, so a slot's matrix only ever changes when it was set
+	for(unsigned int k = 0; k < 4; k++) {
+		if(lanes & (1u << k)) {
+			StoreLocal(first + k, rights.r[k], ups.r[k], forwards.r[k]);
+		}
+	}
+}
+
+void TransformPool::UpdateSlot(unsigned int slot) {
+	XMMATRIX rotation = XMMatrixRotationQuaternion(XMVectorSet(rotationX[slot], rotationY[slot], rotationZ[slot], rotationW[slot]));
+	StoreLocal(slot, rotation.r[0], rotation.r[1], rotation.r[2]);
+
+	dirty[slot / SlotsPerWord] &= ~(1ull << (slot % SlotsPerWord));
+}
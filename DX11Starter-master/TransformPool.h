@@ -0,0 +1,120 @@
+#pragma once
+#include <DirectXMath.h>
+#include <stdint.h>
+#include <vector>
+
+// --------------------------------------------------------
+// Storage behind every Transform. Each component lives in
+// its own contiguous array (orientation as a quaternion,
+// x y z w) and every slot has a dirty bit,
+// so UpdateDirty() can rebuild the matrices of four slots at
+// a time in SIMD lanes, split across threads, in one pass per
+// frame. Reading a matrix that is still dirty rebuilds just
+// that slot, so results never depend on when the pass ran.
+//
+// Slots can have a parent, in which case the components are
+// local to it. Every world matrix carries a version that goes
+// up whenever it's rebuilt, and a child remembers which of its
+// parent's versions it was built from, so only the subtrees
+// under something that changed get recomposed. Children are
+// kept in a list sorted parents first, so recomposing is one
+// linear sweep after the SIMD pass.
+// --------------------------------------------------------
+class TransformPool
+{
+public:
+	// the pool Transform allocates from
+	static TransformPool& Default();
+
+	static const unsigned int NoParent = 0xFFFFFFFF;
+	static const unsigned int NoSlot = 0xFFFFFFFF; // held by a Transform that was moved from
+
+	TransformPool();
+
+	unsigned int Allocate();
+	void Release(unsigned int slot);
+
+	DirectX::XMFLOAT3 GetPosition(unsigned int slot);
+	DirectX::XMFLOAT4 GetRotation(unsigned int slot);
+	DirectX::XMFLOAT3 GetPitchYawRoll(unsigned int slot); // worked out from the quaternion
+	DirectX::XMFLOAT3 GetScale(unsigned int slot);
+	void SetPosition(unsigned int slot, DirectX::XMFLOAT3 position);
+	void SetRotation(unsigned int slot, DirectX::XMFLOAT4 rotation);
+	void SetPitchYawRoll(unsigned int slot, DirectX::XMFLOAT3 pitchYawRoll);
+	void SetScale(unsigned int slot, DirectX::XMFLOAT3 scale);
+
+	// unit axes of the rotation, relative to the parent. Rebuilt along with the matrices
+	DirectX::XMFLOAT3 GetRight(unsigned int slot);
+	DirectX::XMFLOAT3 GetUp(unsigned int slot);
+	DirectX::XMFLOAT3 GetForward(unsigned int slot);
+
+	// keepWorld works out the local components that leave the world matrix where it
+	// was. It can't be exact under an unevenly scaled parent that's rotated, since
+	// that needs shear. Returns false, changing nothing, if it would make a cycle
+	bool SetParent(unsigned int slot, unsigned int parentSlot, bool keepWorld = true);
+	unsigned int GetParent(unsigned int slot);
+
+	DirectX::XMFLOAT4X4 GetLocalMatrix(unsigned int slot);
+	DirectX::XMFLOAT4X4 GetWorldMatrix(unsigned int slot);
+	// for transforming normals: the 3x3 part is only right up to length, so normalize what it gives
+	DirectX::XMFLOAT4X4 GetWorldInverseTransposeMatrix(unsigned int slot);
+	bool IsDirty(unsigned int slot);
+
+	// threadCount 0 uses every core the dirty slots can keep busy
+	void UpdateDirty(unsigned int threadCount = 0);
+
+	// the old one matrix at a time path, kept for comparison
+	void UpdateEachDirty();
+
+	unsigned int GetCount(); // slots in use
+	unsigned int GetDirtyCount();
+
+	// fewer dirty slots than this per thread aren't worth a thread
+	static const unsigned int SlotsPerThread = 4096;
+
+private:
+	// SIMD groups of 4 and whole dirty words, so capacity is kept a multiple of 64
+	static const unsigned int SlotsPerWord = 64;
+
+	// never a real version, so a child holding it always gets recomposed
+	static const unsigned int StaleVersion = 0xFFFFFFFF;
+
+	std::vector<float> positionX;
+	std::vector<float> positionY;
+	std::vector<float> positionZ;
+	std::vector<float> rotationX;
+	std::vector<float> rotationY;
+	std::vector<float> rotationZ;
+	std::vector<float> rotationW;
+	std::vector<float> scaleX;
+	std::vector<float> scaleY;
+	std::vector<float> scaleZ;
+	std::vector<DirectX::XMFLOAT3> right;
+	std::vector<DirectX::XMFLOAT3> up;
+	std::vector<DirectX::XMFLOAT3> forward;
+	std::vector<DirectX::XMFLOAT4X4> local;
+	std::vector<DirectX::XMFLOAT4X4> world;
+	std::vector<DirectX::XMFLOAT4X4> worldInverseTranspose;
+	std::vector<unsigned int> parent;
+	std::vector<unsigned int> worldVersion;
+	std::vector<unsigned int> parentVersionSeen;
+	std::vector<unsigned int> order; // every slot with a parent, parents before children
+	bool orderDirty;
+	std::vector<uint64_t> dirty;
+	std::vector<unsigned int> freeSlots;
+	unsigned int capacity;
+	unsigned int highWater; // slots ever handed out, free or not
+
+	void Grow();
+	void MarkDirty(unsigned int slot);
+	void UpdateSlot(unsigned int slot);
+	void UpdateGroup(unsigned int first, unsigned int lanes);
+	void UpdateWords(size_t firstWord, size_t lastWord);
+	void StoreLocal(unsigned int slot, DirectX::FXMVECTOR rightAxis, DirectX::FXMVECTOR upAxis, DirectX::FXMVECTOR forwardAxis);
+	DirectX::XMMATRIX LocalInverseTranspose(unsigned int slot);
+	void Resolve(unsigned int slot);
+	void Compose(unsigned int slot);
+	void SortOrder();
+	static void Decompose(const DirectX::XMFLOAT4X4& matrix, DirectX::XMFLOAT3& position, DirectX::XMFLOAT4& rotation, DirectX::XMFLOAT3& scale);
+	static DirectX::XMFLOAT3 ToPitchYawRoll(const DirectX::XMFLOAT4& rotation);
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <DirectXMath.h>
+#include <stdint.h>
 
 struct Vertex
 {
@@ -8,4 +9,21 @@ struct Vertex
 	DirectX::XMFLOAT3 Normal;
 	DirectX::XMFLOAT3 Tangent;
 	DirectX::XMFLOAT2 UV;
-};
\ No newline at end of file
+};
+
+// --------------------------------------------------------
+// 20 byte compressed vertex, see VertexQuantizer:
+//   Position - R16G16B16A16_UNORM, relative to the mesh bounds (w unused)
+//   Normal   - R16G16_SNORM, octahedral
+//   Tangent  - R16G16_SNORM, octahedral
+//   UV       - R16G16_FLOAT
+// --------------------------------------------------------
+struct QuantizedVertex
+{
+	uint16_t Position[4];
+	int16_t Normal[2];
+	int16_t Tangent[2];
+	uint16_t UV[2];
+};
+
+enum VertexFormat { VertexFormatFull, VertexFormatQuantized };
\ No newline at end of file
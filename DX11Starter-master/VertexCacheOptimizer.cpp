@@ -0,0 +1,238 @@
+#include "VertexCacheOptimizer.h"
+#include <math.h>
+#include <string.h>
+
+CacheStats VertexCacheOptimizer::Optimize(Vertex* vertices, int numVertices, unsigned int* indices, int numIndices)
+{
+	CacheStats stats = {};
+	stats.acmrBefore = ComputeACMR(indices, numIndices, numVertices);
+	stats.atvrBefore = ComputeATVR(indices, numIndices, numVertices);
+
+	ReorderTriangles(indices, numIndices, numVertices);
+	ReorderVertices(vertices, numVertices, indices, numIndices);
+
+	stats.acmrAfter = ComputeACMR(indices, numIndices, numVertices);
+	stats.atvrAfter = ComputeATVR(indices, numIndices, numVertices);
+	return stats;
+}
+
+// --------------------------------------------------------
+// Forsyth, "Linear-Speed Vertex Cache Optimisation".
+// Every vertex gets a score from its position in a modelled
+// LRU cache and how many unemitted triangles still use it;
+// the triangle with the best summed score is emitted next.
+// Only triangles touching the cache are rescored each step.
+// --------------------------------------------------------
+void VertexCacheOptimizer::ReorderTriangles(unsigned int* indices, int numIndices, int numVertices)
+{
+	int numTriangles = numIndices / 3;
+	if(numTriangles == 0) {
+		return;
+	}
+
+	// vertex -> triangle adjacency, packed into one array
+	std::vector<int> remaining(numVertices, 0);
+	for(int i = 0; i < numTriangles * 3; i++) {
+		remaining[indices[i]]++;
+	}
+	std::vector<int> adjacencyStart(numVertices + 1, 0);
+	for(int v = 0; v < numVertices; v++) {
+		adjacencyStart[v + 1] = adjacencyStart[v] + remaining[v];
+	}
+	std::vector<int> adjacency(numTriangles * 3);
+	std::vector<int> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+	for(int t = 0; t < numTriangles; t++) {
+		for(int corner = 0; corner < 3; corner++) {
+			adjacency[fill[indices[t * 3 + corner]]++] = t;
+		}
+	}
+
+	std::vector<int> cachePosition(numVertices, -1);
+	std::vector<float> vertexScore(numVertices);
+	for(int v = 0; v < numVertices; v++) {
+		vertexScore[v] = VertexScore(-1, remaining[v]);
+	}
+
+	std::vector<float> triangleScore(numTriangles);
+	std::vector<bool> emitted(numTriangles, false);
+	for(int t = 0; t < numTriangles; t++) {
+		triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+	}
+
+	// cache gets three slots of headroom for the incoming triangle
+	int cache[ModelledCacheSize + 3];
+	int cacheCount = 0;
+	std::vector<unsigned int> output(numTriangles * 3);
+	int scanCursor = 0;
+
+	int best = 0;
+	for(int t = 1; t < numTriangles; t++) {
+		if(triangleScore[t] > triangleScore[best]) {
+			best = t;
+		}
+	}
+
+	for(int outTriangle = 0; outTriangle < numTriangles; outTriangle++) {
+		// nothing useful in the cache, fall back to the next unemitted triangle
+		if(best < 0) {
+			while(emitted[scanCursor]) {
+				scanCursor++;
+			}
+			best = scanCursor;
+		}
+
+		const unsigned int* triangle = &indices[best * 3];
+		memcpy(&output[outTriangle * 3], triangle, sizeof(unsigned int) * 3);
+		emitted[best] = true;
+
+		// drop the emitted triangle from its vertices' adjacency
+		for(int corner = 0; corner < 3; corner++) {
+			unsigned int v = triangle[corner];
+			int begin = adjacencyStart[v];
+			int end = begin + remaining[v];
+			for(int i = begin; i < end; i++) {
+				if(adjacency[i] == best) {
+					adjacency[i] = adjacency[end - 1];
+					break;
+				}
+			}
+			remaining[v]--;
+		}
+
+		// move the three vertices to the front, pushing the rest back
+		int newCache[ModelledCacheSize + 3];
+		int newCount = 0;
+		for(int corner = 0; corner < 3; corner++) {
+			newCache[newCount++] = triangle[corner];
+		}
+		for(int i = 0; i < cacheCount; i++) {
+			int v = cache[i];
+			if(v != (int)triangle[0] && v != (int)triangle[1] && v != (int)triangle[2]) {
+				newCache[newCount++] = v;
+			}
+		}
+
+		// rescore everything that was or is in the cache
+		for(int i = 0; i < newCount; i++) {
+			int v = newCache[i];
+			cachePosition[v] = i < ModelledCacheSize ? i : -1;
+			vertexScore[v] = VertexScore(cachePosition[v], remaining[v]);
+		}
+		cacheCount = newCount < ModelledCacheSize ? newCount : ModelledCacheSize;
+		memcpy(cache, newCache, sizeof(int) * cacheCount);
+
+		best = -1;
+		float bestScore = -1.0f;
+		for(int i = 0; i < newCount; i++) {
+			int v = newCache[i];
+			int begin = adjacencyStart[v];
+			int end = begin + remaining[v];
+			for(int a = begin; a < end; a++) {
+				int t = adjacency[a];
+				float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+				triangleScore[t] = score;
+				if(score > bestScore) {
+					bestScore = score;
+					best = t;
+				}
+			}
+		}
+	}
+
+	memcpy(indices, output.data(), sizeof(unsigned int) * numTriangles * 3);
+}
+
+// --------------------------------------------------------
+// Renumbers vertices in the order the index buffer first
+// touches them. Vertices no triangle uses end up at the back.
+// --------------------------------------------------------
+void VertexCacheOptimizer::ReorderVertices(Vertex* vertices, int numVertices, unsigned int* indices, int numIndices)
+{
+	const unsigned int unassigned = 0xFFFFFFFF;
+	std::vector<unsigned int> remap(numVertices, unassigned);
+	unsigned int next = 0;
+	for(int i = 0; i < numIndices; i++) {
+		if(remap[indices[i]] == unassigned) {
+			remap[indices[i]] = next++;
+		}
+		indices[i] = remap[indices[i]];
+	}
+	for(int v = 0; v < numVertices; v++) {
+		if(remap[v] == unassigned) {
+			remap[v] = next++;
+		}
+	}
+
+	std::vector<Vertex> reordered(numVertices);
+	for(int v = 0; v < numVertices; v++) {
+		reordered[remap[v]] = vertices[v];
+	}
+	memcpy(vertices, reordered.data(), sizeof(Vertex) * numVertices);
+}
+
+float VertexCacheOptimizer::ComputeACMR(const unsigned int* indices, int numIndices, int numVertices, int cacheSize)
+{
+	int numTriangles = numIndices / 3;
+	if(numTriangles == 0) {
+		return 0.0f;
+	}
+	return (float)CountMisses(indices, numIndices, numVertices, cacheSize) / numTriangles;
+}
+
+float VertexCacheOptimizer::ComputeATVR(const unsigned int* indices, int numIndices, int numVertices, int cacheSize)
+{
+	std::vector<bool> referenced(numVertices, false);
+	int uniqueVertices = 0;
+	for(int i = 0; i < numIndices; i++) {
+		if(!referenced[indices[i]]) {
+			referenced[indices[i]] = true;
+			uniqueVertices++;
+		}
+	}
+	if(uniqueVertices == 0) {
+		return 0.0f;
+	}
+	return (float)CountMisses(indices, numIndices, numVertices, cacheSize) / uniqueVertices;
+}
+
+// simulates a FIFO cache: a vertex is a hit if fewer than cacheSize misses happened since it was loaded
+int VertexCacheOptimizer::CountMisses(const unsigned int* indices, int numIndices, int numVertices, int cacheSize)
+{
+	std::vector<int> loadedAt(numVertices, -cacheSize - 1);
+	int misses = 0;
+	for(int i = 0; i < numIndices; i++) {
+		if(misses - loadedAt[indices[i]] > cacheSize) {
+			loadedAt[indices[i]] = misses;
+			misses++;
+		}
+	}
+	return misses;
+}
+
+float VertexCacheOptimizer::VertexScore(int cachePosition, int remainingTriangles)
+{
+	const float cacheDecayPower = 1.5f;
+	const float lastTriangleScore = 0.75f;
+	const float valenceBoostScale = 2.0f;
+	const float valenceBoostPower = 0.5f;
+
+	if(remainingTriangles == 0) {
+		return -1.0f;
+	}
+
+	float score = 0.0f;
+	if(cachePosition >= 0) {
+		if(cachePosition < 3) {
+			// the last triangle's vertices get a fixed score so it is not simply repeated
+			score = lastTriangleScore;
+		} else {
+			float scaler = 1.0f / (ModelledCacheSize - 3);
+			score = powf(1.0f - (cachePosition - 3) * scaler, cacheDecayPower);
+		}
+	}
+
+	// favour vertices with few triangles left so they get finished off
+	int valence = remainingTriangles < MaxValence ? remainingTriangles : MaxValence;
+	score += valenceBoostScale * powf((float)valence, -valenceBoostPower);
+	return score;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+#include "Vertex.h"
+
+struct CacheStats
+{
+	float acmrBefore;
+	float acmrAfter;
+	float atvrBefore;
+	float atvrAfter;
+};
+
+// reorders triangles for the post-transform vertex cache (Forsyth's
+// linear-speed algorithm), then renumbers vertices in first-use order
+// so vertex fetches walk the buffer front to back
+class VertexCacheOptimizer
+{
+public:
+	// size of the FIFO used to measure ACMR / ATVR
+	static const int SimulatedCacheSize = 16;
+
+	static CacheStats Optimize(Vertex* vertices, int numVertices, unsigned int* indices, int numIndices);
+	static void ReorderTriangles(unsigned int* indices, int numIndices, int numVertices);
+	static void ReorderVertices(Vertex* vertices, int numVertices, unsigned int* indices, int numIndices);
+
+	// average cache miss ratio: transformed vertices per triangle
+	static float ComputeACMR(const unsigned int* indices, int numIndices, int numVertices, int cacheSize = SimulatedCacheSize);
+	// average transform to vertex ratio: transformed vertices per referenced vertex
+	static float ComputeATVR(const unsigned int* indices, int numIndices, int numVertices, int cacheSize = SimulatedCacheSize);
+
+private:
+	// size of the LRU cache the scoring models
+	static const int ModelledCacheSize = 32;
+	static const int MaxValence = 64;
+
+	static int CountMisses(const unsigned int* indices, int numIndices, int numVertices, int cacheSize);
+	static float VertexScore(int cachePosition, int remainingTriangles);
+};
@@ -0,0 +1,114 @@
+#include "VertexQuantizer.h"
+#include <DirectXPackedVector.h>
+#include <math.h>
+
+using namespace DirectX;
+
+#ifdef _WIN32
+const D3D11_INPUT_ELEMENT_DESC VertexQuantizer::InputElements[4] =
+{
+	{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+	{ "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 8, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+	{ "TANGENT", 0, DXGI_FORMAT_R16G16_SNORM, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+	{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 16, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+};
+#endif
+
+void VertexQuantizer::Quantize(const Vertex* vertices, int numVertices, const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax, std::vector<QuantizedVertex>& output)
+{
+	output.resize(numVertices);
+	for(int i = 0; i < numVertices; i++) {
+		output[i] = Encode(vertices[i], boundsMin, boundsMax);
+	}
+}
+
+QuantizedVertex VertexQuantizer::Encode(const Vertex& vertex, const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax)
+{
+	QuantizedVertex result;
+	result.Position[0] = EncodeUnorm(vertex.Position.x, boundsMin.x, boundsMax.x - boundsMin.x);
+	result.Position[1] = EncodeUnorm(vertex.Position.y, boundsMin.y, boundsMax.y - boundsMin.y);
+	result.Position[2] = EncodeUnorm(vertex.Position.z, boundsMin.z, boundsMax.z - boundsMin.z);
+	result.Position[3] = 0;
+	EncodeOctahedral(vertex.Normal, result.Normal);
+	EncodeOctahedral(vertex.Tangent, result.Tangent);
+	result.UV[0] = PackedVector::XMConvertFloatToHalf(vertex.UV.x);
+	result.UV[1] = PackedVector::XMConvertFloatToHalf(vertex.UV.y);
+	return result;
+}
+
+Vertex VertexQuantizer::Decode(const QuantizedVertex& vertex, const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax)
+{
+	Vertex result;
+	result.Position.x = DecodeUnorm(vertex.Position[0], boundsMin.x, boundsMax.x - boundsMin.x);
+	result.Position.y = DecodeUnorm(vertex.Position[1], boundsMin.y, boundsMax.y - boundsMin.y);
+	result.Position.z = DecodeUnorm(vertex.Position[2], boundsMin.z, boundsMax.z - boundsMin.z);
+	result.Normal = DecodeOctahedral(vertex.Normal);
+	result.Tangent = DecodeOctahedral(vertex.Tangent);
+	result.UV.x = PackedVector::XMConvertHalfToFloat(vertex.UV[0]);
+	result.UV.y = PackedVector::XMConvertHalfToFloat(vertex.UV[1]);
+	return result;
+}
+
+// --------------------------------------------------------
+// Projects the direction onto the octahedron |x|+|y|+|z| = 1
+// and unfolds the lower half over the diagonals, so any unit
+// vector fits in two numbers. A zero vector encodes as +Z.
+// --------------------------------------------------------
+void VertexQuantizer::EncodeOctahedral(const XMFLOAT3& direction, int16_t encoded[2])
+{
+	float sum = fabsf(direction.x) + fabsf(direction.y) + fabsf(direction.z);
+	if(sum == 0.0f) {
+		encoded[0] = encoded[1] = 0;
+		return;
+	}
+
+	float x = direction.x / sum;
+	float y = direction.y / sum;
+	if(direction.z < 0.0f) {
+		float foldedX = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		float foldedY = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+		x = foldedX;
+		y = foldedY;
+	}
+	encoded[0] = EncodeSnorm(x);
+	encoded[1] = EncodeSnorm(y);
+}
+
+XMFLOAT3 VertexQuantizer::DecodeOctahedral(const int16_t encoded[2])
+{
+	float x = DecodeSnorm(encoded[0]);
+	float y = DecodeSnorm(encoded[1]);
+	float z = 1.0f - fabsf(x) - fabsf(y);
+	float fold = fmaxf(-z, 0.0f);
+	x += x >= 0.0f ? -fold : fold;
+	y += y >= 0.0f ? -fold : fold;
+
+	float length = sqrtf(x * x + y * y + z * z);
+	return XMFLOAT3(x / length, y / length, z / length);
+}
+
+uint16_t VertexQuantizer::EncodeUnorm(float value, float minimum, float extent)
+{
+	if(extent <= 0.0f) {
+		return 0;
+	}
+	float normalized = fminf(fmaxf((value - minimum) / extent, 0.0f), 1.0f);
+	return (uint16_t)(normalized * 65535.0f + 0.5f);
+}
+
+float VertexQuantizer::DecodeUnorm(uint16_t value, float minimum, float extent)
+{
+	return minimum + (value / 65535.0f) * extent;
+}
+
+int16_t VertexQuantizer::EncodeSnorm(float value)
+{
+	float clamped = fminf(fmaxf(value, -1.0f), 1.0f);
+	return (int16_t)roundf(clamped * 32767.0f);
+}
+
+// same rule as the SNORM input format: -32768 and -32767 both mean -1
+float VertexQuantizer::DecodeSnorm(int16_t value)
+{
+	return fmaxf(value / 32767.0f, -1.0f);
+}
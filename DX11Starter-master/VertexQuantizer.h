@@ -0,0 +1,38 @@
+#pragma once
+#ifdef _WIN32
+#include <d3d11.h>
+#endif
+#include <vector>
+#include "Vertex.h"
+
+// --------------------------------------------------------
+// Encodes Vertex into QuantizedVertex and back.
+// Worst case error per component:
+//   Position - half a step, (boundsMax - boundsMin) / 131070,
+//              plus float rounding when decoding
+//   Normal / Tangent - under 0.005 degrees after renormalizing
+//   UV - half precision, 2^-11 relative (2^-25 absolute below 2^-14)
+// QuantizedVertexShader.hlsl mirrors Decode().
+// --------------------------------------------------------
+class VertexQuantizer
+{
+public:
+	static void Quantize(const Vertex* vertices, int numVertices, const DirectX::XMFLOAT3& boundsMin, const DirectX::XMFLOAT3& boundsMax, std::vector<QuantizedVertex>& output);
+
+	static QuantizedVertex Encode(const Vertex& vertex, const DirectX::XMFLOAT3& boundsMin, const DirectX::XMFLOAT3& boundsMax);
+	static Vertex Decode(const QuantizedVertex& vertex, const DirectX::XMFLOAT3& boundsMin, const DirectX::XMFLOAT3& boundsMax);
+
+	static void EncodeOctahedral(const DirectX::XMFLOAT3& direction, int16_t encoded[2]);
+	static DirectX::XMFLOAT3 DecodeOctahedral(const int16_t encoded[2]);
+
+#ifdef _WIN32
+	// matches the QuantizedVertex layout, for CreateInputLayout
+	static const D3D11_INPUT_ELEMENT_DESC InputElements[4];
+#endif
+
+private:
+	static uint16_t EncodeUnorm(float value, float minimum, float extent);
+	static float DecodeUnorm(uint16_t value, float minimum, float extent);
+	static int16_t EncodeSnorm(float value);
+	static float DecodeSnorm(int16_t value);
+};
@@ -1,10 +1,10 @@
 #include "ShaderStructs.hlsli"
 
-cbuffer ExternalData : register(b0) { 
+// set for every entity, worldViewProjection is multiplied out on the CPU
+cbuffer PerObject : register(b1) { 
+	matrix worldViewProjection;
 	matrix world;
 	matrix worldInverseTranspose;
-	matrix view;
-	matrix projection;
 }
 
 struct VertexShaderInput
@@ -20,9 +20,7 @@ VertexToPixel main( VertexShaderInput input )
 	// Set up output struct
 	VertexToPixel output;
 
-	// Multiply the three matrices together first  
-	matrix wvp = mul(projection, mul(view, world));  
-	output.screenPosition = mul(wvp, float4(input.localPosition, 1.0f));
+	output.screenPosition = mul(worldViewProjection, float4(input.localPosition, 1.0f));
 	output.normal = mul((float3x3)worldInverseTranspose, input.normal);
 
 	output.tangent = mul((float3x3)worldInverseTranspose, input.tangent);
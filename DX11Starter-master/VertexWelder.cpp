@@ -0,0 +1,71 @@
+#include "VertexWelder.h"
+#include <string.h>
+#include <stdint.h>
+
+static const unsigned int emptySlot = 0xFFFFFFFF;
+
+// --------------------------------------------------------
+// Open addressing hash table from vertex contents to the
+// index of the first matching vertex. Vertices are compacted
+// in place, so the first occurrence order is kept.
+// --------------------------------------------------------
+WeldStats VertexWelder::Weld(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+	WeldStats stats = {};
+	stats.originalVertexCount = vertices.size();
+
+	size_t capacity = 16;
+	while(capacity < vertices.size() * 2) {
+		capacity *= 2;
+	}
+	std::vector<unsigned int> table(capacity, emptySlot);
+	std::vector<unsigned int> remap(vertices.size());
+
+	unsigned int uniqueCount = 0;
+	for(size_t i = 0; i < vertices.size(); i++) {
+		size_t slot = Hash(vertices[i]) & (capacity - 1);
+		while(table[slot] != emptySlot && !Matches(vertices[table[slot]], vertices[i])) {
+			slot = (slot + 1) & (capacity - 1);
+		}
+
+		if(table[slot] == emptySlot) {
+			vertices[uniqueCount] = vertices[i];
+			table[slot] = uniqueCount;
+			uniqueCount++;
+		}
+		remap[i] = table[slot];
+	}
+
+	for(size_t i = 0; i < indices.size(); i++) {
+		indices[i] = remap[indices[i]];
+	}
+	vertices.resize(uniqueCount);
+	vertices.shrink_to_fit();
+
+	stats.weldedVertexCount = uniqueCount;
+	stats.bytesSaved = (stats.originalVertexCount - stats.weldedVertexCount) * sizeof(Vertex);
+	return stats;
+}
+
+// hashes the raw bits of everything but the tangent, which is derived later
+unsigned int VertexWelder::Hash(const Vertex& vertex)
+{
+	uint32_t bits[8];
+	memcpy(&bits[0], &vertex.Position, sizeof(float) * 3);
+	memcpy(&bits[3], &vertex.Normal, sizeof(float) * 3);
+	memcpy(&bits[6], &vertex.UV, sizeof(float) * 2);
+
+	uint32_t hash = 2166136261u;
+	for(int i = 0; i < 8; i++) {
+		hash = (hash ^ bits[i]) * 16777619u;
+		hash ^= hash >> 15;
+	}
+	return hash;
+}
+
+bool VertexWelder::Matches(const Vertex& a, const Vertex& b)
+{
+	return memcmp(&a.Position, &b.Position, sizeof(a.Position)) == 0
+		&& memcmp(&a.Normal, &b.Normal, sizeof(a.Normal)) == 0
+		&& memcmp(&a.UV, &b.UV, sizeof(a.UV)) == 0;
+}
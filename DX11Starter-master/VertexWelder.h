@@ -0,0 +1,23 @@
+#pragma once
+#include <vector>
+#include <stddef.h>
+#include "Vertex.h"
+
+struct WeldStats
+{
+	size_t originalVertexCount;
+	size_t weldedVertexCount;
+	size_t bytesSaved;
+};
+
+// merges vertices whose position, uv and normal are bit-identical
+// and rewrites the index list to share them
+class VertexWelder
+{
+public:
+	static WeldStats Weld(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+private:
+	static unsigned int Hash(const Vertex& vertex);
+	static bool Matches(const Vertex& a, const Vertex& b);
+};
@@ -0,0 +1,193 @@
+#include "World.h"
+
+using namespace DirectX;
+
+EntityId World::Create(ComponentMask mask) {
+	unsigned int index;
+	if(freeIndices.empty()) {
+		index = (unsigned int)locations.size();
+		locations.push_back({ 0, 0, 0, false });
+	}
+	else {
+		index = freeIndices.back();
+		freeIndices.pop_back();
+	}
+
+	unsigned int archetypeIndex = FindArchetype(mask);
+	Archetype& archetype = archetypes[archetypeIndex];
+	Location& location = locations[index];
+	location.archetype = archetypeIndex;
+	location.row = (unsigned int)archetype.GetCount();
+	location.alive = true;
+	EntityId id = { index, location.generation };
+
+	archetype.entities.push_back(id);
+	if(mask & HasTransform) {
+		archetype.transforms.emplace_back();
+	}
+	if(mask & HasRender) {
+		archetype.renders.emplace_back();
+	}
+	if(mask & HasBall) {
+		archetype.balls.emplace_back();
+	}
+	if(mask & HasPlayer) {
+		archetype.players.emplace_back();
+	}
+	if(mask & HasEnemy) {
+		archetype.enemies.emplace_back();
+	}
+	count++;
+	return id;
+}
+
+// the last row takes the destroyed one's place in every array
+void World::Destroy(EntityId id) {
+	Location* location = Find(id);
+	if(!location) {
+		return;
+	}
+
+	Archetype& archetype = archetypes[location->archetype];
+	unsigned int row = location->row;
+	unsigned int last = (unsigned int)archetype.GetCount() - 1;
+	if(row != last) {
+		archetype.entities[row] = archetype.entities[last];
+		locations[archetype.entities[row].index].row = row;
+	}
+	archetype.entities.pop_back();
+
+	if(archetype.mask & HasTransform) {
+		// a move, so the last entity keeps its pool slot and any children
+		archetype.transforms[row] = std::move(archetype.transforms[last]);
+		archetype.transforms.pop_back();
+	}
+	if(archetype.mask & HasRender) {
+		archetype.renders[row] = archetype.renders[last];
+		archetype.renders.pop_back();
+	}
+	if(archetype.mask & HasBall) {
+		archetype.balls[row] = archetype.balls[last];
+		archetype.balls.pop_back();
+	}
+	if(archetype.mask & HasPlayer) {
+		archetype.players[row] = archetype.players[last];
+		archetype.players.pop_back();
+	}
+	if(archetype.mask & HasEnemy) {
+		archetype.enemies[row] = archetype.enemies[last];
+		archetype.enemies.pop_back();
+	}
+
+	location->alive = false;
+	location->generation++;
+	freeIndices.push_back(id.index);
+	count--;
+}
+
+bool World::IsAlive(EntityId id) {
+	return Find(id) != nullptr;
+}
+
+Transform* World::GetTransform(EntityId id) {
+	Location* location = Find(id);
+	if(!location || !(archetypes[location->archetype].mask & HasTransform)) {
+		return nullptr;
+	}
+	return &archetypes[location->archetype].transforms[location->row];
+}
+
+RenderComponent* World::GetRender(EntityId id) {
+	Location* location = Find(id);
+	if(!location || !(archetypes[location->archetype].mask & HasRender)) {
+		return nullptr;
+	}
+	return &archetypes[location->archetype].renders[location->row];
+}
+
+BallComponent* World::GetBall(EntityId id) {
+	Location* location = Find(id);
+	if(!location || !(archetypes[location->archetype].mask & HasBall)) {
+		return nullptr;
+	}
+	return &archetypes[location->archetype].balls[location->row];
+}
+
+PlayerComponent* World::GetPlayer(EntityId id) {
+	Location* location = Find(id);
+	if(!location || !(archetypes[location->archetype].mask & HasPlayer)) {
+		return nullptr;
+	}
+	return &archetypes[location->archetype].players[location->row];
+}
+
+EnemyComponent* World::GetEnemy(EntityId id) {
+	Location* location = Find(id);
+	if(!location || !(archetypes[location->archetype].mask & HasEnemy)) {
+		return nullptr;
+	}
+	return &archetypes[location->archetype].enemies[location->row];
+}
+
+bool World::GetWorldBoundingBox(EntityId id, BoundingBox& box) {
+	Transform* transform = GetTransform(id);
+	RenderComponent* render = GetRender(id);
+	if(!transform || !render || !render->mesh) {
+		return false;
+	}
+	box = GetWorldBoundingBox(*render, transform->GetWorldMatrix());
+	return true;
+}
+
+bool World::GetWorldBoundingSphere(EntityId id, BoundingSphere& sphere) {
+	Transform* transform = GetTransform(id);
+	RenderComponent* render = GetRender(id);
+	if(!transform || !render || !render->mesh) {
+		return false;
+	}
+	sphere = GetWorldBoundingSphere(*render, transform->GetWorldMatrix());
+	return true;
+}
+
+BoundingBox World::GetWorldBoundingBox(const RenderComponent& render, const XMFLOAT4X4& world) {
+	BoundingBox box;
+	GetMeshBoundingBox(*render.mesh).Transform(box, XMLoadFloat4x4(&world));
+	return box;
+}
+
+BoundingSphere World::GetWorldBoundingSphere(const RenderComponent& render, const XMFLOAT4X4& world) {
+	BoundingSphere sphere;
+	GetMeshBoundingSphere(*render.mesh).Transform(sphere, XMLoadFloat4x4(&world));
+	return sphere;
+}
+
+std::vector<Archetype>& World::GetArchetypes() {
+	return archetypes;
+}
+
+size_t World::GetCount() {
+	return count;
+}
+
+// there are only ever a handful of archetypes, so a linear search is fine
+unsigned int World::FindArchetype(ComponentMask mask) {
+	for(unsigned int i = 0; i < archetypes.size(); i++) {
+		if(archetypes[i].mask == mask) {
+			return i;
+		}
+	}
+	archetypes.emplace_back();
+	archetypes.back().mask = mask;
+	return (unsigned int)archetypes.size() - 1;
+}
+
+World::Location* World::Find(EntityId id) {
+	if(id.index >= locations.size()) {
+		return nullptr;
+	}
+	Location& location = locations[id.index];
+	if(!location.alive || location.generation != id.generation) {
+		return nullptr;
+	}
+	return &location;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <vector>
+#include "Components.h"
+#include "Transform.h"
+
+// --------------------------------------------------------
+// Every entity with one set of components. Each component
+// type is its own dense array, row i of each belongs to
+// entities[i], and arrays for components not in the mask
+// stay empty. Systems loop over the arrays directly.
+// --------------------------------------------------------
+struct Archetype
+{
+	ComponentMask mask;
+	std::vector<EntityId> entities;
+	std::vector<Transform> transforms;
+	std::vector<RenderComponent> renders;
+	std::vector<BallComponent> balls;
+	std::vector<PlayerComponent> players;
+	std::vector<EnemyComponent> enemies;
+
+	bool Has(ComponentMask components) { return (mask & components) == components; }
+	size_t GetCount() { return entities.size(); }
+};
+
+// --------------------------------------------------------
+// Archetype based entity store. Creating an entity appends
+// a row to its archetype and destroying one moves the last
+// row into the hole, so the arrays never have gaps. That
+// also means component pointers are only good until the
+// next Create() or Destroy().
+// --------------------------------------------------------
+class World
+{
+public:
+	// components start out default constructed
+	EntityId Create(ComponentMask mask);
+	void Destroy(EntityId id);
+	bool IsAlive(EntityId id);
+
+	// null when the entity is gone or doesn't have that component
+	Transform* GetTransform(EntityId id);
+	RenderComponent* GetRender(EntityId id);
+	BallComponent* GetBall(EntityId id);
+	PlayerComponent* GetPlayer(EntityId id);
+	EnemyComponent* GetEnemy(EntityId id);
+
+	// the mesh's bounds in world space, false without a transform or a mesh. The box
+	// holds the transformed mesh box, so it's loose under rotation, and the sphere
+	// grows by the largest axis scale
+	bool GetWorldBoundingBox(EntityId id, DirectX::BoundingBox& box);
+	bool GetWorldBoundingSphere(EntityId id, DirectX::BoundingSphere& sphere);
+
+	// the same for a row a system already has, along with its world matrix
+	static DirectX::BoundingBox GetWorldBoundingBox(const RenderComponent& render, const DirectX::XMFLOAT4X4& world);
+	static DirectX::BoundingSphere GetWorldBoundingSphere(const RenderComponent& render, const DirectX::XMFLOAT4X4& world);
+
+	// systems check Has() on each and skip the ones that don't match
+	std::vector<Archetype>& GetArchetypes();
+	size_t GetCount(); // live entities
+
+private:
+	struct Location
+	{
+		unsigned int archetype;
+		unsigned int row;
+		unsigned int generation;
+		bool alive;
+	};
+
+	std::vector<Archetype> archetypes;
+	std::vector<Location> locations; // by entity index
+	std::vector<unsigned int> freeIndices;
+	size_t count = 0;
+
+	unsigned int FindArchetype(ComponentMask mask);
+	Location* Find(EntityId id);
+};